@@ -27,8 +27,9 @@
 #include <nanokernel.h>
 #include <nano_private.h>
 
-#ifdef CONFIG_PRINTK
 #include <misc/printk.h>
+
+#ifdef CONFIG_PRINTK
 #define PR_EXC(...) printk(__VA_ARGS__)
 #else
 #define PR_EXC(...)
@@ -83,6 +84,7 @@ void _Fault(void)
 {
 	uint32_t ecr = _arc_v2_aux_reg_read(_ARC_V2_ECR);
 
+	printk_panic();
 	FAULT_DUMP(&_default_esf, ecr);
 
 	_SysFatalErrorHandler(_NANO_ERR_HW_EXCEPTION, &_default_esf);
@@ -173,6 +173,7 @@ void _new_thread(char *pStackMem, unsigned stackSize,
 	tcs->preempReg.sp = (uint32_t)pInitCtx - __tCalleeSaved_SIZEOF;
 
 	_nano_timeout_tcs_init(tcs);
+	_thread_runtime_init(tcs);
 
 	/* initial values in all other registers/TCS entries are irrelevant */
 
@@ -27,8 +27,9 @@
 #include <nanokernel.h>
 #include <nano_private.h>
 
-#ifdef CONFIG_PRINTK
 #include <misc/printk.h>
+
+#ifdef CONFIG_PRINTK
 #define PR_EXC(...) printk(__VA_ARGS__)
 #else
 #define PR_EXC(...)
@@ -78,6 +79,8 @@ const NANO_ESF _default_esf = {
 FUNC_NORETURN void _NanoFatalErrorHandler(unsigned int reason,
 					  const NANO_ESF *pEsf)
 {
+	printk_panic();
+
 	switch (reason) {
 	case _NANO_ERR_INVALID_TASK_EXIT:
 		PR_EXC("***** Invalid Exit Software Error! *****\n");
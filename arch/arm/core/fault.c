@@ -27,8 +27,9 @@
 #include <nanokernel.h>
 #include <nano_private.h>
 
-#ifdef CONFIG_PRINTK
 #include <misc/printk.h>
+
+#ifdef CONFIG_PRINTK
 #define PR_EXC(...) printk(__VA_ARGS__)
 #else
 #define PR_EXC(...)
@@ -341,6 +342,7 @@ void _Fault(const NANO_ESF *esf)
 {
 	int fault = _ScbActiveVectorGet();
 
+	printk_panic();
 	FAULT_DUMP(esf, fault);
 
 	_SysFatalErrorHandler(_NANO_ERR_HW_EXCEPTION, esf);
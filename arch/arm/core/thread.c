@@ -154,6 +154,7 @@ void _new_thread(char *pStackMem, unsigned stackSize,
 	tcs->basepri = 0;
 
 	_nano_timeout_tcs_init(tcs);
+	_thread_runtime_init(tcs);
 
 	/* initial values in all other registers/TCS entries are irrelevant */
 
@@ -21,9 +21,9 @@
  *
  * @brief Power save idle routine
  *
- * This function will be called by the nanokernel idle loop or possibly within
- * an implementation of _sys_power_save_idle in the microkernel when the
- * '_sys_power_save_flag' variable is non-zero.
+ * This function will be called by the nanokernel idle loop or by the
+ * microkernel idle task, possibly within an implementation of
+ * _sys_power_save_idle.
  *
  * @return N/A
  */
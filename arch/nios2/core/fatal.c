@@ -59,6 +59,8 @@ const NANO_ESF _default_esf = {
 FUNC_NORETURN void _NanoFatalErrorHandler(unsigned int reason,
 					  const NANO_ESF *esf)
 {
+	printk_panic();
+
 #ifdef CONFIG_PRINTK
 	switch (reason) {
 	case _NANO_ERR_CPU_EXCEPTION:
@@ -166,6 +168,8 @@ static char *cause_str(uint32_t cause_code)
 
 FUNC_NORETURN void _Fault(const NANO_ESF *esf)
 {
+	printk_panic();
+
 #ifdef CONFIG_PRINTK
 	/* Unfortunately, completely unavailable on Nios II/e cores */
 #ifdef ALT_CPU_HAS_EXTRA_EXCEPTION_INFO
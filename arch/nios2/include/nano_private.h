@@ -121,6 +121,7 @@ struct tcs {
 #endif
 #ifdef CONFIG_NANO_TIMEOUTS
 	struct _nano_timeout nano_timeout;
+	struct tcs *wait_q_prev; /* predecessor on a nanokernel wait queue */
 #endif
 #if defined(CONFIG_THREAD_MONITOR)
 	struct __thread_entry *entry; /* thread entry and parameters description */
@@ -50,10 +50,10 @@ extern void _power_save_idle(void);
  *
  * @brief Power save idle routine for IA-32
  *
- * This function will be called by the nanokernel idle loop or possibly within
- * an implementation of _sys_power_save_idle in the microkernel when the
- * '_sys_power_save_flag' variable is non-zero.  The IA-32 'hlt' instruction
- * will be issued causing a low-power consumption sleep mode.
+ * This function will be called by the nanokernel idle loop or by the
+ * microkernel idle task, possibly within an implementation of
+ * _sys_power_save_idle.  The IA-32 'hlt' instruction will be issued causing a
+ * low-power consumption sleep mode.
  *
  * @return N/A
  */
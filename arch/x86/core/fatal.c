@@ -72,6 +72,8 @@ FUNC_NORETURN void _NanoFatalErrorHandler(unsigned int reason,
 {
 	_debug_fatal_hook(pEsf);
 
+	printk_panic();
+
 #ifdef CONFIG_PRINTK
 
 	/* Display diagnostic information about the error */
@@ -131,6 +133,7 @@ FUNC_NORETURN void _NanoFatalErrorHandler(unsigned int reason,
 static FUNC_NORETURN void generic_exc_handle(unsigned int vector,
 					     const NANO_ESF *pEsf)
 {
+	printk_panic();
 	printk("***** CPU exception %d\n", vector);
 	if ((1 << vector) & _EXC_ERROR_CODE_FAULTS) {
 		printk("***** Exception code: 0x%x\n", pEsf->errorCode);
@@ -206,6 +206,7 @@ static void _new_thread_internal(char *pStackMem, unsigned stackSize,
 #endif /* CONFIG_THREAD_MONITOR */
 
 	_nano_timeout_tcs_init(tcs);
+	_thread_runtime_init(tcs);
 }
 
 #if defined(CONFIG_GDB_INFO) || defined(CONFIG_DEBUG_INFO) \
@@ -652,6 +652,10 @@ struct tcs {
 	struct __thread_entry *entry; /* thread entry and parameters description */
 	struct tcs *next_thread; /* next item in list of ALL fiber+tasks */
 #endif
+#ifdef CONFIG_THREAD_RUNTIME_STATS
+	uint64_t runtime;      /* cycles spent running */
+	uint64_t runtime_snap; /* 'runtime' at the previous snapshot */
+#endif
 #ifdef CONFIG_GDB_INFO
 	void *esfPtr; /* pointer to exception stack frame saved by */
 		      /* outermost exception wrapper */
@@ -672,6 +676,7 @@ struct tcs {
 
 #ifdef CONFIG_NANO_TIMEOUTS
 	struct _nano_timeout nano_timeout;
+	struct tcs *wait_q_prev; /* predecessor on a nanokernel wait queue */
 #endif
 
 #ifdef CONFIG_ERRNO
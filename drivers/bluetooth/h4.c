@@ -205,6 +205,8 @@ static void bt_uart_isr(struct device *unused)
 
 static int h4_send(struct net_buf *buf)
 {
+	struct net_buf *frag;
+
 	BT_DBG("buf %p type %u len %u", buf, bt_buf_get_type(buf), buf->len);
 
 	switch (bt_buf_get_type(buf)) {
@@ -218,8 +220,10 @@ static int h4_send(struct net_buf *buf)
 		return -EINVAL;
 	}
 
-	while (buf->len) {
-		uart_poll_out(h4_dev, net_buf_pull_u8(buf));
+	for (frag = buf; frag; frag = frag->frags) {
+		while (frag->len) {
+			uart_poll_out(h4_dev, net_buf_pull_u8(frag));
+		}
 	}
 
 	net_buf_unref(buf);
@@ -97,24 +97,47 @@ release_desc:
 	eth_write(base_addr, REG_ADDR_RX_POLL_DEMAND, 1);
 }
 
+/* Release the buffer of the previous frame once the device is done */
+static void eth_tx_release(struct eth_runtime *context)
+{
+	struct net_buf *buf;
+	int key;
+
+	key = irq_lock();
+	buf = context->tx_pending;
+	context->tx_pending = NULL;
+	irq_unlock(key);
+
+	if (buf) {
+		ip_buf_unref(buf);
+	}
+}
+
 /* @brief Transmit the current Ethernet frame.
  *
  *        This procedure will block indefinitely until the Ethernet device is
- *        ready to accept a new outgoing frame.  It then copies the current
- *        Ethernet frame from the global uip_buf buffer to the device DMA
- *        buffer and signals to the device that a new frame is available to be
- *        transmitted.
+ *        ready to accept a new outgoing frame.  The device then reads the
+ *        frame headers and the payload fragment, if any, directly from the
+ *        network buffer, which is held until the transmission is complete.
+ *        Frames with more than one fragment are copied to the device DMA
+ *        buffer first.
  */
 static int eth_tx(struct device *port, struct net_buf *buf)
 {
 	struct eth_runtime *context = port->driver_data;
 	struct eth_config *config = port->config->config_info;
 	uint32_t base_addr = config->base_addr;
+	uint16_t len = uip_len(buf) + ip_buf_frags_len(buf);
+	struct net_buf *pending = NULL;
+	struct net_buf *frag;
+	int key;
 
 	/* Wait until the TX descriptor is no longer owned by the device. */
 	while (context->tx_desc.own == 1) {
 	}
 
+	eth_tx_release(context);
+
 #ifdef CONFIG_ETHERNET_DEBUG
 	/* Check whether an error occurred transmitting the previous frame. */
 	if (context->tx_desc.err_summary) {
@@ -124,17 +147,42 @@ static int eth_tx(struct device *port, struct net_buf *buf)
 #endif
 
 	/* Transmit the next frame. */
-	if (uip_len(buf) > UIP_BUFSIZE) {
-		SYS_LOG_ERR("Frame too large to TX: %u\n", uip_len(buf));
+	if (len > UIP_BUFSIZE) {
+		SYS_LOG_ERR("Frame too large to TX: %u\n", len);
 
 		return -1;
 	}
 
-	memcpy((void *)context->tx_buf, uip_buf(buf), uip_len(buf));
-
-	context->tx_desc.tx_buf1_sz = uip_len(buf);
+	if (!buf->frags || !buf->frags->frags) {
+		context->tx_desc.buf1_ptr = uip_buf(buf);
+		context->tx_desc.tx_buf1_sz = uip_len(buf);
+		context->tx_desc.buf2_ptr = buf->frags ? buf->frags->data : NULL;
+		context->tx_desc.tx_buf2_sz = buf->frags ? buf->frags->len : 0;
+
+		pending = ip_buf_ref(buf);
+	} else {
+		memcpy((void *)context->tx_buf, uip_buf(buf), uip_len(buf));
+		len = uip_len(buf);
+
+		for (frag = buf->frags; frag; frag = frag->frags) {
+			memcpy((void *)&context->tx_buf[len], frag->data,
+			       frag->len);
+			len += frag->len;
+		}
+
+		context->tx_desc.buf1_ptr = (uint8_t *)context->tx_buf;
+		context->tx_desc.tx_buf1_sz = len;
+		context->tx_desc.buf2_ptr = NULL;
+		context->tx_desc.tx_buf2_sz = 0;
+	}
 
+	/* The completion interrupt must not release the buffer before the
+	 * device owns the descriptor.
+	 */
+	key = irq_lock();
+	context->tx_pending = pending;
 	context->tx_desc.own = 1;
+	irq_unlock(key);
 
 	/* Request that the device check for an available TX descriptor, since
 	 * ownership of the descriptor was just transferred to the device.
@@ -146,6 +194,7 @@ static int eth_tx(struct device *port, struct net_buf *buf)
 
 void eth_dw_isr(struct device *port)
 {
+	struct eth_runtime *context = port->driver_data;
 	struct eth_config *config = port->config->config_info;
 	uint32_t base_addr = config->base_addr;
 	uint32_t int_status;
@@ -157,15 +206,22 @@ void eth_dw_isr(struct device *port)
 	 * by the shared IRQ driver. So check here if the interrupt
 	 * is coming from the GPIO controller (or somewhere else).
 	 */
-	if ((int_status & STATUS_RX_INT) == 0) {
+	if ((int_status & (STATUS_RX_INT | STATUS_TX_INT)) == 0) {
 		return;
 	}
 #endif
 
-	eth_rx(port);
+	if ((int_status & STATUS_TX_INT) && context->tx_desc.own == 0) {
+		eth_tx_release(context);
+	}
+
+	if (int_status & STATUS_RX_INT) {
+		eth_rx(port);
+	}
 
 	/* Acknowledge the interrupt. */
-	eth_write(base_addr, REG_ADDR_STATUS, STATUS_NORMAL_INT | STATUS_RX_INT);
+	eth_write(base_addr, REG_ADDR_STATUS, STATUS_NORMAL_INT |
+		  (int_status & (STATUS_RX_INT | STATUS_TX_INT)));
 }
 
 #ifdef CONFIG_PCI
@@ -224,7 +280,6 @@ static int eth_initialize(struct device *port)
 	context->tx_desc.tdes0 = 0;
 	context->tx_desc.tdes1 = 0;
 
-	context->tx_desc.buf1_ptr = (uint8_t *)context->tx_buf;
 	context->tx_desc.tx_end_of_ring = 1;
 	context->tx_desc.first_seg_in_frm = 1;
 	context->tx_desc.last_seg_in_frm = 1;
@@ -258,7 +313,9 @@ static int eth_initialize(struct device *port)
 	eth_write(base_addr, REG_ADDR_INT_ENABLE,
 		  INT_ENABLE_NORMAL |
 		  /* Enable receive interrupts */
-		  INT_ENABLE_RX);
+		  INT_ENABLE_RX |
+		  /* Enable transmit interrupts, to release the sent buffers */
+		  INT_ENABLE_TX);
 
 	/* Mask all the MMC interrupts */
 	eth_write(base_addr, REG_MMC_RX_INTR_MASK, MMC_DEFAULT_MASK);
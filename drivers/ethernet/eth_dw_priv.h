@@ -24,6 +24,8 @@
 
 #include <misc/util.h>
 
+#include <net/buf.h>
+
 #include "contiki/ip/uip.h"
 
 #ifdef __cplusplus
@@ -104,8 +106,8 @@ struct eth_tx_desc {
 	};
 	/* Pointer to frame data buffer */
 	uint8_t *buf1_ptr;
-	/* Unused, since this driver initializes only a single descriptor for each
-	 * direction.
+	/* Second part of the frame, used for the payload fragment of a
+	 * network buffer.
 	 */
 	uint8_t *buf2_ptr;
 };
@@ -162,8 +164,10 @@ struct eth_rx_desc {
 struct eth_runtime {
 	/* Transmit descriptor */
 	volatile struct eth_tx_desc tx_desc;
-	/* Transmit DMA packet buffer */
+	/* Transmit DMA packet buffer, used for frames in several fragments */
 	volatile uint8_t tx_buf[UIP_BUFSIZE];
+	/* Network buffer read by the device, released when it is done */
+	struct net_buf *tx_pending;
 	/* Receive descriptor */
 	volatile struct eth_rx_desc rx_desc;
 	/* Receive DMA packet buffer */
@@ -179,6 +183,7 @@ struct eth_runtime {
 
 #define STATUS_NORMAL_INT              BIT(16)
 #define STATUS_RX_INT                  BIT(6)
+#define STATUS_TX_INT                  BIT(0)
 
 #define OP_MODE_25_RX_STORE_N_FORWARD  BIT(25)
 #define OP_MODE_21_TX_STORE_N_FORWARD  BIT(21)
@@ -187,6 +192,7 @@ struct eth_runtime {
 
 #define INT_ENABLE_NORMAL              BIT(16)
 #define INT_ENABLE_RX                  BIT(6)
+#define INT_ENABLE_TX                  BIT(0)
 
 #define REG_ADDR_MAC_CONF              0x0000
 #define REG_ADDR_MACADDR_HI            0x0040
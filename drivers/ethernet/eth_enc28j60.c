@@ -460,7 +460,9 @@ static int eth_enc28j60_init(struct device *dev)
 	return 0;
 }
 
-static int eth_enc28j60_tx(struct device *dev, uint8_t *buf, uint16_t len)
+/* Send the frame in buf followed by the data of the frags fragments */
+static int eth_enc28j60_tx_frags(struct device *dev, uint8_t *buf,
+				 uint16_t len, struct net_buf *frags)
 {
 	struct eth_enc28j60_runtime *context = dev->driver_data;
 	uint16_t tx_bufaddr = ENC28J60_TXSTART;
@@ -495,6 +497,11 @@ static int eth_enc28j60_tx(struct device *dev, uint8_t *buf, uint16_t len)
 	eth_enc28j60_write_mem(dev, &per_packet_control, 1);
 	eth_enc28j60_write_mem(dev, buf, len);
 
+	for (; frags; frags = frags->frags) {
+		eth_enc28j60_write_mem(dev, frags->data, frags->len);
+		len += frags->len;
+	}
+
 	tx_bufaddr_end = tx_bufaddr + len;
 	eth_enc28j60_write_reg(dev, ENC28J60_REG_ETXNDL,
 			       tx_bufaddr_end & 0xFF);
@@ -522,9 +529,15 @@ static int eth_enc28j60_tx(struct device *dev, uint8_t *buf, uint16_t len)
 	return 0;
 }
 
+static int eth_enc28j60_tx(struct device *dev, uint8_t *buf, uint16_t len)
+{
+	return eth_enc28j60_tx_frags(dev, buf, len, NULL);
+}
+
 static int eth_enc28j60_rx(struct device *dev)
 {
 	struct eth_enc28j60_runtime *context = dev->driver_data;
+	sys_slist_t frames;
 	uint8_t econ1_bkup;
 	uint8_t counter;
 
@@ -536,6 +549,8 @@ static int eth_enc28j60_rx(struct device *dev)
 	/* Backup ECON1 register in case the rx interrupted a tx process */
 	eth_enc28j60_read_reg(dev, ENC28J60_REG_ECON1, &econ1_bkup);
 
+	sys_slist_init(&frames);
+
 	do {
 		uint8_t *reception_buf = NULL;
 		uint16_t frm_len = 0;
@@ -578,8 +593,8 @@ static int eth_enc28j60_rx(struct device *dev)
 		eth_enc28j60_read_mem(dev, reception_buf, frm_len);
 		uip_len(buf) = frm_len;
 
-		/* Register the buffer frame with the IP stack */
-		net_driver_ethernet_recv(buf);
+		/* Queue the frame, all of them go to the IP stack at once */
+		sys_slist_append(&frames, (sys_snode_t *)buf);
 done:
 		/* Free buffer memory and decrement rx counter */
 		eth_enc28j60_set_bank(dev, ENC28J60_REG_ERXRDPTL);
@@ -599,6 +614,9 @@ done:
 		eth_enc28j60_read_reg(dev, ENC28J60_REG_EPKTCNT, &counter);
 	} while (counter);
 
+	/* Register the received frames with the IP stack */
+	net_driver_ethernet_recv_list(&frames);
+
 	/* Recover ECON1 register */
 	eth_enc28j60_write_reg(dev, ENC28J60_REG_ECON1, econ1_bkup);
 
@@ -662,8 +680,8 @@ DEVICE_AND_API_INIT(eth_enc28j60_0, CONFIG_ETH_ENC28J60_0_NAME,
 
 static int eth_net_tx(struct net_buf *buf)
 {
-	return eth_enc28j60_tx(DEVICE_GET(eth_enc28j60_0),
-			       uip_buf(buf), uip_len(buf));
+	return eth_enc28j60_tx_frags(DEVICE_GET(eth_enc28j60_0),
+				     uip_buf(buf), uip_len(buf), buf->frags);
 }
 
 #endif /* CONFIG_ETH_ENC28J60_0 */
@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) 2016 Intel Corporation.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file
+ * @brief RAM backed flash simulator
+ *
+ * Behaves like a NOR flash part: erasing sets a whole erase unit to 0xff
+ * and writing can only clear bits. Writing a 1 over a programmed 0 is
+ * reported as an error, so that code relying on the simulator cannot
+ * silently skip an erase that real hardware would need.
+ */
+
+#include <errno.h>
+#include <string.h>
+#include <nanokernel.h>
+#include <device.h>
+#include <init.h>
+#include <flash.h>
+
+#define SIM_SIZE CONFIG_FLASH_SIMULATOR_SIZE
+#define SIM_ERASE_UNIT CONFIG_FLASH_SIMULATOR_ERASE_UNIT
+
+static uint8_t sim_mem[SIM_SIZE];
+static bool sim_write_protected = true;
+
+static bool sim_range_valid(off_t offset, size_t len)
+{
+	return (offset >= 0) && (len <= SIM_SIZE) &&
+	       (offset <= (off_t)(SIM_SIZE - len));
+}
+
+static int flash_sim_read(struct device *dev, off_t offset, void *data,
+			  size_t len)
+{
+	if (!sim_range_valid(offset, len)) {
+		return -EINVAL;
+	}
+
+	memcpy(data, &sim_mem[offset], len);
+
+	return 0;
+}
+
+static int flash_sim_write(struct device *dev, off_t offset,
+			   const void *data, size_t len)
+{
+	const uint8_t *src = data;
+
+	if (!sim_range_valid(offset, len)) {
+		return -EINVAL;
+	}
+
+	if (sim_write_protected) {
+		return -EACCES;
+	}
+
+	for (size_t i = 0; i < len; i++) {
+		if ((sim_mem[offset + i] & src[i]) != src[i]) {
+			return -EIO;
+		}
+	}
+
+	memcpy(&sim_mem[offset], data, len);
+
+	return 0;
+}
+
+static int flash_sim_erase(struct device *dev, off_t offset, size_t size)
+{
+	if (!sim_range_valid(offset, size)) {
+		return -EINVAL;
+	}
+
+	if ((offset & (SIM_ERASE_UNIT - 1)) || (size & (SIM_ERASE_UNIT - 1))) {
+		return -EINVAL;
+	}
+
+	if (sim_write_protected) {
+		return -EACCES;
+	}
+
+	memset(&sim_mem[offset], 0xff, size);
+
+	return 0;
+}
+
+static int flash_sim_write_protection(struct device *dev, bool enable)
+{
+	sim_write_protected = enable;
+
+	return 0;
+}
+
+static struct flash_driver_api flash_sim_api = {
+	.read = flash_sim_read,
+	.write = flash_sim_write,
+	.erase = flash_sim_erase,
+	.write_protection = flash_sim_write_protection,
+};
+
+static int flash_sim_init(struct device *dev)
+{
+	/* the part comes up fully erased */
+	memset(sim_mem, 0xff, sizeof(sim_mem));
+
+	dev->driver_api = &flash_sim_api;
+
+	return 0;
+}
+
+DEVICE_INIT(flash_simulator, CONFIG_FLASH_SIMULATOR_DEV_NAME, flash_sim_init,
+	    NULL, NULL, SECONDARY, CONFIG_KERNEL_INIT_PRIORITY_DEVICE);
@@ -186,6 +186,7 @@ void _timer_int_handler(void *unused)
 #endif
 
 	update_accumulated_count();
+	_sys_thread_runtime_clock_sync();
 	_sys_clock_tick_announce();
 }
 
@@ -318,6 +318,9 @@ void _TIMER_INT_HANDLER(void *unused)
 	_sys_clock_tick_announce();
 #endif /* CONFIG_TICKLESS_IDLE */
 
+	/* sys_cycle_get_32() is only correct once the count is accumulated */
+	_sys_thread_runtime_isr_enter();
+
 	numIdleTicks = _NanoIdleValGet(); /* get # of idle ticks requested */
 
 	if (numIdleTicks) {
@@ -338,6 +341,8 @@ void _TIMER_INT_HANDLER(void *unused)
 	/* accumulate total counter value */
 	clock_accumulated_count += sys_clock_hw_cycles_per_tick;
 
+	_sys_thread_runtime_isr_enter();
+
 	/*
 	 * one more tick has occurred -- don't need to do anything special since
 	 * timer is already configured to interrupt on the following tick
@@ -346,6 +351,8 @@ void _TIMER_INT_HANDLER(void *unused)
 
 #endif /* CONFIG_SYS_POWER_MANAGEMENT */
 
+	_sys_thread_runtime_isr_exit();
+
 	extern void _ExcExit(void);
 	_ExcExit();
 }
@@ -330,6 +330,7 @@ void _timer_int_handler(void *unused /* parameter is not used */
 #endif
 	/* track the accumulated cycle count */
 	accumulated_cycle_count += cycles_per_tick * _sys_idle_elapsed_ticks;
+	_sys_thread_runtime_clock_sync();
 
 	/*
 	 * If we transistion from 0 elapsed ticks to 1 we need to announce the
@@ -343,6 +344,7 @@ void _timer_int_handler(void *unused /* parameter is not used */
 #else
 	/* track the accumulated cycle count */
 	accumulated_cycle_count += cycles_per_tick;
+	_sys_thread_runtime_clock_sync();
 
 	_sys_clock_tick_announce();
 #endif /*CONFIG_TICKLESS_IDLE*/
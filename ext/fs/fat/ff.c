@@ -3443,6 +3443,45 @@ FRESULT f_open (
 /* Read File                                                             */
 /*-----------------------------------------------------------------------*/
 
+/*-----------------------------------------------------------------------*/
+/* Get number of sectors readable with a single disk_read                */
+/*-----------------------------------------------------------------------*/
+/* Extends a read that starts in the current cluster over the following
+/  clusters as long as they are contiguous on the volume, and leaves the
+/  last cluster touched by the read in fp->clust. */
+
+static
+UINT read_span (	/* Number of sectors to read */
+	FIL* fp,		/* Pointer to the file object */
+	UINT cc,		/* Number of whole sectors requested */
+	UINT ncc		/* Number of sectors left in the current cluster */
+)
+{
+	FATFS *fs = fp->obj.fs;
+	DWORD clst = fp->clust, ncl;
+
+
+	while (ncc < cc) {
+#if _USE_FASTSEEK
+		if (fp->cltbl) {
+			ncl = clmt_clust(fp, fp->fptr + (FSIZE_t)ncc * SS(fs));	/* Get cluster# from the CLMT */
+		} else
+#endif
+		{
+			ncl = get_fat(&fp->obj, clst);	/* Follow cluster chain on the FAT */
+		}
+		if (ncl != clst + 1) break;		/* Not contiguous (or error, left to the caller) */
+		clst = ncl;
+		ncc += fs->csize;
+	}
+	fp->clust = clst;
+
+	return (ncc < cc) ? ncc : cc;
+}
+
+
+
+
 FRESULT f_read (
 	FIL* fp, 	/* Pointer to the file object */
 	void* buff,	/* Pointer to data buffer */
@@ -3491,8 +3530,8 @@ FRESULT f_read (
 			sect += csect;
 			cc = btr / SS(fs);					/* When remaining bytes >= sector size, */
 			if (cc) {							/* Read maximum contiguous sectors directly */
-				if (csect + cc > fs->csize) {	/* Clip at cluster boundary */
-					cc = fs->csize - csect;
+				if (csect + cc > fs->csize) {	/* Extend over following clusters while they are contiguous */
+					cc = read_span(fp, cc, fs->csize - csect);
 				}
 				if (disk_read(fs->drv, rbuff, sect, cc) != RES_OK) {
 					ABORT(fs, FR_DISK_ERR);
@@ -62,7 +62,11 @@
 /* This option switches f_mkfs() function. (0:Disable or 1:Enable) */
 
 
+#ifdef CONFIG_FS_FAT_FASTSEEK
+#define	_USE_FASTSEEK	1
+#else
 #define	_USE_FASTSEEK	0
+#endif
 /* This option switches fast seek function. (0:Disable or 1:Enable) */
 
 
@@ -221,7 +225,11 @@
 / System Configurations
 /---------------------------------------------------------------------------*/
 
+#ifdef CONFIG_FS_FAT_FILE_BUFFER
+#define	_FS_TINY	0
+#else
 #define	_FS_TINY	1
+#endif
 /* This option switches tiny buffer configuration. (0:Normal or 1:Tiny)
 /  At the tiny configuration, size of the file object (FIL) is reduced _MAX_SS bytes.
 /  Instead of private sector buffer eliminated from the file object, common sector
@@ -260,9 +268,15 @@
 /      lock control is independent of re-entrancy. */
 
 
+#ifdef CONFIG_FS_FAT_REENTRANT
+#define _FS_REENTRANT	1
+#define _FS_TIMEOUT		CONFIG_FS_FAT_LOCK_TIMEOUT
+#define	_SYNC_t			struct nano_sem *
+#else
 #define _FS_REENTRANT	0
 #define _FS_TIMEOUT		1000
 #define	_SYNC_t			HANDLE
+#endif
 /* The option _FS_REENTRANT switches the re-entrancy (thread safe) of the FatFs
 /  module itself. Note that regardless of this option, file access to different
 /  volume is always re-entrant and volume control functions, f_mount(), f_mkfs()
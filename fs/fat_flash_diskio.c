@@ -18,10 +18,16 @@
 #include <stdint.h>
 #include <misc/__assert.h>
 #include <misc/util.h>
+#include <stdbool.h>
 #include <diskio.h>
 #include <ff.h>
 #include <device.h>
 #include <flash.h>
+#include <fs/fat_diskio.h>
+
+#ifndef CONFIG_FS_FAT_FLASH_CACHE_BLOCKS
+#define CONFIG_FS_FAT_FLASH_CACHE_BLOCKS 0
+#endif
 
 static struct device *flash_dev;
 
@@ -29,6 +35,27 @@ static struct device *flash_dev;
 static uint8_t read_copy_buf[CONFIG_FS_BLOCK_SIZE];
 static uint8_t *fs_buff = read_copy_buf;
 
+static struct fat_disk_stats disk_stats;
+
+#if CONFIG_FS_FAT_FLASH_CACHE_BLOCKS > 0
+/*
+ * Write-back cache of erase blocks. Sector writes are merged into the
+ * cached copy of their erase block, which is only erased and programmed
+ * when it is evicted or on CTRL_SYNC. FatFs issues CTRL_SYNC from
+ * f_sync(), so f_close() of a modified file always flushes the cache.
+ */
+struct cache_block {
+	off_t addr;		/* erase-aligned flash address */
+	uint32_t age;		/* last use, for LRU eviction */
+	bool valid;
+	bool dirty;
+	uint8_t data[CONFIG_FS_BLOCK_SIZE];
+};
+
+static struct cache_block block_cache[CONFIG_FS_FAT_FLASH_CACHE_BLOCKS];
+static uint32_t cache_clock;
+#endif
+
 /* calculate number of blocks required for a given size */
 #define GET_NUM_BLOCK(total_size, block_size) \
 	((total_size + block_size - 1) / block_size)
@@ -69,16 +96,11 @@ DSTATUS fat_disk_initialize(void)
 	return RES_OK;
 }
 
-DRESULT fat_disk_read(void *buff, uint32_t start_sector,
-		      uint32_t sector_count)
+static DRESULT read_flash(off_t fl_addr, uint8_t *buff, uint32_t remaining)
 {
-	off_t fl_addr;
-	uint32_t remaining;
 	uint32_t len;
 	uint32_t num_read;
 
-	fl_addr = lba_to_address(start_sector);
-	remaining = (sector_count * _MIN_SS);
 	len = CONFIG_FS_FLASH_MAX_RW_SIZE;
 
 	num_read = GET_NUM_BLOCK(remaining, CONFIG_FS_FLASH_MAX_RW_SIZE);
@@ -163,6 +185,7 @@ static DRESULT update_flash_block(off_t start_addr, uint32_t size,
 	if (flash_erase(flash_dev, fl_addr, CONFIG_FS_BLOCK_SIZE) != 0) {
 		return RES_ERROR;
 	}
+	disk_stats.block_erases++;
 
 	/* write data to flash */
 	num_write = GET_NUM_BLOCK(CONFIG_FS_BLOCK_SIZE,
@@ -176,6 +199,7 @@ static DRESULT update_flash_block(off_t start_addr, uint32_t size,
 				CONFIG_FS_FLASH_MAX_RW_SIZE) != 0) {
 			return RES_ERROR;
 		}
+		disk_stats.flash_writes++;
 
 		fl_addr += CONFIG_FS_FLASH_MAX_RW_SIZE;
 		src += CONFIG_FS_FLASH_MAX_RW_SIZE;
@@ -184,7 +208,170 @@ static DRESULT update_flash_block(off_t start_addr, uint32_t size,
 	return RES_OK;
 }
 
-DRESULT fat_disk_write(const void *buff, uint32_t start_sector,
+#if CONFIG_FS_FAT_FLASH_CACHE_BLOCKS > 0
+static struct cache_block *cache_find(off_t fl_addr)
+{
+	for (int i = 0; i < CONFIG_FS_FAT_FLASH_CACHE_BLOCKS; i++) {
+		if (block_cache[i].valid && block_cache[i].addr == fl_addr) {
+			return &block_cache[i];
+		}
+	}
+
+	return NULL;
+}
+
+static DRESULT cache_flush_block(struct cache_block *blk)
+{
+	if (!blk->dirty) {
+		return RES_OK;
+	}
+
+	if (update_flash_block(blk->addr, CONFIG_FS_BLOCK_SIZE,
+			       blk->data) != RES_OK) {
+		return RES_ERROR;
+	}
+
+	blk->dirty = false;
+
+	return RES_OK;
+}
+
+/* Get a free cache slot, evicting the least recently used block if needed */
+static struct cache_block *cache_alloc(off_t fl_addr)
+{
+	struct cache_block *blk = &block_cache[0];
+
+	for (int i = 0; i < CONFIG_FS_FAT_FLASH_CACHE_BLOCKS; i++) {
+		if (!block_cache[i].valid) {
+			blk = &block_cache[i];
+			break;
+		}
+
+		if (block_cache[i].age < blk->age) {
+			blk = &block_cache[i];
+		}
+	}
+
+	if (blk->valid) {
+		if (blk->dirty) {
+			disk_stats.cache_evictions++;
+		}
+
+		if (cache_flush_block(blk) != RES_OK) {
+			return NULL;
+		}
+	}
+
+	blk->addr = fl_addr;
+	blk->valid = true;
+	blk->dirty = false;
+
+	return blk;
+}
+
+/* input size is either less or equal to a block size, CONFIG_FS_BLOCK_SIZE. */
+static DRESULT cache_write_block(off_t start_addr, uint32_t size,
+				 const void *buff)
+{
+	struct cache_block *blk;
+	off_t fl_addr;
+
+	fl_addr = ROUND_DOWN(start_addr, CONFIG_FS_FLASH_ERASE_ALIGNMENT);
+
+	blk = cache_find(fl_addr);
+	if (blk) {
+		disk_stats.cache_hits++;
+		memcpy(blk->data + (start_addr - fl_addr), buff, size);
+	} else {
+		blk = cache_alloc(fl_addr);
+		if (!blk) {
+			return RES_ERROR;
+		}
+
+		if (size < CONFIG_FS_BLOCK_SIZE) {
+			if (read_copy_flash_block(start_addr, size, buff,
+						  blk->data) != RES_OK) {
+				blk->valid = false;
+				return RES_ERROR;
+			}
+		} else {
+			memcpy(blk->data, buff, size);
+		}
+	}
+
+	blk->dirty = true;
+	blk->age = ++cache_clock;
+
+	return RES_OK;
+}
+
+static DRESULT cache_read(off_t fl_addr, uint8_t *buff, uint32_t remaining)
+{
+	struct cache_block *blk;
+	uint32_t len;
+
+	while (remaining) {
+		len = min(remaining, GET_SIZE_TO_BOUNDARY(fl_addr,
+							   CONFIG_FS_BLOCK_SIZE));
+
+		blk = cache_find(ROUND_DOWN(fl_addr,
+					    CONFIG_FS_FLASH_ERASE_ALIGNMENT));
+		if (blk) {
+			memcpy(buff, blk->data + (fl_addr - blk->addr), len);
+		} else if (read_flash(fl_addr, buff, len) != RES_OK) {
+			return RES_ERROR;
+		}
+
+		fl_addr += len;
+		buff += len;
+		remaining -= len;
+	}
+
+	return RES_OK;
+}
+
+static DRESULT cache_sync(void)
+{
+	DRESULT res = RES_OK;
+
+	for (int i = 0; i < CONFIG_FS_FAT_FLASH_CACHE_BLOCKS; i++) {
+		if (block_cache[i].valid &&
+		    cache_flush_block(&block_cache[i]) != RES_OK) {
+			res = RES_ERROR;
+		}
+	}
+
+	return res;
+}
+#endif /* CONFIG_FS_FAT_FLASH_CACHE_BLOCKS > 0 */
+
+static DRESULT write_flash_block(off_t start_addr, uint32_t size,
+				 const void *buff)
+{
+#if CONFIG_FS_FAT_FLASH_CACHE_BLOCKS > 0
+	return cache_write_block(start_addr, size, buff);
+#else
+	return update_flash_block(start_addr, size, buff);
+#endif
+}
+
+DRESULT fat_disk_read(uint8_t *buff, unsigned long start_sector,
+		      uint32_t sector_count)
+{
+	off_t fl_addr;
+	uint32_t size;
+
+	fl_addr = lba_to_address(start_sector);
+	size = (sector_count * _MIN_SS);
+
+#if CONFIG_FS_FAT_FLASH_CACHE_BLOCKS > 0
+	return cache_read(fl_addr, buff, size);
+#else
+	return read_flash(fl_addr, buff, size);
+#endif
+}
+
+DRESULT fat_disk_write(const uint8_t *buff, unsigned long start_sector,
 		       uint32_t sector_count)
 {
 	off_t fl_addr;
@@ -193,6 +380,7 @@ DRESULT fat_disk_write(const void *buff, uint32_t start_sector,
 
 	fl_addr = lba_to_address(start_sector);
 	remaining = (sector_count * _MIN_SS);
+	disk_stats.sector_writes += sector_count;
 
 	/* check if start address is erased-aligned address  */
 	if (fl_addr & (CONFIG_FS_FLASH_ERASE_ALIGNMENT - 1)) {
@@ -203,7 +391,7 @@ DRESULT fat_disk_write(const void *buff, uint32_t start_sector,
 		    ((fl_addr + CONFIG_FS_BLOCK_SIZE) &
 		     ~(CONFIG_FS_BLOCK_SIZE - 1))) {
 			/* not over block boundary (a partial block also) */
-			if (update_flash_block(fl_addr, remaining, buff) != 0) {
+			if (write_flash_block(fl_addr, remaining, buff) != 0) {
 				return RES_ERROR;
 			}
 			return RES_OK;
@@ -213,7 +401,7 @@ DRESULT fat_disk_write(const void *buff, uint32_t start_sector,
 		size = GET_SIZE_TO_BOUNDARY(fl_addr, CONFIG_FS_BLOCK_SIZE);
 
 		/* write first partial block */
-		if (update_flash_block(fl_addr, size, buff) != 0) {
+		if (write_flash_block(fl_addr, size, buff) != 0) {
 			return RES_ERROR;
 		}
 
@@ -228,8 +416,8 @@ DRESULT fat_disk_write(const void *buff, uint32_t start_sector,
 			break;
 		}
 
-		if (update_flash_block(fl_addr, CONFIG_FS_BLOCK_SIZE,
-					buff) != 0) {
+		if (write_flash_block(fl_addr, CONFIG_FS_BLOCK_SIZE,
+				      buff) != 0) {
 			return RES_ERROR;
 		}
 
@@ -240,7 +428,7 @@ DRESULT fat_disk_write(const void *buff, uint32_t start_sector,
 
 	/* remaining partial block */
 	if (remaining) {
-		if (update_flash_block(fl_addr, remaining, buff) != 0) {
+		if (write_flash_block(fl_addr, remaining, buff) != 0) {
 			return RES_ERROR;
 		}
 	}
@@ -252,7 +440,11 @@ DRESULT fat_disk_ioctl(uint8_t cmd, void *buff)
 {
 	switch (cmd) {
 	case CTRL_SYNC:
+#if CONFIG_FS_FAT_FLASH_CACHE_BLOCKS > 0
+		return cache_sync();
+#else
 		return RES_OK;
+#endif
 	case GET_SECTOR_COUNT:
 		*(uint32_t *)buff = CONFIG_FS_VOLUME_SIZE / _MIN_SS;
 		return RES_OK;
@@ -265,3 +457,8 @@ DRESULT fat_disk_ioctl(uint8_t cmd, void *buff)
 
 	return RES_PARERR;
 }
+
+void fat_disk_stats_get(struct fat_disk_stats *stats)
+{
+	*stats = disk_stats;
+}
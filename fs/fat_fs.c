@@ -19,12 +19,20 @@
 #include <stdint.h>
 #include <errno.h>
 #include <init.h>
+#include <nanokernel.h>
 #include <ff.h>
 #include <fs.h>
 #include <misc/__assert.h>
+#include <misc/util.h>
 
 static FATFS fat_fs;	/* FatFs work area */
 
+#if _FS_REENTRANT
+static struct nano_sem fat_lock;
+static uint32_t lock_start;	/* cycle count when the lock was taken */
+static struct fs_lock_stats lock_stats;
+#endif
+
 static int translate_error(int error)
 {
 	switch (error) {
@@ -148,6 +156,27 @@ int fs_seek(ZFILE *zfp, off_t offset, int whence)
 	return translate_error(res);
 }
 
+int fs_file_fastseek_enable(ZFILE *zfp)
+{
+#ifdef CONFIG_FS_FAT_FASTSEEK
+	FRESULT res;
+
+	zfp->clmt[0] = ARRAY_SIZE(zfp->clmt);
+	zfp->fp.cltbl = zfp->clmt;
+
+	res = f_lseek(&zfp->fp, CREATE_LINKMAP);
+	if (res != FR_OK) {
+		zfp->fp.cltbl = NULL;
+	}
+
+	return translate_error(res);
+#else
+	ARG_UNUSED(zfp);
+
+	return -ENOTSUP;
+#endif
+}
+
 int fs_mkdir(const char *path)
 {
 	FRESULT res;
@@ -207,6 +236,98 @@ int fs_stat(const char *path, struct zfs_dirent *entry)
 	return translate_error(res);
 }
 
+#if _FS_REENTRANT
+/* FatFs synchronization hooks, the volume lock is a nano_sem */
+int ff_cre_syncobj(BYTE vol, _SYNC_t *sobj)
+{
+	ARG_UNUSED(vol);
+
+	nano_sem_init(&fat_lock);
+	nano_sem_give(&fat_lock);
+	*sobj = &fat_lock;
+
+	return 1;
+}
+
+int ff_del_syncobj(_SYNC_t sobj)
+{
+	ARG_UNUSED(sobj);
+
+	return 1;
+}
+
+int ff_req_grant(_SYNC_t sobj)
+{
+	uint32_t start, wait;
+
+	if (!nano_sem_take(sobj, TICKS_NONE)) {
+		start = sys_cycle_get_32();
+
+		if (!nano_sem_take(sobj, _FS_TIMEOUT)) {
+			return 0;
+		}
+
+		lock_start = sys_cycle_get_32();
+		wait = lock_start - start;
+
+		lock_stats.contentions++;
+		lock_stats.total_wait += wait;
+		if (wait > lock_stats.max_wait) {
+			lock_stats.max_wait = wait;
+		}
+	} else {
+		lock_start = sys_cycle_get_32();
+	}
+
+	lock_stats.acquisitions++;
+
+	return 1;
+}
+
+void ff_rel_grant(_SYNC_t sobj)
+{
+	uint32_t hold = sys_cycle_get_32() - lock_start;
+
+	lock_stats.total_hold += hold;
+	if (hold > lock_stats.max_hold) {
+		lock_stats.max_hold = hold;
+	}
+
+	nano_sem_give(sobj);
+}
+
+int fs_lock_stats_get(struct fs_lock_stats *stats)
+{
+	/* taken directly so that reading does not show in the stats */
+	nano_sem_take(&fat_lock, TICKS_UNLIMITED);
+	*stats = lock_stats;
+	nano_sem_give(&fat_lock);
+
+	return 0;
+}
+
+int fs_lock_stats_reset(void)
+{
+	nano_sem_take(&fat_lock, TICKS_UNLIMITED);
+	memset(&lock_stats, 0, sizeof(lock_stats));
+	nano_sem_give(&fat_lock);
+
+	return 0;
+}
+#else
+int fs_lock_stats_get(struct fs_lock_stats *stats)
+{
+	ARG_UNUSED(stats);
+
+	return -ENOTSUP;
+}
+
+int fs_lock_stats_reset(void)
+{
+	return -ENOTSUP;
+}
+#endif /* _FS_REENTRANT */
+
 static int fs_init(struct device *dev)
 {
 	FRESULT res;
@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) 2016 Intel Corporation.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdint.h>
+#include <diskio.h>
+#include <ff.h>
+#include <device.h>
+#include <fs/fat_diskio.h>
+#include <fs/flash_ftl.h>
+
+#if _MIN_SS != FLASH_FTL_SECTOR_SIZE
+#error "FAT sector size does not match the flash translation layer"
+#endif
+
+static struct device *flash_dev;
+static uint32_t sector_writes;
+
+DSTATUS fat_disk_status(void)
+{
+	if (!flash_dev) {
+		return STA_NOINIT;
+	}
+
+	return RES_OK;
+}
+
+DSTATUS fat_disk_initialize(void)
+{
+	struct device *dev;
+
+	if (flash_dev) {
+		return RES_OK;
+	}
+
+	dev = device_get_binding(CONFIG_FS_FLASH_DEV_NAME);
+	if (!dev) {
+		return STA_NOINIT;
+	}
+
+	if (flash_ftl_init(dev) != 0) {
+		return STA_NOINIT;
+	}
+
+	flash_dev = dev;
+
+	return RES_OK;
+}
+
+DRESULT fat_disk_read(uint8_t *buff, unsigned long sector, uint32_t count)
+{
+	if (flash_ftl_read(buff, sector, count) != 0) {
+		return RES_ERROR;
+	}
+
+	return RES_OK;
+}
+
+DRESULT fat_disk_write(const uint8_t *buff, unsigned long sector,
+		       uint32_t count)
+{
+	sector_writes += count;
+
+	if (flash_ftl_write(buff, sector, count) != 0) {
+		return RES_ERROR;
+	}
+
+	return RES_OK;
+}
+
+DRESULT fat_disk_ioctl(uint8_t cmd, void *buff)
+{
+	switch (cmd) {
+	case CTRL_SYNC:
+		/* every FTL write is committed before it returns */
+		return RES_OK;
+	case GET_SECTOR_COUNT:
+		*(uint32_t *)buff = CONFIG_FS_VOLUME_SIZE / _MIN_SS;
+		return RES_OK;
+	case GET_BLOCK_SIZE: /* in sectors */
+		*(uint32_t *)buff = CONFIG_FS_BLOCK_SIZE / _MIN_SS;
+		return RES_OK;
+	case CTRL_TRIM:
+		break;
+	}
+
+	return RES_PARERR;
+}
+
+void fat_disk_stats_get(struct fat_disk_stats *stats)
+{
+	struct flash_ftl_stats ftl;
+
+	flash_ftl_stats_get(&ftl);
+
+	stats->sector_writes = sector_writes;
+	stats->block_erases = ftl.erases;
+	stats->flash_writes = ftl.flash_writes;
+	stats->cache_hits = 0;
+	stats->cache_evictions = 0;
+}
@@ -0,0 +1,729 @@
+/*
+ * Copyright (c) 2016 Intel Corporation.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file
+ * @brief Log-structured flash translation layer
+ *
+ * The FTL area is split into erase blocks. The first sector sized slot of
+ * every block holds a summary: a magic, the block erase count, the
+ * sequence number given to the block when it was opened for writing and
+ * one tag per data slot naming the logical sector stored there.
+ *
+ * Writes always go to the next free slot of the open block and the slot
+ * tag is programmed last, so a sector only becomes visible once its data
+ * is complete. The previous copy is just dropped from the RAM sector
+ * map. A background fiber reclaims blocks holding the fewest live
+ * sectors by copying them into the open block and erasing the victim,
+ * keeping a pool of erased blocks ready. Static wear leveling moves the
+ * data of the least erased block once it falls too far behind.
+ *
+ * On mount the sector map is rebuilt from the summaries; when a sector
+ * is found in several blocks the copy in the block opened last wins.
+ */
+
+#include <string.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <errno.h>
+#include <nanokernel.h>
+#include <misc/util.h>
+#include <flash.h>
+#include <fs/flash_ftl.h>
+
+#define FTL_MAGIC 0x46544c31	/* "FTL1" */
+
+#define SLOTS_PER_BLOCK (CONFIG_FS_BLOCK_SIZE / FLASH_FTL_SECTOR_SIZE)
+/* slot 0 of each block holds the block summary */
+#define DATA_SLOTS (SLOTS_PER_BLOCK - 1)
+#define NUM_SECTORS (CONFIG_FS_VOLUME_SIZE / FLASH_FTL_SECTOR_SIZE)
+#define NUM_BLOCKS (((NUM_SECTORS + DATA_SLOTS - 1) / DATA_SLOTS) + \
+		    CONFIG_FS_FAT_FTL_SPARE_BLOCKS)
+
+#define SLOT_NONE 0xffff
+#define BLOCK_NONE 0xffff
+#define ERASED_WORD 0xffffffff
+
+/* erased blocks only garbage collection may open */
+#define GC_RESERVE 1
+
+#if (DATA_SLOTS < 1) || ((16 + DATA_SLOTS * 4) > FLASH_FTL_SECTOR_SIZE)
+#error "FS_BLOCK_SIZE not supported by the flash translation layer"
+#endif
+
+#if (NUM_BLOCKS * DATA_SLOTS) >= SLOT_NONE
+#error "FS_VOLUME_SIZE too large for the flash translation layer"
+#endif
+
+struct block_summary {
+	uint32_t magic;
+	uint32_t erase_count;
+	uint32_t seq;			/* ERASED_WORD until opened */
+	uint32_t reserved;
+	uint32_t tags[DATA_SLOTS];	/* sector tag of each data slot */
+};
+
+enum block_state {
+	BLOCK_FREE,		/* erased, summary header written */
+	BLOCK_OPEN,		/* receiving writes */
+	BLOCK_FULL,		/* all slots used */
+	BLOCK_STALE,		/* no live sectors, waiting for erase */
+	BLOCK_ERASING,		/* erase in progress */
+	BLOCK_BAD,		/* failed to erase, never used again */
+};
+
+struct block_info {
+	uint32_t erase_count;
+	uint32_t seq;
+	uint8_t valid;		/* live sectors in the block */
+	uint8_t state;
+};
+
+static struct device *flash_dev;
+
+static struct nano_sem ftl_lock;
+/* held by the collector across an erase done without ftl_lock */
+static struct nano_sem erase_lock;
+static struct nano_sem gc_sem;
+
+static uint16_t sector_map[NUM_SECTORS];
+static struct block_info blocks[NUM_BLOCKS];
+static uint16_t open_block = BLOCK_NONE;
+static uint8_t open_slot;
+static uint16_t free_blocks;
+static uint32_t next_seq;
+static bool gc_pending;
+
+static struct flash_ftl_stats ftl_stats;
+
+static uint8_t gc_buf[FLASH_FTL_SECTOR_SIZE];
+static char __stack gc_stack[CONFIG_FS_FAT_FTL_GC_STACK_SIZE];
+static bool gc_started;
+
+/*
+ * A tag stores the sector number in the low half and its complement in
+ * the high half, so neither an unprogrammed nor a torn tag looks valid.
+ */
+static inline uint32_t sector_tag(uint32_t sector)
+{
+	return (sector & 0xffff) | ((~sector & 0xffff) << 16);
+}
+
+static inline bool tag_valid(uint32_t tag)
+{
+	return (tag >> 16) == (~tag & 0xffff);
+}
+
+static inline off_t block_addr(uint16_t block)
+{
+	return CONFIG_FS_FLASH_START + (off_t)block * CONFIG_FS_BLOCK_SIZE;
+}
+
+static inline off_t slot_addr(uint16_t block, uint8_t slot)
+{
+	return block_addr(block) + (slot + 1) * FLASH_FTL_SECTOR_SIZE;
+}
+
+static inline off_t tag_addr(uint16_t block, uint8_t slot)
+{
+	return block_addr(block) + offsetof(struct block_summary, tags) +
+	       slot * sizeof(uint32_t);
+}
+
+static int ftl_flash_read(off_t addr, void *data, size_t len)
+{
+	uint8_t *dst = data;
+	size_t size;
+
+	while (len) {
+		size = min(len, CONFIG_FS_FLASH_MAX_RW_SIZE);
+
+		if (flash_read(flash_dev, addr, dst, size) != 0) {
+			return -EIO;
+		}
+
+		addr += size;
+		dst += size;
+		len -= size;
+	}
+
+	return 0;
+}
+
+static int ftl_flash_write(off_t addr, const void *data, size_t len)
+{
+	const uint8_t *src = data;
+	size_t size;
+
+	while (len) {
+		size = min(len, CONFIG_FS_FLASH_MAX_RW_SIZE);
+
+		/* flash_write may reenable write-protection */
+		flash_write_protection_set(flash_dev, false);
+
+		if (flash_write(flash_dev, addr, src, size) != 0) {
+			return -EIO;
+		}
+		ftl_stats.flash_writes++;
+
+		addr += size;
+		src += size;
+		len -= size;
+	}
+
+	return 0;
+}
+
+/* Erase a block and write the summary header carrying its erase count */
+static int erase_block(uint16_t block, uint32_t erase_count)
+{
+	uint32_t hdr[2] = { FTL_MAGIC, erase_count };
+
+	flash_write_protection_set(flash_dev, false);
+	if (flash_erase(flash_dev, block_addr(block),
+			CONFIG_FS_BLOCK_SIZE) != 0) {
+		return -EIO;
+	}
+
+	return ftl_flash_write(block_addr(block), hdr, sizeof(hdr));
+}
+
+static void block_set_free(uint16_t block, uint32_t erase_count)
+{
+	blocks[block].erase_count = erase_count;
+	blocks[block].seq = ERASED_WORD;
+	blocks[block].valid = 0;
+	blocks[block].state = BLOCK_FREE;
+	free_blocks++;
+	ftl_stats.erases++;
+}
+
+static void block_invalidate(uint16_t phys)
+{
+	struct block_info *blk = &blocks[phys / DATA_SLOTS];
+
+	blk->valid--;
+	if (!blk->valid && blk->state == BLOCK_FULL) {
+		blk->state = BLOCK_STALE;
+		gc_pending = true;
+	}
+}
+
+static int gc_collect(bool background);
+
+/* Least erased free block, for dynamic wear leveling */
+static uint16_t free_block_pick(void)
+{
+	uint16_t best = BLOCK_NONE;
+
+	for (uint16_t i = 0; i < NUM_BLOCKS; i++) {
+		if (blocks[i].state != BLOCK_FREE) {
+			continue;
+		}
+
+		if (best == BLOCK_NONE ||
+		    blocks[i].erase_count < blocks[best].erase_count) {
+			best = i;
+		}
+	}
+
+	return best;
+}
+
+static int open_block_get(bool gc)
+{
+	uint16_t block;
+	uint32_t seq;
+	int ret;
+
+	/* host writes leave the reserve to garbage collection */
+	while (open_block == BLOCK_NONE && !gc &&
+	       free_blocks <= GC_RESERVE) {
+		ftl_stats.sync_collections++;
+
+		ret = gc_collect(false);
+		if (ret <= 0) {
+			return ret ? ret : -ENOSPC;
+		}
+	}
+
+	if (open_block != BLOCK_NONE) {
+		return 0;
+	}
+
+	block = free_block_pick();
+	if (block == BLOCK_NONE) {
+		return -ENOSPC;
+	}
+
+	free_blocks--;
+
+	seq = next_seq++;
+	if (ftl_flash_write(block_addr(block) +
+			    offsetof(struct block_summary, seq),
+			    &seq, sizeof(seq)) != 0) {
+		blocks[block].state = BLOCK_STALE;
+		return -EIO;
+	}
+
+	blocks[block].seq = seq;
+	blocks[block].valid = 0;
+	blocks[block].state = BLOCK_OPEN;
+	open_block = block;
+	open_slot = 0;
+
+	return 0;
+}
+
+static int append_sector(uint32_t sector, const uint8_t *data, bool gc)
+{
+	uint16_t block;
+	uint8_t slot;
+	uint32_t tag;
+	int ret;
+
+	ret = open_block_get(gc);
+	if (ret) {
+		return ret;
+	}
+
+	block = open_block;
+	slot = open_slot++;
+
+	/* the tag goes last: it is what makes the new copy visible */
+	ret = ftl_flash_write(slot_addr(block, slot), data,
+			      FLASH_FTL_SECTOR_SIZE);
+	if (!ret) {
+		tag = sector_tag(sector);
+		ret = ftl_flash_write(tag_addr(block, slot), &tag,
+				      sizeof(tag));
+	}
+
+	if (!ret) {
+		if (sector_map[sector] != SLOT_NONE) {
+			block_invalidate(sector_map[sector]);
+		}
+
+		sector_map[sector] = block * DATA_SLOTS + slot;
+		blocks[block].valid++;
+	}
+
+	if (open_slot == DATA_SLOTS) {
+		blocks[block].state = blocks[block].valid ? BLOCK_FULL :
+			BLOCK_STALE;
+		open_block = BLOCK_NONE;
+		gc_pending = true;
+	}
+
+	return ret;
+}
+
+/*
+ * Pick the block to reclaim. Blocks without live sectors come first. With
+ * greedy set, the full block with the fewest live sectors is taken; with
+ * wear_level set, a full block lagging the most erased block by more
+ * than the threshold is taken even if all its sectors are live.
+ */
+static uint16_t gc_victim_pick(bool greedy, bool wear_level)
+{
+	uint16_t victim = BLOCK_NONE;
+	uint16_t cold = BLOCK_NONE;
+	uint32_t max_erase_count = 0;
+
+	for (uint16_t i = 0; i < NUM_BLOCKS; i++) {
+		struct block_info *blk = &blocks[i];
+
+		if (blk->state == BLOCK_STALE) {
+			return i;
+		}
+
+		if (blk->state == BLOCK_BAD) {
+			continue;
+		}
+
+		max_erase_count = max(max_erase_count, blk->erase_count);
+
+		if (blk->state != BLOCK_FULL) {
+			continue;
+		}
+
+		if (victim == BLOCK_NONE || blk->valid < blocks[victim].valid) {
+			victim = i;
+		}
+
+		if (cold == BLOCK_NONE ||
+		    blk->erase_count < blocks[cold].erase_count) {
+			cold = i;
+		}
+	}
+
+	if (wear_level && cold != BLOCK_NONE &&
+	    (max_erase_count - blocks[cold].erase_count) >
+	    CONFIG_FS_FAT_FTL_WEAR_LEVEL_THRESHOLD) {
+		return cold;
+	}
+
+	/* copying a block without stale sectors frees nothing */
+	if (!greedy || victim == BLOCK_NONE ||
+	    blocks[victim].valid == DATA_SLOTS) {
+		return BLOCK_NONE;
+	}
+
+	return victim;
+}
+
+/* Copy the live sectors of a block into the open block */
+static int gc_relocate(uint16_t victim)
+{
+	uint32_t tags[DATA_SLOTS];
+	uint32_t sector;
+	int ret;
+
+	ret = ftl_flash_read(tag_addr(victim, 0), tags, sizeof(tags));
+	if (ret) {
+		return ret;
+	}
+
+	for (uint8_t slot = 0; slot < DATA_SLOTS; slot++) {
+		if (!tag_valid(tags[slot])) {
+			continue;
+		}
+
+		sector = tags[slot] & 0xffff;
+		if (sector >= NUM_SECTORS ||
+		    sector_map[sector] != victim * DATA_SLOTS + slot) {
+			continue;
+		}
+
+		ret = ftl_flash_read(slot_addr(victim, slot), gc_buf,
+				     FLASH_FTL_SECTOR_SIZE);
+		if (!ret) {
+			ret = append_sector(sector, gc_buf, true);
+		}
+
+		if (ret) {
+			return ret;
+		}
+
+		ftl_stats.gc_writes++;
+	}
+
+	return 0;
+}
+
+/*
+ * Reclaim one block. Called with ftl_lock held; the background collector
+ * also holds erase_lock and drops ftl_lock while the block is erased so
+ * that reads and writes can go on meanwhile.
+ *
+ * Returns 1 if a block was erased, 0 if there was nothing to reclaim.
+ */
+static int gc_collect(bool background)
+{
+	uint16_t victim;
+	uint32_t erase_count;
+	int ret;
+
+	if (background) {
+		/* only move cold data while there is room to spare */
+		bool low = free_blocks < CONFIG_FS_FAT_FTL_GC_THRESHOLD;
+
+		victim = gc_victim_pick(low, !low);
+	} else {
+		victim = gc_victim_pick(true, false);
+	}
+
+	if (victim == BLOCK_NONE) {
+		return 0;
+	}
+
+	if (blocks[victim].state == BLOCK_FULL) {
+		ret = gc_relocate(victim);
+		if (ret) {
+			return ret;
+		}
+	}
+
+	blocks[victim].state = BLOCK_ERASING;
+	erase_count = blocks[victim].erase_count + 1;
+
+	if (background) {
+		nano_sem_give(&ftl_lock);
+	}
+
+	ret = erase_block(victim, erase_count);
+
+	if (background) {
+		nano_sem_take(&ftl_lock, TICKS_UNLIMITED);
+	}
+
+	if (ret) {
+		blocks[victim].state = BLOCK_BAD;
+		return ret;
+	}
+
+	block_set_free(victim, erase_count);
+
+	return 1;
+}
+
+static void gc_fiber(int arg1, int arg2)
+{
+	int ret;
+
+	ARG_UNUSED(arg1);
+	ARG_UNUSED(arg2);
+
+	while (1) {
+		nano_sem_take(&gc_sem, TICKS_UNLIMITED);
+
+		do {
+			nano_sem_take(&erase_lock, TICKS_UNLIMITED);
+			nano_sem_take(&ftl_lock, TICKS_UNLIMITED);
+
+			ret = gc_collect(true);
+
+			nano_sem_give(&ftl_lock);
+			nano_sem_give(&erase_lock);
+
+			fiber_yield();
+		} while (ret > 0);
+	}
+}
+
+/* Called with ftl_lock held, tells whether the collector has work */
+static bool gc_needed(void)
+{
+	bool needed = gc_pending ||
+		      free_blocks < CONFIG_FS_FAT_FTL_GC_THRESHOLD;
+
+	gc_pending = false;
+
+	return needed;
+}
+
+static int ftl_mount(void)
+{
+	struct block_summary sum;
+	struct block_info *blk;
+	uint32_t sector;
+	uint16_t phys;
+
+	memset(sector_map, 0xff, sizeof(sector_map));
+	open_block = BLOCK_NONE;
+	free_blocks = 0;
+	next_seq = 0;
+
+	for (uint16_t i = 0; i < NUM_BLOCKS; i++) {
+		blk = &blocks[i];
+		blk->valid = 0;
+
+		if (ftl_flash_read(block_addr(i), &sum, sizeof(sum)) != 0) {
+			return -EIO;
+		}
+
+		if (sum.magic != FTL_MAGIC) {
+			/* never formatted, or the erase was interrupted */
+			if (erase_block(i, 0) != 0) {
+				blk->state = BLOCK_BAD;
+				continue;
+			}
+
+			block_set_free(i, 0);
+			continue;
+		}
+
+		blk->erase_count = sum.erase_count;
+		blk->seq = sum.seq;
+
+		if (sum.seq == ERASED_WORD) {
+			blk->state = BLOCK_FREE;
+			free_blocks++;
+			continue;
+		}
+
+		/* slots left in a block opened before are not reused */
+		blk->state = BLOCK_FULL;
+		next_seq = max(next_seq, sum.seq + 1);
+
+		for (uint8_t slot = 0; slot < DATA_SLOTS; slot++) {
+			if (!tag_valid(sum.tags[slot])) {
+				continue;
+			}
+
+			sector = sum.tags[slot] & 0xffff;
+			if (sector >= NUM_SECTORS) {
+				continue;
+			}
+
+			phys = sector_map[sector];
+			if (phys != SLOT_NONE) {
+				if (phys / DATA_SLOTS != i &&
+				    blocks[phys / DATA_SLOTS].seq > sum.seq) {
+					continue;
+				}
+
+				blocks[phys / DATA_SLOTS].valid--;
+			}
+
+			sector_map[sector] = i * DATA_SLOTS + slot;
+			blk->valid++;
+		}
+	}
+
+	for (uint16_t i = 0; i < NUM_BLOCKS; i++) {
+		if (blocks[i].state == BLOCK_FULL && !blocks[i].valid) {
+			blocks[i].state = BLOCK_STALE;
+		}
+	}
+
+	gc_pending = true;
+
+	return 0;
+}
+
+int flash_ftl_init(struct device *dev)
+{
+	bool kick;
+	int ret;
+
+	if (!gc_started) {
+		nano_sem_init(&ftl_lock);
+		nano_sem_give(&ftl_lock);
+		nano_sem_init(&erase_lock);
+		nano_sem_give(&erase_lock);
+		nano_sem_init(&gc_sem);
+	}
+
+	/* keep the collector out while the map is rebuilt */
+	nano_sem_take(&erase_lock, TICKS_UNLIMITED);
+	nano_sem_take(&ftl_lock, TICKS_UNLIMITED);
+
+	flash_dev = dev;
+	ret = ftl_mount();
+	kick = gc_needed();
+
+	nano_sem_give(&ftl_lock);
+	nano_sem_give(&erase_lock);
+
+	if (ret) {
+		return ret;
+	}
+
+	if (!gc_started) {
+		gc_started = true;
+		fiber_start(gc_stack, sizeof(gc_stack), gc_fiber, 0, 0,
+			    CONFIG_FS_FAT_FTL_GC_FIBER_PRIO, 0);
+	}
+
+	if (kick) {
+		nano_sem_give(&gc_sem);
+	}
+
+	return 0;
+}
+
+int flash_ftl_read(uint8_t *buf, uint32_t sector, uint32_t count)
+{
+	uint16_t phys;
+	int ret = 0;
+
+	if (sector >= NUM_SECTORS || count > NUM_SECTORS - sector) {
+		return -EINVAL;
+	}
+
+	nano_sem_take(&ftl_lock, TICKS_UNLIMITED);
+
+	for (; count; count--, sector++, buf += FLASH_FTL_SECTOR_SIZE) {
+		phys = sector_map[sector];
+
+		if (phys == SLOT_NONE) {
+			memset(buf, 0xff, FLASH_FTL_SECTOR_SIZE);
+			continue;
+		}
+
+		ret = ftl_flash_read(slot_addr(phys / DATA_SLOTS,
+					       phys % DATA_SLOTS),
+				     buf, FLASH_FTL_SECTOR_SIZE);
+		if (ret) {
+			break;
+		}
+	}
+
+	nano_sem_give(&ftl_lock);
+
+	return ret;
+}
+
+int flash_ftl_write(const uint8_t *buf, uint32_t sector, uint32_t count)
+{
+	bool kick;
+	int ret = 0;
+
+	if (sector >= NUM_SECTORS || count > NUM_SECTORS - sector) {
+		return -EINVAL;
+	}
+
+	nano_sem_take(&ftl_lock, TICKS_UNLIMITED);
+
+	for (; count; count--, sector++, buf += FLASH_FTL_SECTOR_SIZE) {
+		ret = append_sector(sector, buf, false);
+		if (ret) {
+			break;
+		}
+
+		ftl_stats.host_writes++;
+	}
+
+	kick = gc_needed();
+
+	nano_sem_give(&ftl_lock);
+
+	if (kick) {
+		nano_sem_give(&gc_sem);
+	}
+
+	return ret;
+}
+
+void flash_ftl_stats_get(struct flash_ftl_stats *stats)
+{
+	bool first = true;
+
+	nano_sem_take(&ftl_lock, TICKS_UNLIMITED);
+
+	*stats = ftl_stats;
+	stats->free_blocks = free_blocks;
+
+	for (uint16_t i = 0; i < NUM_BLOCKS; i++) {
+		if (blocks[i].state == BLOCK_BAD) {
+			continue;
+		}
+
+		if (first || blocks[i].erase_count < stats->min_erase_count) {
+			stats->min_erase_count = blocks[i].erase_count;
+		}
+
+		if (first || blocks[i].erase_count > stats->max_erase_count) {
+			stats->max_erase_count = blocks[i].erase_count;
+		}
+
+		first = false;
+	}
+
+	nano_sem_give(&ftl_lock);
+}
@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2016 Intel Corporation.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file
+ * @brief Asynchronous file system requests
+ *
+ * Requests are queued to a dedicated workqueue fiber, whose priority is
+ * set by CONFIG_FS_ASYNC_PRIORITY, and carried out there with the regular
+ * file system API.
+ */
+
+#include <errno.h>
+#include <nanokernel.h>
+#include <init.h>
+#include <misc/util.h>
+#include <misc/nano_work.h>
+#include <fs.h>
+
+static char __stack fs_async_stack[CONFIG_FS_ASYNC_STACK_SIZE];
+
+static const struct fiber_config fs_async_config = {
+	.stack = fs_async_stack,
+	.stack_size = sizeof(fs_async_stack),
+	.prio = CONFIG_FS_ASYNC_PRIORITY,
+};
+
+static struct nano_workqueue fs_async_wq;
+
+static void fs_async_handler(struct nano_work *work)
+{
+	struct fs_async_req *req = CONTAINER_OF(work, struct fs_async_req,
+						work);
+	int res = 0;
+
+	if (req->offset >= 0) {
+		res = fs_seek(req->zfp, req->offset, SEEK_SET);
+	}
+
+	if (res) {
+		req->result = res;
+	} else if (req->op == FS_ASYNC_READ) {
+		req->result = fs_read(req->zfp, req->ptr, req->size);
+	} else {
+		req->result = fs_write(req->zfp, req->ptr, req->size);
+	}
+
+	if (req->cb) {
+		req->cb(req);
+	}
+}
+
+int fs_async_submit(struct fs_async_req *req)
+{
+	if (!req->zfp || (req->op != FS_ASYNC_READ &&
+			  req->op != FS_ASYNC_WRITE)) {
+		return -EINVAL;
+	}
+
+	nano_work_init(&req->work, fs_async_handler);
+	nano_work_submit_to_queue(&fs_async_wq, &req->work);
+
+	return 0;
+}
+
+static int fs_async_init(struct device *dev)
+{
+	ARG_UNUSED(dev);
+
+	nano_workqueue_start(&fs_async_wq, &fs_async_config);
+
+	return 0;
+}
+
+SYS_INIT(fs_async_init, PRIMARY, CONFIG_KERNEL_INIT_PRIORITY_DEFAULT);
@@ -257,6 +257,57 @@ int bt_le_scan_start(const struct bt_le_scan_param *param, bt_le_scan_cb_t cb);
  */
 int bt_le_scan_stop(void);
 
+/** Number of buckets of the RX latency histograms */
+#define BT_RX_STATS_BUCKETS 16
+
+/** @brief HCI RX path statistics */
+struct bt_rx_path_stats {
+	/** Buffers processed */
+	uint32_t count;
+
+	/** Buffers currently queued */
+	uint16_t depth;
+
+	/** Highest number of buffers queued */
+	uint16_t max_depth;
+
+	/** Queuing latency histogram. Bucket 0 counts buffers processed
+	 *  within a microsecond, bucket n buffers that waited 2^(n-1) to
+	 *  2^n - 1 microseconds. The last bucket counts all longer waits.
+	 */
+	uint32_t latency[BT_RX_STATS_BUCKETS];
+};
+
+/** @brief HCI RX statistics */
+struct bt_rx_stats {
+	/** HCI events which refer to no connection */
+	struct bt_rx_path_stats evt;
+
+	/** ACL data, advertising reports and the other HCI events */
+	struct bt_rx_path_stats bulk;
+
+	/** Advertising reports dropped as duplicates */
+	uint32_t adv_dups;
+};
+
+/** @brief Get HCI RX statistics
+ *
+ *  Requires CONFIG_BLUETOOTH_RX_STATS.
+ *
+ *  @param stats Structure the statistics are copied into.
+ *
+ *  @return Zero on success or (negative) error code on failure.
+ */
+int bt_rx_stats_get(struct bt_rx_stats *stats);
+
+/** @brief Reset HCI RX statistics
+ *
+ *  Clears the counters and histograms, the current queue depths are kept.
+ *
+ *  @return Zero on success or (negative) error code on failure.
+ */
+int bt_rx_stats_reset(void);
+
 struct bt_le_oob {
 	/** LE address. If local privacy is enabled this is Resolvable Private
 	 *  Address.
@@ -45,7 +45,12 @@ enum bt_buf_type {
 };
 
 /** Minimum amount of user data size for buffers passed to the stack. */
+#if defined(CONFIG_BLUETOOTH_RX_STATS)
+/* Leave room for the RX queue timestamp */
+#define BT_BUF_USER_DATA_MIN 8
+#else
 #define BT_BUF_USER_DATA_MIN 4
+#endif /* CONFIG_BLUETOOTH_RX_STATS */
 
 /** Data size neeed for HCI event buffers */
 #define BT_BUF_EVT_SIZE (CONFIG_BLUETOOTH_HCI_RECV_RESERVE + \
@@ -166,6 +166,46 @@ struct bt_conn_info {
  */
 int bt_conn_get_info(const struct bt_conn *conn, struct bt_conn_info *info);
 
+/** @brief Connection TX statistics
+ *
+ *  @param pdus L2CAP PDUs sent
+ *  @param frags ACL fragments sent to the controller
+ *  @param bytes L2CAP PDU bytes sent
+ *  @param ticks Ticks since the connection was established
+ */
+struct bt_conn_tx_stats {
+	uint32_t pdus;
+	uint32_t frags;
+	uint32_t bytes;
+	uint32_t ticks;
+};
+
+/** @brief Get connection TX statistics
+ *
+ *  @param conn Connection object.
+ *  @param stats TX statistics object.
+ *
+ *  @return Zero on success or (negative) error code on failure.
+ */
+int bt_conn_get_tx_stats(const struct bt_conn *conn,
+			 struct bt_conn_tx_stats *stats);
+
+/** @brief Set the TX scheduling priority of a connection.
+ *
+ *  All connections share one TX scheduler which hands out controller
+ *  buffers round-robin. Connections with a higher priority are always
+ *  served first, connections of equal priority send up to weight ACL
+ *  fragments in turn. New connections use priority 0 and weight 1.
+ *
+ *  @param conn Connection object.
+ *  @param prio Scheduling priority, higher values are served first.
+ *  @param weight ACL fragments sent per round, at least 1.
+ *
+ *  @return Zero on success or (negative) error code on failure.
+ */
+int bt_conn_set_tx_priority(struct bt_conn *conn, uint8_t prio,
+			    uint8_t weight);
+
 /** @brief Update the connection parameters.
  *
  *  @param conn Connection object.
@@ -144,6 +144,8 @@ struct bt_gatt_attr {
 	uint16_t		handle;
 	/** Attribute permissions */
 	uint8_t			perm;
+	/** Offset to the CCC descriptor of the attribute, 0 if none */
+	uint8_t			_ccc;
 #if defined(CONFIG_BLUETOOTH_GATT_DYNAMIC_DB)
 	struct bt_gatt_attr	*_next;
 #endif /* CONFIG_BLUETOOTH_GATT_DYNAMIC_DB */
@@ -182,7 +182,11 @@ struct bt_l2cap_chan_ops {
 	/** Channel alloc_buf callback
 	 *
 	 *  If this callback is provided the channel will use it to allocate
-	 *  buffers to store incoming data.
+	 *  buffers to store incoming data. Otherwise a segmented SDU is
+	 *  passed to recv as a chain of the received buffers, see
+	 *  net_buf_frags_len(), which are held until recv returns. Such an
+	 *  SDU must fit in CONFIG_BLUETOOTH_ACL_IN_COUNT - 1 buffers, small
+	 *  segments being packed together, or the channel is disconnected.
 	 *
 	 *  @param chan The channel requesting a buffer.
 	 *
@@ -193,7 +197,8 @@ struct bt_l2cap_chan_ops {
 	/** Channel recv callback
 	 *
 	 *  @param chan The channel receiving data.
-	 *  @param buf Buffer containing incoming data.
+	 *  @param buf Buffer containing incoming data, which may have
+	 *  fragments if alloc_buf is not provided.
 	 */
 	void (*recv)(struct bt_l2cap_chan *chan, struct net_buf *buf);
 };
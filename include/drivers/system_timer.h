@@ -57,6 +57,23 @@ extern void _timer_idle_exit(void);
 
 extern uint32_t _nano_get_earliest_deadline(void);
 
+/*
+ * Drivers whose sys_cycle_get_32() lags by a tick until the tick handler
+ * has accumulated the count call _sys_thread_runtime_clock_sync() once it
+ * has, so that the interrupted thread is charged correctly.  Drivers whose
+ * handler is not dispatched through the common interrupt entry code call
+ * the ISR entry and exit hooks themselves.
+ */
+#ifdef CONFIG_THREAD_RUNTIME_STATS
+extern void _sys_thread_runtime_clock_sync(void);
+extern void _sys_thread_runtime_isr_enter(void);
+extern void _sys_thread_runtime_isr_exit(void);
+#else
+#define _sys_thread_runtime_clock_sync() do { } while (0)
+#define _sys_thread_runtime_isr_enter() do { } while (0)
+#define _sys_thread_runtime_isr_exit() do { } while (0)
+#endif
+
 extern void _nano_sys_clock_tick_announce(int32_t ticks);
 
 DEVICE_PM_OPS_DECLARE(_sys_clock);
@@ -17,8 +17,12 @@
 #ifndef _FS_H_
 #define _FS_H_
 
+#include <stdint.h>
 #include <sys/types.h>
 #include <fs/fs_interface.h>
+#ifdef CONFIG_FS_ASYNC
+#include <misc/nano_work.h>
+#endif
 
 #ifdef __cplusplus
 extern "C" {
@@ -68,6 +72,62 @@ struct zfs_dirent {
 	size_t size;
 };
 
+/**
+ * @brief Structure to receive file system lock statistics
+ *
+ * Times are in hardware clock cycles.
+ *
+ * @param acquisitions Number of times the volume lock was taken
+ * @param contentions Number of times the lock was busy when requested
+ * @param total_hold Time the lock was held, summed over acquisitions
+ * @param max_hold Longest time the lock was held at once
+ * @param total_wait Time spent waiting for a busy lock
+ * @param max_wait Longest wait for a busy lock
+ */
+struct fs_lock_stats {
+	uint32_t acquisitions;
+	uint32_t contentions;
+	uint64_t total_hold;
+	uint32_t max_hold;
+	uint64_t total_wait;
+	uint32_t max_wait;
+};
+
+#ifdef CONFIG_FS_ASYNC
+enum fs_async_op {
+	FS_ASYNC_READ,
+	FS_ASYNC_WRITE,
+};
+
+struct fs_async_req;
+
+typedef void (*fs_async_cb_t)(struct fs_async_req *req);
+
+/**
+ * @brief Asynchronous file request
+ *
+ * @param work Used by the request queue
+ * @param op FS_ASYNC_READ or FS_ASYNC_WRITE
+ * @param zfp File to read from or write to
+ * @param offset Offset from the beginning of the file, or -1 to use the
+ * current file position
+ * @param ptr Buffer to read into or write from
+ * @param size Number of bytes to transfer
+ * @param result Bytes transferred, or a negative errno code, on completion
+ * @param cb Called from the request queue fiber on completion
+ */
+struct fs_async_req {
+	struct nano_work work;
+	enum fs_async_op op;
+	ZFILE *zfp;
+	off_t offset;
+	void *ptr;
+	size_t size;
+	ssize_t result;
+	fs_async_cb_t cb;
+};
+#endif /* CONFIG_FS_ASYNC */
+
 /**
  * @}
  */
@@ -195,6 +255,24 @@ int fs_seek(ZFILE *zfp, off_t offset, int whence);
  */
 off_t fs_tell(ZFILE *zfp);
 
+/**
+ * @brief Enable fast seek on an open file
+ *
+ * Builds a table of the file's contiguous cluster runs so that seeks
+ * and reads no longer follow the cluster chain on the FAT. The table
+ * describes the file as it is when this is called, so the file cannot
+ * grow while fast seek is enabled: writes past its end come back short.
+ * Fast seek stays enabled until the file is closed.
+ *
+ * @param zfp Pointer to the file object
+ *
+ * @retval 0 Success
+ * @retval -ENOMEM The file has more fragments than the table can hold
+ * @retval -ENOTSUP Fast seek support is not enabled
+ * @retval -ERRNO errno code if error
+ */
+int fs_file_fastseek_enable(ZFILE *zfp);
+
 /**
  * @brief Directory create
  *
@@ -261,6 +339,42 @@ int fs_closedir(ZDIR *zdp);
  */
 int fs_stat(const char *path, struct zfs_dirent *entry);
 
+/**
+ * @brief Get file system lock statistics
+ *
+ * @param stats Pointer to fs_lock_stats structure to fill
+ *
+ * @retval 0 Success
+ * @retval -ENOTSUP The file system is not built thread safe
+ */
+int fs_lock_stats_get(struct fs_lock_stats *stats);
+
+/**
+ * @brief Reset file system lock statistics
+ *
+ * @retval 0 Success
+ * @retval -ENOTSUP The file system is not built thread safe
+ */
+int fs_lock_stats_reset(void);
+
+#ifdef CONFIG_FS_ASYNC
+/**
+ * @brief Queue an asynchronous file request
+ *
+ * The request is carried out by the file system request queue fiber,
+ * so the caller does not block on the volume lock or on slow storage.
+ * The request must stay valid until its callback has run, and a
+ * request can only be queued once at a time.
+ *
+ * @param req Pointer to the request, with op, zfp, offset, ptr, size
+ * and cb filled in
+ *
+ * @retval 0 Success
+ * @retval -EINVAL Invalid request
+ */
+int fs_async_submit(struct fs_async_req *req);
+#endif /* CONFIG_FS_ASYNC */
+
 /**
  * @}
  */
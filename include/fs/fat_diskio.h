@@ -27,4 +27,32 @@ DRESULT fat_disk_write(const uint8_t *buff, unsigned long sector,
 		       uint32_t count);
 DRESULT fat_disk_ioctl(uint8_t cmd, void *buff);
 
+#ifdef CONFIG_FS_FAT_FLASH_DISK
+/**
+ * @brief Flash disk write statistics
+ *
+ * @param sector_writes Sectors written by the file system
+ * @param block_erases Erase blocks erased on the flash
+ * @param flash_writes flash_write() calls issued to the flash driver
+ * @param cache_hits Writes merged into an already cached erase block
+ * @param cache_evictions Dirty erase blocks flushed to make room
+ */
+struct fat_disk_stats {
+	uint32_t sector_writes;
+	uint32_t block_erases;
+	uint32_t flash_writes;
+	uint32_t cache_hits;
+	uint32_t cache_evictions;
+};
+
+/**
+ * @brief Get the flash disk write statistics
+ *
+ * Counters are cumulative since boot.
+ *
+ * @param stats Structure the counters are copied into
+ */
+void fat_disk_stats_get(struct fat_disk_stats *stats);
+#endif /* CONFIG_FS_FAT_FLASH_DISK */
+
 #endif /* _FAT_DISKIO_H_ */
@@ -24,7 +24,12 @@
 extern "C" {
 #endif
 
+#ifdef CONFIG_FS_FAT_FASTSEEK
+/* fp.cltbl points to clmt once fast seek is enabled */
+ZFILE_DEFINE(FIL fp; DWORD clmt[CONFIG_FS_FAT_FASTSEEK_CLMT_SIZE]);
+#else
 ZFILE_DEFINE(FIL fp);
+#endif
 ZDIR_DEFINE(DIR dp);
 
 #define MAX_FILE_NAME 12 /* Uses 8.3 SFN */
@@ -0,0 +1,118 @@
+/*
+ * Copyright (c) 2016 Intel Corporation.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _FLASH_FTL_H_
+#define _FLASH_FTL_H_
+
+#include <stdint.h>
+#include <device.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Flash Translation Layer
+ * @defgroup flash_ftl Flash Translation Layer
+ * @ingroup file_system
+ * @{
+ */
+
+/** Size of a logical sector in bytes */
+#define FLASH_FTL_SECTOR_SIZE 512
+
+/**
+ * @brief Flash translation layer statistics
+ *
+ * @param host_writes Sectors written through flash_ftl_write()
+ * @param gc_writes Sectors copied by garbage collection
+ * @param erases Erase blocks erased
+ * @param sync_collections Collections run in the write path because
+ * no erased block was left
+ * @param flash_writes flash_write() calls issued to the flash driver
+ * @param free_blocks Erased blocks currently ready for writing
+ * @param min_erase_count Lowest erase count of any block
+ * @param max_erase_count Highest erase count of any block
+ */
+struct flash_ftl_stats {
+	uint32_t host_writes;
+	uint32_t gc_writes;
+	uint32_t erases;
+	uint32_t sync_collections;
+	uint32_t flash_writes;
+	uint32_t free_blocks;
+	uint32_t min_erase_count;
+	uint32_t max_erase_count;
+};
+
+/**
+ * @brief Mount the flash translation layer
+ *
+ * Scans the flash area and rebuilds the sector map from the on-flash
+ * block summaries. Blocks that do not carry a valid summary are erased,
+ * so an unformatted area comes up empty. The garbage collection fiber
+ * is started on the first call.
+ *
+ * @param dev Flash device holding the FTL area
+ *
+ * @return 0 on success, negative errno code on fail.
+ */
+int flash_ftl_init(struct device *dev);
+
+/**
+ * @brief Read logical sectors
+ *
+ * Sectors that were never written read back as 0xff.
+ *
+ * @param buf Buffer of count * FLASH_FTL_SECTOR_SIZE bytes
+ * @param sector First logical sector
+ * @param count Number of sectors
+ *
+ * @return 0 on success, negative errno code on fail.
+ */
+int flash_ftl_read(uint8_t *buf, uint32_t sector, uint32_t count);
+
+/**
+ * @brief Write logical sectors
+ *
+ * Data is appended to pre-erased flash and the old copies are left for
+ * garbage collection, so a write only erases synchronously when the
+ * background collector has fallen behind.
+ *
+ * @param buf Buffer of count * FLASH_FTL_SECTOR_SIZE bytes
+ * @param sector First logical sector
+ * @param count Number of sectors
+ *
+ * @return 0 on success, negative errno code on fail.
+ */
+int flash_ftl_write(const uint8_t *buf, uint32_t sector, uint32_t count);
+
+/**
+ * @brief Get the flash translation layer statistics
+ *
+ * @param stats Structure the statistics are copied into
+ */
+void flash_ftl_stats_get(struct flash_ftl_stats *stats);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _FLASH_FTL_H_ */
@@ -33,6 +33,25 @@ extern "C" {
  * @{
  */
 
+/**
+ * @brief Memory pool usage statistics.
+ *
+ * Sizes are expressed in bytes and account for the size of the blocks handed
+ * out, not for the sizes that were requested. The fragmentation of the pool
+ * can be estimated by comparing @a largest_free_block with the total amount
+ * of free memory, i.e. @a total_size minus @a used_size.
+ */
+struct k_mem_pool_stats {
+	/** Size of the memory pool buffer */
+	uint32_t total_size;
+	/** Memory currently held by allocated blocks */
+	uint32_t used_size;
+	/** Highest value @a used_size has reached */
+	uint32_t max_used_size;
+	/** Size of the largest block that can be allocated right away */
+	uint32_t largest_free_block;
+};
+
 /**
  * @brief Return memory pool block.
  *
@@ -61,6 +80,23 @@ extern void task_mem_pool_free(struct k_block *b);
 extern void task_mem_pool_defragment(kmemory_pool_t p);
 
 
+/**
+ * @brief Get memory pool usage statistics.
+ *
+ * This routine retrieves the current usage statistics of memory pool @a p.
+ *
+ * With the default memory pool implementation, free blocks are only merged
+ * back together when the pool is defragmented, so @a largest_free_block
+ * may be smaller than what a defragmentation would make available.
+ *
+ * @param p Memory pool name.
+ * @param stats Pointer to the statistics structure to fill.
+ *
+ * @return N/A
+ */
+extern void task_mem_pool_stats_get(kmemory_pool_t p,
+				    struct k_mem_pool_stats *stats);
+
 /**
  * @brief Allocate memory pool block.
  *
@@ -167,13 +167,12 @@ static inline void task_sleep(int32_t ticks)
  *
  * This routine returns the workload as a number ranging from 0 to 1000.
  *
- * Each unit equals 0.1% of the time the idle task was not scheduled by the
- * microkernel during the period set by sys_workload_time_slice_set().
+ * Each unit equals 0.1% of the time the idle task was not running during the
+ * last one to two periods set by sys_workload_time_slice_set(). Time spent
+ * in tasks, fibers and ISRs all counts as work.
  *
- * IMPORTANT: This workload monitor ignores any time spent servicing ISRs and
- * fibers! Thus, a system with no meaningful task work to do may spend
- * up to 100% of its time servicing ISRs and fibers, yet it will report 0%
- * workload because the microkernel always selects the idle task.
+ * The workload is only computed if CONFIG_WORKLOAD_MONITOR is enabled,
+ * otherwise 0 is returned.
  *
  * @return workload
  */
@@ -87,6 +87,7 @@
 #define __ASSERT(test, fmt, ...)                                   \
 	do {                                                       \
 		if (!(test)) {                                     \
+			printk_panic();                            \
 			printk("ASSERTION FAIL [%s] @ %s:%d:\n\t", \
 			       _STRINGIFY(test),                   \
 			       __FILE__,                           \
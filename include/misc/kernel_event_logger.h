@@ -35,6 +35,15 @@
 extern "C" {
 #endif
 
+/* operations reported by kernel object events */
+#define KERNEL_EVENT_LOGGER_OBJ_SEM_GIVE                        1
+#define KERNEL_EVENT_LOGGER_OBJ_SEM_TAKE                        2
+#define KERNEL_EVENT_LOGGER_OBJ_FIFO_PUT                        3
+#define KERNEL_EVENT_LOGGER_OBJ_FIFO_GET                        4
+#define KERNEL_EVENT_LOGGER_OBJ_MUTEX_LOCK                      5
+#define KERNEL_EVENT_LOGGER_OBJ_MUTEX_UNLOCK                    6
+#define KERNEL_EVENT_LOGGER_OBJ_TIMER_EXPIRE                    7
+
 #ifdef CONFIG_KERNEL_EVENT_LOGGER
 
 #ifdef CONFIG_KERNEL_EVENT_LOGGER_CONTEXT_SWITCH
@@ -55,6 +64,10 @@ extern "C" {
 #define KERNEL_EVENT_LOGGER_TASK_MON_KEVENT_EVENT_ID            0x0006
 #endif
 
+#ifdef CONFIG_KERNEL_EVENT_LOGGER_OBJECTS
+#define KERNEL_EVENT_LOGGER_OBJECT_EVENT_ID                     0x0007
+#endif
+
 #ifndef _ASMLANGUAGE
 
 /**
@@ -224,11 +237,18 @@ static inline int sys_k_must_log_event(int event_type)
 #endif
 }
 
+#ifdef CONFIG_KERNEL_EVENT_LOGGER_STREAM
+void _sys_k_event_stream_put(uint16_t event_id, uint32_t *event_data,
+	uint8_t data_size);
+#endif
+
 /**
  * @brief Sends a event message to the kernel event logger.
  *
  * @details Sends a event message to the kernel event logger
- * and informs that there are messages available.
+ * and informs that there are messages available. With
+ * CONFIG_KERNEL_EVENT_LOGGER_STREAM, the message is written to the
+ * kernel event stream instead.
  *
  * @param event_id   The identification of the event.
  * @param data       Pointer to the data of the message.
@@ -236,8 +256,13 @@ static inline int sys_k_must_log_event(int event_type)
  *
  * @return No return value.
  */
+#ifdef CONFIG_KERNEL_EVENT_LOGGER_STREAM
+#define sys_k_event_logger_put(event_id, data, data_size) \
+	_sys_k_event_stream_put(event_id, data, data_size)
+#else
 #define sys_k_event_logger_put(event_id, data, data_size) \
 	sys_event_logger_put(&sys_k_event_logger, event_id, data, data_size)
+#endif
 
 
 /**
@@ -357,6 +382,18 @@ void _sys_k_event_logger_interrupt(void);
 static inline void _sys_k_event_logger_interrupt(void) {};
 #endif
 
+#ifdef CONFIG_KERNEL_EVENT_LOGGER_OBJECTS
+/**
+ * @brief Log a kernel object operation
+ *
+ * @param op   One of the KERNEL_EVENT_LOGGER_OBJ_* operations.
+ * @param obj  The object operated on.
+ */
+void _sys_k_event_logger_object(uint32_t op, void *obj);
+#else
+static inline void _sys_k_event_logger_object(uint32_t op, void *obj) {};
+#endif
+
 #endif /* _ASMLANGUAGE */
 
 #else /* !CONFIG_KERNEL_EVENT_LOGGER */
@@ -367,6 +404,7 @@ static inline void sys_k_event_logger_put(uint16_t event_id, uint32_t *event_dat
 	uint8_t data_size) {};
 static inline void sys_k_event_logger_put_timed(uint16_t event_id) {};
 static inline void _sys_k_event_logger_enter_sleep(void) {};
+static inline void _sys_k_event_logger_object(uint32_t op, void *obj) {};
 
 #endif /* _ASMLANGUAGE */
 
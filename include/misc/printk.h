@@ -19,6 +19,7 @@
 #define _PRINTK_H_
 
 #include <toolchain.h>
+#include <stdint.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -30,6 +31,8 @@ extern "C" {
  *
  * This routine prints a kernel debugging message to the system console.
  * Output is send immediately, without any mutual exclusion or buffering.
+ * With CONFIG_PRINTK_DEFERRED the message is only captured, and it is output
+ * later by a fiber; see printk_panic().
  *
  * A basic set of conversion specifier characters are supported:
  *   - signed decimal: \%d, \%i
@@ -57,6 +60,55 @@ static inline void printk(const char *fmt, ...)
 }
 #endif
 
+/**
+ * @brief Deferred printk() statistics
+ *
+ * @param deferred Messages captured into the buffer
+ * @param dropped Messages dropped because the buffer was full
+ * @param max_used Highest number of buffer bytes in use
+ */
+struct printk_stats {
+	uint32_t deferred;
+	uint32_t dropped;
+	uint32_t max_used;
+};
+
+#ifdef CONFIG_PRINTK_DEFERRED
+/**
+ *
+ * @brief Switch printk() to synchronous output.
+ *
+ * Outputs all messages still waiting in the deferred printk() buffer from
+ * the calling context, and makes every later printk() call output its
+ * message immediately. Called by the fatal error handlers and failed
+ * assertions, which are not followed by any fiber running.
+ *
+ * @return N/A
+ */
+extern void printk_panic(void);
+
+/**
+ *
+ * @brief Get the deferred printk() statistics.
+ *
+ * @param stats Structure the statistics are copied into.
+ *
+ * @return N/A
+ */
+extern void printk_stats_get(struct printk_stats *stats);
+#else
+static inline void printk_panic(void)
+{
+}
+
+static inline void printk_stats_get(struct printk_stats *stats)
+{
+	stats->deferred = 0;
+	stats->dropped = 0;
+	stats->max_used = 0;
+}
+#endif
+
 #ifdef __cplusplus
 }
 #endif
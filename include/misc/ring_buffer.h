@@ -33,6 +33,13 @@ extern "C" {
  * @brief Ring Buffer APIs
  * @defgroup nanokernel_ringbuffer Ring Bufer
  * @ingroup nanokernel_services
+ *
+ * Ring buffers are lock-free for one producer and one consumer: one
+ * context may put data while another one gets data, e.g. an ISR and a
+ * fiber, without any locking. Use-cases involving several producers or
+ * several consumers must serialize the producers, respectively the
+ * consumers, by either disabling preemption or using a mutex.
+ *
  * @{
  */
 
@@ -49,7 +56,6 @@ struct ring_buf {
 				     */
 	uint32_t size;   /**< Size of buf in 32-bit chunks */
 	uint32_t *buf;	 /**< Memory region for stored entries */
-	uint32_t mask;   /**< Modulo mask if size is a power of 2 */
 #ifdef CONFIG_DEBUG_TRACING_KERNEL_OBJECTS
 	struct ring_buf *__next;
 #endif
@@ -58,8 +64,8 @@ struct ring_buf {
 /**
  * @brief Declare a power-of-two sized ring buffer
  *
- * Use of this macro is preferred over SYS_RING_BUF_DECLARE_SIZE() as it
- * will not need to use expensive modulo operations.
+ * Ring buffers do not use any modulo operation, this macro is equivalent
+ * to SYS_RING_BUF_DECLARE_SIZE(name, 1 << pow).
  *
  * @param name File-scoped name of the ring buffer to declare
  * @param pow Create a buffer of 2^pow 32-bit elements
@@ -68,16 +74,12 @@ struct ring_buf {
 	static uint32_t _ring_buffer_data_##name[1 << (pow)]; \
 	struct ring_buf name = { \
 		.size = (1 << (pow)), \
-		.mask = (1 << (pow)) - 1, \
 		.buf = _ring_buffer_data_##name \
 	};
 
 /**
  * @brief Declare an arbitrary sized ring buffer
  *
- * A ring buffer declared in this way has more flexibility on buffer size
- * but will use more expensive modulo operations to maintain itself.
- *
  * @param name File-scoped name of the ring buffer to declare
  * @param size32 Size of buffer in 32-bit elements
  */
@@ -92,9 +94,6 @@ struct ring_buf {
  * @brief Initialize a ring buffer, in cases where DECLARE_RING_BUF_STATIC
  * isn't used.
  *
- * For optimal performance, use size values that are a power of 2 as they
- * don't require expensive modulo operations when maintaining the buffer.
- *
  * @param buf Ring buffer to initialize
  * @param size Size of the provided buffer in 32-bit chunks
  * @param data Data area for the ring buffer, typically
@@ -108,11 +107,6 @@ static inline void sys_ring_buf_init(struct ring_buf *buf, uint32_t size,
 	buf->dropped_put_count = 0;
 	buf->size = size;
 	buf->buf = data;
-	if (is_power_of_two(size)) {
-		buf->mask = size - 1;
-	} else {
-		buf->mask = 0;
-	}
 
 	SYS_TRACING_OBJ_INIT(sys_ring_buf, buf);
 }
@@ -150,9 +144,8 @@ static inline int sys_ring_buf_space_get(struct ring_buf *buf)
 /**
  * @brief Place an entry into the ring buffer
  *
- * Concurrency control is not implemented, however no synchronization is needed
- * between put() and get() operations as they independently work on the
- * tail and head values, respectively.
+ * No synchronization is needed with sys_ring_buf_get() as they
+ * independently work on the tail and head values, respectively.
  * Any use-cases involving multiple producers will need to synchronize use
  * of this function, by either disabling preemption or using a mutex.
  *
@@ -161,7 +154,7 @@ static inline int sys_ring_buf_space_get(struct ring_buf *buf)
  * @param value Integral data to include, application specific
  * @param data Pointer to a buffer containing data to enqueue
  * @param size32 Size of data buffer, in 32-bit chunks (not bytes)
- * @return 0 on success, -ENOSPC if there isn't sufficient space
+ * @return 0 on success, -EMSGSIZE if there isn't sufficient space
  */
 int sys_ring_buf_put(struct ring_buf *buf, uint16_t type, uint8_t value,
 		     uint32_t *data, uint8_t size32);
@@ -182,6 +175,151 @@ int sys_ring_buf_put(struct ring_buf *buf, uint16_t type, uint8_t value,
 int sys_ring_buf_get(struct ring_buf *buf, uint16_t *type, uint8_t *value,
 		     uint32_t *data, uint8_t *size32);
 
+/**
+ * @brief A structure to represent a byte ring buffer
+ *
+ * Byte ring buffers store a stream of bytes without any framing, e.g. the
+ * characters received or to be sent by a UART. They can hold one byte less
+ * than their size.
+ */
+struct ring_buf8 {
+	uint32_t head;	 /**< Index in buf of the first byte stored */
+	uint32_t tail;	 /**< Index in buf the next byte is stored at */
+	uint32_t size;   /**< Size of buf in bytes */
+	uint8_t *buf;	 /**< Memory region for stored bytes */
+};
+
+/**
+ * @brief Declare a byte ring buffer
+ *
+ * @param name File-scoped name of the ring buffer to declare
+ * @param size8 Size of buffer in bytes
+ */
+#define SYS_RING_BUF8_DECLARE(name, size8) \
+	static uint8_t _ring_buffer_data_##name[size8]; \
+	struct ring_buf8 name = { \
+		.size = size8, \
+		.buf = _ring_buffer_data_##name \
+	};
+
+/**
+ * @brief Initialize a byte ring buffer, in cases where
+ * SYS_RING_BUF8_DECLARE isn't used.
+ *
+ * @param buf Ring buffer to initialize
+ * @param size Size of the provided buffer in bytes
+ * @param data Data area for the ring buffer, typically
+ *	  uint8_t data[size]
+ */
+static inline void sys_ring_buf8_init(struct ring_buf8 *buf, uint32_t size,
+				      uint8_t *data)
+{
+	buf->head = 0;
+	buf->tail = 0;
+	buf->size = size;
+	buf->buf = data;
+}
+
+/**
+ * @brief Determine if a byte ring buffer is empty
+ *
+ * @return nonzero if the buffer is empty
+ */
+static inline int sys_ring_buf8_is_empty(struct ring_buf8 *buf)
+{
+	return (buf->head == buf->tail);
+}
+
+/**
+ * @brief Obtain available space in a byte ring buffer
+ *
+ * @param buf Ring buffer to examine
+ * @return Available space in the buffer in bytes
+ */
+static inline uint32_t sys_ring_buf8_space_get(struct ring_buf8 *buf)
+{
+	uint32_t head = buf->head;
+	uint32_t tail = buf->tail;
+
+	return (tail < head ? 0 : buf->size) + head - tail - 1;
+}
+
+/**
+ * @brief Write bytes into a byte ring buffer
+ *
+ * As many bytes as there is room for are written.
+ *
+ * @param buf Ring buffer to write to
+ * @param data Bytes to write
+ * @param size Number of bytes to write
+ * @return Number of bytes written
+ */
+uint32_t sys_ring_buf8_put(struct ring_buf8 *buf, const uint8_t *data,
+			   uint32_t size);
+
+/**
+ * @brief Read bytes from a byte ring buffer
+ *
+ * @param buf Ring buffer to read from
+ * @param data Buffer to copy the bytes into
+ * @param size Size of the data buffer in bytes
+ * @return Number of bytes read
+ */
+uint32_t sys_ring_buf8_get(struct ring_buf8 *buf, uint8_t *data,
+			   uint32_t size);
+
+/**
+ * @brief Claim room to write bytes directly into a byte ring buffer
+ *
+ * Provides a contiguous area of the ring buffer the producer can fill in
+ * place, e.g. by DMA, before committing it with sys_ring_buf8_put_finish().
+ * The area may be shorter than the free space of the ring buffer when it
+ * wraps around the end of the buffer; claim again after finishing to get
+ * the rest.
+ *
+ * @param buf Ring buffer to write to
+ * @param data Return storage of the address of the area
+ * @param size Maximum size of the area in bytes
+ * @return Size of the area in bytes, 0 if the ring buffer is full
+ */
+uint32_t sys_ring_buf8_put_claim(struct ring_buf8 *buf, uint8_t **data,
+				 uint32_t size);
+
+/**
+ * @brief Commit bytes written in a claimed area
+ *
+ * @param buf Ring buffer written to
+ * @param size Number of bytes written at the start of the claimed area
+ * @return 0 on success, -EINVAL if size exceeds the claimed area
+ */
+int sys_ring_buf8_put_finish(struct ring_buf8 *buf, uint32_t size);
+
+/**
+ * @brief Claim bytes to read directly from a byte ring buffer
+ *
+ * Provides a contiguous area of the ring buffer the consumer can process
+ * in place, e.g. by DMA, before releasing it with
+ * sys_ring_buf8_get_finish(). The area may hold fewer bytes than the ring
+ * buffer when they wrap around the end of the buffer; claim again after
+ * finishing to get the rest.
+ *
+ * @param buf Ring buffer to read from
+ * @param data Return storage of the address of the area
+ * @param size Maximum size of the area in bytes
+ * @return Size of the area in bytes, 0 if the ring buffer is empty
+ */
+uint32_t sys_ring_buf8_get_claim(struct ring_buf8 *buf, uint8_t **data,
+				 uint32_t size);
+
+/**
+ * @brief Release bytes read from a claimed area
+ *
+ * @param buf Ring buffer read from
+ * @param size Number of bytes consumed at the start of the claimed area
+ * @return 0 on success, -EINVAL if size exceeds the claimed area
+ */
+int sys_ring_buf8_get_finish(struct ring_buf8 *buf, uint32_t size);
+
 /**
  * @}
  */
@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) 2016 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file
+ * @brief Per-thread CPU usage accounting
+ */
+
+#ifndef __THREAD_RUNTIME_H__
+#define __THREAD_RUNTIME_H__
+
+#include <nanokernel.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Thread Runtime Statistics
+ * @defgroup thread_runtime Thread Runtime Statistics
+ * @{
+ */
+
+/**
+ * @brief Runtime of one thread over a snapshot window
+ *
+ * @param thread Task or fiber
+ * @param prio Fiber priority, -1 for a task
+ * @param cycles Hardware clock cycles the thread ran during the window
+ */
+struct sys_thread_runtime {
+	nano_thread_id_t thread;
+	int prio;
+	uint32_t cycles;
+};
+
+/**
+ * @brief Runtime snapshot window
+ *
+ * @param window Hardware clock cycles since the previous snapshot
+ * @param isr Cycles spent in interrupt service routines during the window
+ * @param num_threads Number of entries filled in the thread array
+ */
+struct sys_runtime_snapshot {
+	uint32_t window;
+	uint32_t isr;
+	int num_threads;
+};
+
+/**
+ * @brief Take a runtime snapshot
+ *
+ * Reports how many hardware clock cycles every task and fiber, and the
+ * interrupt service routines, ran since the previous snapshot. The counters
+ * of all threads are advanced, including those that do not fit in
+ * @a threads, so there is only one snapshot window in the system.
+ *
+ * Snapshots must be taken more often than the hardware clock counter
+ * wraps around.
+ *
+ * @param snap Window and ISR figures are stored here
+ * @param threads Array the per-thread figures are stored in
+ * @param max Number of entries in @a threads
+ *
+ * @return Number of entries stored in @a threads
+ */
+extern int sys_runtime_snapshot(struct sys_runtime_snapshot *snap,
+				struct sys_thread_runtime *threads, int max);
+
+/**
+ * @brief Read the total runtime of a thread
+ *
+ * @param thread Task or fiber
+ *
+ * @return Hardware clock cycles the thread ran since it was started
+ */
+extern uint64_t sys_thread_runtime_get(nano_thread_id_t thread);
+
+/**
+ * @brief Read the total time spent in interrupt service routines
+ *
+ * @return Hardware clock cycles spent in ISRs since boot
+ */
+extern uint64_t sys_isr_runtime_get(void);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __THREAD_RUNTIME_H__ */
@@ -70,6 +70,9 @@ struct _nano_timeout {
 	struct _nano_queue *wait_q;
 	int32_t delta_ticks_from_prev;
 	_nano_timeout_func_t func;
+#ifdef CONFIG_NANO_TIMEOUT_WHEEL
+	uint32_t expiry; /* absolute tick at which the timeout expires */
+#endif
 };
 /**
  * @endcond
@@ -214,6 +214,11 @@ struct ip_buf {
  */
 #define ip_buf_appdata(buf) uip_appdata(buf)
 #define ip_buf_appdatalen(buf) uip_appdatalen(buf)
+/* UDP application data can also be linked to the buffer as fragments with
+ * net_buf_frag_add(). It is sent after the data of the buffer and is not
+ * included in ip_buf_appdatalen(), this returns its length.
+ */
+#define ip_buf_frags_len(buf) net_buf_frags_len((buf)->frags)
 #define ip_buf_reserve(buf) (((struct ip_buf *) \
 			      net_buf_user_data((buf)))->reserve)
 
@@ -0,0 +1,67 @@
+/** @file
+ * @brief Internet checksum helpers
+ *
+ * One's complement sum used by the IP, ICMP, UDP and TCP checksums.
+ */
+
+/*
+ * Copyright (c) 2016 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __NET_CHKSUM_H
+#define __NET_CHKSUM_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct net_buf;
+
+/**
+ * @brief Add data to a 16-bit one's complement sum.
+ *
+ * @details The data is summed as a sequence of big endian 16-bit words,
+ * a trailing odd byte being padded with zero. The data does not need to be
+ * aligned.
+ *
+ * @param sum Sum to start from, in host byte order.
+ * @param data Data to add to the sum.
+ * @param len Length of the data in bytes.
+ *
+ * @return Updated sum, in host byte order.
+ */
+uint16_t net_chksum(uint16_t sum, const uint8_t *data, uint16_t len);
+
+/**
+ * @brief Add the data of a buffer and its fragments to a one's complement sum.
+ *
+ * @details The data of the buffer and of all the fragments linked to it is
+ * summed as if it was contiguous, fragments do not need to have an even
+ * length.
+ *
+ * @param sum Sum to start from, in host byte order.
+ * @param buf Buffer to start off with.
+ *
+ * @return Updated sum, in host byte order.
+ */
+uint16_t net_chksum_frags(uint16_t sum, struct net_buf *buf);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __NET_CHKSUM_H */
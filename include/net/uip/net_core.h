@@ -53,6 +53,8 @@ struct net_context;
 
 #include <misc/printk.h>
 #include <string.h>
+#include <stdbool.h>
+#include <misc/slist.h>
 
 #include <net/net_socket.h>
 
@@ -83,6 +85,12 @@ struct net_driver {
 	 *     send() function.
 	 */
 	int (*send)(struct net_buf *buf);
+
+	/** Set if send() handles buffers that have the end of the packet
+	 * in fragments. Otherwise the fragments are copied into the buffer
+	 * before send() is called.
+	 */
+	bool frags;
 };
 
 /**
@@ -142,6 +150,21 @@ int net_reply(struct net_context *context, struct net_buf *buf);
 /* Called by driver when an IP packet has been received */
 int net_recv(struct net_buf *buf);
 
+/**
+ * @brief Pass several received IP packets to the IP stack at once.
+ *
+ * @details Called by a driver that has received a burst of packets. The
+ * buffers are linked through their first word, e.g. with
+ * sys_slist_append(list, (sys_snode_t *)buf), and are queued to the RX
+ * fiber with a single FIFO operation. Empty buffers are released. The list
+ * is invalid afterwards and must be re-initialized with sys_slist_init().
+ *
+ * @param list List of network buffers, ownership passes to the IP stack.
+ *
+ * @return 0 if ok, -ENODATA if there was no packet with data in the list.
+ */
+int net_recv_list(sys_slist_t *list);
+
 void net_context_init(void);
 
 /**
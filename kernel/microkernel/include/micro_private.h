@@ -83,6 +83,7 @@ extern void _k_timeout_cancel(struct k_args *A);
 extern void _k_timer_list_update(int ticks);
 
 extern void _k_do_event_signal(kevent_t event);
+extern void _k_do_event_signal_multiple(kevent_t event, int count);
 
 extern void _k_state_bit_set(struct k_task *, uint32_t);
 extern void _k_state_bit_reset(struct k_task *, uint32_t);
@@ -173,10 +174,7 @@ extern const int _k_monitor_mask;
 #endif
 
 #ifdef CONFIG_WORKLOAD_MONITOR
-extern void _k_workload_monitor_calibrate(void);
 extern void _k_workload_monitor_update(void);
-extern void _k_workload_monitor_idle_start(void);
-extern void _k_workload_monitor_idle_end(void);
 #else
 #define _k_workload_monitor_update()	do { /* nothing */ } while (0)
 #endif
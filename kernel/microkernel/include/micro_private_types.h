@@ -22,6 +22,7 @@
 #include <microkernel/base_api.h>
 #include <nanokernel.h>
 #include <stdbool.h>
+#include <misc/dlist.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -117,6 +118,7 @@ struct k_timer {
 #define _K_SVC_MEM_POOL_BLOCK_GET			_k_mem_pool_block_get
 #define _K_SVC_MEM_POOL_BLOCK_GET_TIMEOUT_HANDLE	_k_mem_pool_block_get_timeout_handle
 #define _K_SVC_MEM_POOL_BLOCK_RELEASE			_k_mem_pool_block_release
+#define _K_SVC_MEM_POOL_STATS_GET			_k_mem_pool_stats_get
 
 #define _K_SVC_PIPE_PUT_REQUEST				_k_pipe_put_request
 #define _K_SVC_PIPE_PUT_TIMEOUT				_k_pipe_put_timeout
@@ -387,6 +389,9 @@ struct pool_block_set {
 	int nr_of_entries;
 	struct pool_quad_block *quad_block;
 	int count;
+#ifdef CONFIG_MEM_POOL_FREE_LISTS
+	sys_dlist_t free_list;
+#endif
 };
 
 struct pool_struct {
@@ -400,6 +405,8 @@ struct pool_struct {
 #ifdef CONFIG_DEBUG_TRACING_KERNEL_OBJECTS
 	struct pool_struct *__next;
 #endif
+	int used_size;
+	int max_used_size;
 };
 
 #ifdef __cplusplus
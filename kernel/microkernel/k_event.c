@@ -24,6 +24,7 @@
 #include <toolchain.h>
 #include <sections.h>
 #include <misc/__assert.h>
+#include <misc/util.h>
 
 extern kevent_t _k_event_list_start[];
 extern kevent_t _k_event_list_end[];
@@ -186,6 +187,38 @@ void _k_do_event_signal(kevent_t event)
 #endif
 }
 
+/**
+ *
+ * @brief Signal an event several times in a row
+ *
+ * Equivalent to calling _k_do_event_signal() @a count times. When no handler
+ * is installed, the event can only be received once per signal while a task
+ * is waiting on it, so signals beyond the second one are no-ops and are
+ * simply accounted for.
+ *
+ * @param event Event to signal
+ * @param count Number of times to signal the event
+ *
+ * @return N/A
+ */
+void _k_do_event_signal_multiple(kevent_t event, int count)
+{
+	struct _k_event_struct *E = (struct _k_event_struct *)event;
+	int signals = count;
+
+	if (E->func == NULL) {
+		signals = min(count, 2);
+	}
+
+#ifdef CONFIG_OBJECT_MONITOR
+	E->count += count - signals;
+#endif
+
+	while (signals-- > 0) {
+		_k_do_event_signal(event);
+	}
+}
+
 /**
  *
  * @brief Perform signal an event request
@@ -30,6 +30,48 @@
 #include <toolchain.h>
 #include <sections.h>
 
+/**
+ *
+ * @brief Copy an element into the FIFO buffer
+ *
+ * The caller is responsible for updating the number of used elements.
+ *
+ * @return N/A
+ */
+static void fifo_element_put(struct _k_fifo_struct *Q, char *data)
+{
+	int w = OCTET_TO_SIZEOFUNIT(Q->element_size);
+	char *p = Q->enqueue_point;
+
+	memcpy(p, data, w);
+	p = (char *)((int)p + w);
+	if (p == Q->end_point)
+		Q->enqueue_point = Q->base;
+	else
+		Q->enqueue_point = p;
+}
+
+/**
+ *
+ * @brief Copy an element out of the FIFO buffer
+ *
+ * The caller is responsible for updating the number of used elements.
+ *
+ * @return N/A
+ */
+static void fifo_element_get(struct _k_fifo_struct *Q, char *data)
+{
+	int w = OCTET_TO_SIZEOFUNIT(Q->element_size);
+	char *q = Q->dequeue_point;
+
+	memcpy(data, q, w);
+	q = (char *)((int)q + w);
+	if (q == Q->end_point)
+		Q->dequeue_point = Q->base;
+	else
+		Q->dequeue_point = q;
+}
+
 /**
  *
  * @brief Finish performing an incomplete FIFO enqueue request
@@ -107,13 +149,7 @@ void _k_fifo_enque_request(struct k_args *A)
 		}
 #endif
 		else {
-			p = Q->enqueue_point;
-			memcpy(p, q, w);
-			p = (char *)((int)p + w);
-			if (p == Q->end_point)
-				Q->enqueue_point = Q->base;
-			else
-				Q->enqueue_point = p;
+			fifo_element_put(Q, q);
 			Q->num_used = ++n;
 #ifdef CONFIG_OBJECT_MONITOR
 			if (Q->high_watermark < n)
@@ -149,6 +185,30 @@ int task_fifo_put(kfifo_t queue, void *data, int32_t timeout)
 {
 	struct k_args A;
 
+#ifdef CONFIG_MICROKERNEL_FAST_PATH
+	struct _k_fifo_struct *Q = (struct _k_fifo_struct *)queue;
+	unsigned int key = irq_lock();
+
+	if (Q->num_used < Q->Nelms && Q->waiters == NULL) {
+		/* room left and no reader waiting: bypass the server */
+		fifo_element_put(Q, data);
+		Q->num_used++;
+#ifdef CONFIG_OBJECT_MONITOR
+		if (Q->high_watermark < Q->num_used)
+			Q->high_watermark = Q->num_used;
+		Q->count++;
+#endif
+		irq_unlock(key);
+		return RC_OK;
+	}
+
+	if (Q->num_used == Q->Nelms && timeout == TICKS_NONE) {
+		irq_unlock(key);
+		return RC_FAIL;
+	}
+	irq_unlock(key);
+#endif
+
 	A.Comm = _K_SVC_FIFO_ENQUE_REQUEST;
 	A.Time.ticks = timeout;
 	A.args.q1.data = (char *)data;
@@ -208,36 +268,21 @@ void _k_fifo_deque_request(struct k_args *A)
 {
 	struct k_args *W;
 	struct _k_fifo_struct *Q;
-	int Qid, n, w;
-	char *p, *q; /* idem */
+	int Qid, n;
+	char *p;
 
 	Qid = A->args.q1.queue;
 	Q = (struct _k_fifo_struct *)Qid;
-	w = OCTET_TO_SIZEOFUNIT(Q->element_size);
 	p = A->args.q1.data;
 	n = Q->num_used;
 	if (n) {
-		q = Q->dequeue_point;
-		memcpy(p, q, w);
-		q = (char *)((int)q + w);
-		if (q == Q->end_point)
-			Q->dequeue_point = Q->base;
-		else
-			Q->dequeue_point = q;
+		fifo_element_get(Q, p);
 
 		A->Time.rcode = RC_OK;
 		W = Q->waiters;
 		if (W) {
 			Q->waiters = W->next;
-			p = Q->enqueue_point;
-			q = W->args.q1.data;
-			w = OCTET_TO_SIZEOFUNIT(Q->element_size);
-			memcpy(p, q, w);
-			p = (char *)((int)p + w);
-			if (p == Q->end_point)
-				Q->enqueue_point = Q->base;
-			else
-				Q->enqueue_point = p;
+			fifo_element_put(Q, W->args.q1.data);
 
 #ifdef CONFIG_SYS_CLOCK_EXISTS
 			if (W->Time.timer) {
@@ -280,6 +325,25 @@ int task_fifo_get(kfifo_t queue, void *data, int32_t timeout)
 {
 	struct k_args A;
 
+#ifdef CONFIG_MICROKERNEL_FAST_PATH
+	struct _k_fifo_struct *Q = (struct _k_fifo_struct *)queue;
+	unsigned int key = irq_lock();
+
+	if (Q->num_used && Q->waiters == NULL) {
+		/* data available and no writer waiting: bypass the server */
+		fifo_element_get(Q, data);
+		Q->num_used--;
+		irq_unlock(key);
+		return RC_OK;
+	}
+
+	if (Q->num_used == 0 && timeout == TICKS_NONE) {
+		irq_unlock(key);
+		return RC_FAIL;
+	}
+	irq_unlock(key);
+#endif
+
 	A.Comm = _K_SVC_FIFO_DEQUE_REQUEST;
 	A.Time.ticks = timeout;
 	A.args.q1.data = (char *)data;
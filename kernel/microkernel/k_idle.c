@@ -33,95 +33,32 @@
 
 #if defined(CONFIG_WORKLOAD_MONITOR)
 
-static unsigned int _k_workload_slice = 0x0;
-static unsigned int _k_workload_ticks = 0x0;
-static unsigned int _k_workload_ref_time = 0x0;
-static unsigned int _k_workload_t0 = 0x0;
-static unsigned int _k_workload_t1 = 0x0;
-static volatile unsigned int _k_workload_n0 = 0x0;
-static volatile unsigned int _k_workload_n1 = 0x0;
-static volatile unsigned int _k_workload_i = 0x0;
-static volatile unsigned int _k_workload_i0 = 0x0;
-static volatile unsigned int _k_workload_delta = 0x0;
-static volatile unsigned int _k_workload_start_time = 0x0;
-static volatile unsigned int _k_workload_end_time = 0x0;
-
-#ifdef WL_SCALE
-static extern uint32_t _k_workload_scale;
-#endif
+#include <misc/thread_runtime.h>
 
-/**
- *
- * @brief Shared code between workload calibration and monitoring
- *
- * Perform idle task "dummy work".
- *
- * This routine increments _k_workload_i and checks it against _k_workload_n1.
- * _k_workload_n1 is updated by the system tick handler, and both are kept
- * in close synchronization.
- *
- * @return N/A
- *
- */
-static void workload_loop(void)
-{
-	volatile int x = 87654321;
-	volatile int y = 4;
-
-	/* loop never terminates, except during calibration phase */
-
-	while (++_k_workload_i != _k_workload_n1) {
-		unsigned int s_iCountDummyProc = 0;
-
-		while (64 != s_iCountDummyProc++) { /* 64 == 2^6 */
-			x >>= y;
-			x <<= y;
-			y++;
-			x >>= y;
-			x <<= y;
-			y--;
-		}
-	}
-}
+extern struct k_task _k_task_idle;
 
-/**
- *
- * @brief Calibrate the workload monitoring subsystem
- *
- * Measures the time required to do a fixed amount of "dummy work", and
- * sets default values for the workload measuring period.
- *
- * @return N/A
- *
- */
-void _k_workload_monitor_calibrate(void)
-{
-	_k_workload_n0 = _k_workload_i = 0;
-	_k_workload_n1 = 1000;
-
-	_k_workload_t0 = sys_cycle_get_32();
-	workload_loop();
-	_k_workload_t1 = sys_cycle_get_32();
-
-	_k_workload_delta = _k_workload_t1 - _k_workload_t0;
-	_k_workload_i0 = _k_workload_i;
-#ifdef WL_SCALE
-	_k_workload_ref_time =
-		(_k_workload_t1 - _k_workload_t0) >> (_k_workload_scale);
-#else
-	_k_workload_ref_time = (_k_workload_t1 - _k_workload_t0) >> (4 + 6);
-#endif
+static unsigned int _k_workload_slice = 100;
+static unsigned int _k_workload_ticks = 100;
+
+/* start of the previous measuring period, and of the current one */
+static uint32_t _k_workload_t0;
+static uint32_t _k_workload_t1;
+static uint64_t _k_workload_idle0;
+static uint64_t _k_workload_idle1;
 
-	_k_workload_slice = 100;
-	_k_workload_ticks = 100;
+static inline uint64_t idle_runtime_get(void)
+{
+	return sys_thread_runtime_get((nano_thread_id_t)_k_task_idle.workspace);
 }
 
 /**
  *
  * @brief Workload monitor tick handler
  *
- * If workload monitor is configured this routine updates the global variables
- * it uses to record the passage of time.
+ * Starts a new measuring period every time the period set by
+ * sys_workload_time_slice_set() has elapsed. The workload is computed over
+ * the previous and the current period, so that it is never based on only
+ * a few ticks.
  *
  * @return N/A
  *
@@ -130,68 +67,31 @@ void _k_workload_monitor_update(void)
 {
 	if (--_k_workload_ticks == 0) {
 		_k_workload_t0 = _k_workload_t1;
+		_k_workload_idle0 = _k_workload_idle1;
 		_k_workload_t1 = sys_cycle_get_32();
-		_k_workload_n0 = _k_workload_n1;
-		_k_workload_n1 = _k_workload_i - 1;
+		_k_workload_idle1 = idle_runtime_get();
 		_k_workload_ticks = _k_workload_slice;
 	}
 }
 
-/**
- *
- * @brief Workload monitor "start idling" handler
- *
- * Records time when idle task was selected for execution by the microkernel.
- *
- * @return N/A
- */
-void _k_workload_monitor_idle_start(void)
-{
-	_k_workload_start_time = sys_cycle_get_32();
-}
-
-/**
- *
- * @brief Workload monitor "end idling" handler
- *
- * Records time when idle task was no longer selected for execution by the
- * microkernel, and updates amount of time spent idling.
- *
- * @return N/A
- */
-void _k_workload_monitor_idle_end(void)
-{
-	_k_workload_end_time = sys_cycle_get_32();
-	_k_workload_i += (_k_workload_i0 *
-		(_k_workload_end_time - _k_workload_start_time)) / _k_workload_delta;
-}
-
 /**
  *
  * @brief Process request to read the processor workload
  *
- * Computes workload, or uses 0 if workload monitoring is not configured.
+ * Computes workload from the cycles the idle task ran, or uses 0 if workload
+ * monitoring is not configured.
  *
  * @return N/A
  */
 void _k_workload_get(struct k_args *P)
 {
-	unsigned int k, t;
+	uint32_t idle, t;
 	signed int iret;
 
-	k = (_k_workload_i - _k_workload_n0) * _k_workload_ref_time;
-#ifdef WL_SCALE
-	t = (sys_cycle_get_32() - _k_workload_t0) >> (_k_workload_scale);
-#else
-	t = (sys_cycle_get_32() - _k_workload_t0) >> (4 + 6);
-#endif
-
-	iret = MSEC_PER_SEC - k / t;
+	idle = (uint32_t)(idle_runtime_get() - _k_workload_idle0);
+	t = (sys_cycle_get_32() - _k_workload_t0) / MSEC_PER_SEC;
 
-	/*
-	 * Due to calibration at startup, <iret> could be slightly negative.
-	 * Ensure a negative value is never returned.
-	 */
+	iret = MSEC_PER_SEC - idle / max(t, 1);
 
 	if (iret < 0) {
 		iret = 0;
@@ -233,8 +133,6 @@ void sys_workload_time_slice_set(int32_t t)
 #endif
 }
 
-unsigned char _sys_power_save_flag = 1;
-
 #if defined(CONFIG_SYS_POWER_MANAGEMENT)
 
 #include <nanokernel.h>
@@ -376,74 +274,31 @@ static inline int32_t _get_next_timer_expiry(void)
 
 /**
  *
- * @brief Power saving when idle
+ * @brief Microkernel idle task
  *
- * If _sys_power_save_flag is non-zero, this routine keeps the system in a low
- * power state whenever the kernel is idle. If it is zero, this routine will
- * fall through and _k_kernel_idle() will try the next idling mechanism.
+ * Keeps the system in a low power state whenever the kernel is idle. The
+ * time spent here is accounted to the idle task like to any other thread,
+ * which is what the workload monitor is based on.
  *
  * @return N/A
  *
  */
-static void _power_save(void)
+int _k_kernel_idle(void)
 {
-	if (_sys_power_save_flag) {
-		for (;;) {
-			irq_lock();
+	for (;;) {
+		irq_lock();
 #ifdef CONFIG_SYS_POWER_MANAGEMENT
-			_sys_power_save_idle(_get_next_timer_expiry());
+		_sys_power_save_idle(_get_next_timer_expiry());
 #else
-			/*
-			 * nano_cpu_idle() is invoked here directly only if APM
-			 * is disabled. Otherwise the microkernel decides
-			 * either to invoke it or to implement advanced idle
-			 * functionality
-			 */
-
-			nano_cpu_idle();
-#endif
-		}
-
 		/*
-		 * Code analyzers may complain that _power_save() uses an
-		 * infinite loop unless we indicate that this is intentional
+		 * nano_cpu_idle() is invoked here directly only if APM
+		 * is disabled. Otherwise the microkernel decides
+		 * either to invoke it or to implement advanced idle
+		 * functionality
 		 */
 
-		CODE_UNREACHABLE;
-	}
-}
-
-/* Specify what work to do when idle task is "busy waiting" */
-
-#ifdef CONFIG_WORKLOAD_MONITOR
-#define DO_IDLE_WORK()	workload_loop()
-#else
-#define DO_IDLE_WORK()	do { /* do nothing */ } while (0)
-#endif
-
-/**
- *
- * @brief Microkernel idle task
- *
- * If power save is on, we sleep; if power save is off, we "busy wait".
- *
- * @return N/A
- *
- */
-int _k_kernel_idle(void)
-{
-	_power_save(); /* never returns if power saving is enabled */
-
-#ifdef CONFIG_BOOT_TIME_MEASUREMENT
-	/* record timestamp when idling begins */
-
-	extern uint64_t __idle_tsc;
-
-	__idle_tsc = _NanoTscRead();
+		nano_cpu_idle();
 #endif
-
-	for (;;) {
-		DO_IDLE_WORK();
 	}
 
 	/*
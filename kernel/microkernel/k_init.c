@@ -112,10 +112,6 @@ void _main(void)
 #endif
 
 
-#ifdef CONFIG_WORKLOAD_MONITOR
-	_k_workload_monitor_calibrate();
-#endif
-
 	task_group_start(EXE_GROUP);
 
 	_k_kernel_idle();
@@ -19,6 +19,225 @@
 #include <toolchain.h>
 #include <sections.h>
 
+/**
+ *
+ * @brief Determines which block set corresponds to the specified data size
+ *
+ * Finds the block set with the smallest blocks that can hold the specified
+ * amount of data.
+ *
+ * @return block set index
+ */
+static int compute_block_set_index(struct pool_struct *P, int data_size)
+{
+	int block_size = P->minblock_size;
+	int offset = P->nr_of_block_sets - 1;
+
+	while (data_size > block_size) {
+		block_size = block_size << 2;
+		offset--;
+	}
+
+	return offset;
+}
+
+#ifdef CONFIG_MEM_POOL_FREE_LISTS
+
+/*
+ * Each block set keeps a list of its free blocks, whose nodes are stored in
+ * the free blocks themselves. The quad-block array of a block set is used as
+ * a bitmap indexed by block number: bit j of entry i is set when block
+ * (4 * i + j) of the block set is on the free list. Allocating a block that
+ * is not available splits a larger one into quarters, and the quarters are
+ * merged back together when the last of them is freed.
+ */
+
+/**
+ *
+ * @brief Initialize kernel memory pool subsystem
+ *
+ * Puts all the maximum size blocks of each memory pool on their free list.
+ *
+ * @return N/A
+ */
+void _k_mem_pool_init(void)
+{
+	struct pool_struct *P;
+	char *memptr;
+	int i, j;
+
+	for (i = 0, P = _k_mem_pool_list; i < _k_mem_pool_count; i++, P++) {
+
+		__ASSERT(P->minblock_size >= sizeof(sys_dnode_t),
+			 "Memory pool blocks too small for free lists\n");
+
+		for (j = 0; j < P->nr_of_block_sets; j++) {
+			sys_dlist_init(&P->block_set[j].free_list);
+		}
+
+		memptr = P->bufblock;
+		for (j = 0; j < P->nr_of_maxblocks; j++) {
+			sys_dlist_append(&P->block_set[0].free_list,
+					 (sys_dnode_t *)memptr);
+			P->block_set[0].quad_block[j >> 2].mem_status |=
+				1 << (j & 3);
+			memptr += OCTET_TO_SIZEOFUNIT(P->block_set[0].block_size);
+		}
+	}
+}
+
+/**
+ *
+ * @brief Compute the number of a block within its block set
+ *
+ * Block sizes are not necessarily exact multiples of each other, so the
+ * number is computed by descending through the block sets the same way
+ * the block was split.
+ *
+ * @param P memory pool descriptor
+ * @param ptr pointer to start of block
+ * @param index block set identifier
+ *
+ * @return block number
+ */
+static int block_number_get(struct pool_struct *P, char *ptr, int index)
+{
+	int offset = ptr - P->bufblock;
+	int number = 0;
+	int block_size;
+	int n, i;
+
+	for (i = 0; i <= index; i++) {
+		block_size = OCTET_TO_SIZEOFUNIT(P->block_set[i].block_size);
+		n = offset / block_size;
+		number = (number << 2) + n;
+		offset -= n * block_size;
+	}
+
+	return number;
+}
+
+/**
+ *
+ * @brief Allocate a block, splitting a larger block if necessary
+ *
+ * @param P memory pool descriptor
+ * @param index index of block set to allocate from
+ *
+ * @return pointer to allocated block, or NULL if none available
+ */
+static char *block_alloc(struct pool_struct *P, int index)
+{
+	struct pool_block_set *set;
+	char *block;
+	int number;
+	int i, j;
+
+	/* find the smallest free block that is large enough */
+
+	for (i = index; i >= 0; i--) {
+		if (!sys_dlist_is_empty(&P->block_set[i].free_list)) {
+			break;
+		}
+	}
+
+	if (i < 0) {
+		return NULL;
+	}
+
+	set = &P->block_set[i];
+	block = (char *)sys_dlist_get(&set->free_list);
+	number = block_number_get(P, block, i);
+	set->quad_block[number >> 2].mem_status &= ~(1 << (number & 3));
+
+	/* split it down to the requested size, freeing the other quarters */
+
+	while (i < index) {
+		set = &P->block_set[++i];
+		number <<= 2;
+
+		for (j = 3; j > 0; j--) {
+			sys_dlist_prepend(&set->free_list, (sys_dnode_t *)(block +
+				j * OCTET_TO_SIZEOFUNIT(set->block_size)));
+		}
+		set->quad_block[number >> 2].mem_status = 0xE;
+	}
+
+#ifdef CONFIG_OBJECT_MONITOR
+	set->count++;
+#endif
+	return block;
+}
+
+/**
+ *
+ * @brief Return an allocated block, merging it with its free siblings
+ *
+ * @param P memory pool descriptor
+ * @param ptr pointer to start of block
+ * @param index block set identifier
+ *
+ * @return N/A
+ */
+static void block_free(struct pool_struct *P, char *ptr, int index)
+{
+	struct pool_block_set *set;
+	uint32_t *status;
+	int number = block_number_get(P, ptr, index);
+	int j;
+
+	while (1) {
+		set = &P->block_set[index];
+		status = &set->quad_block[number >> 2].mem_status;
+
+		__ASSERT(!(*status & (1 << (number & 3))),
+			 "Attempt to free unallocated memory pool block\n");
+		*status |= 1 << (number & 3);
+
+		if (index == 0 || *status != 0xF) {
+			sys_dlist_prepend(&set->free_list, (sys_dnode_t *)ptr);
+			return;
+		}
+
+		/* all four quarters are free: give back the parent block */
+
+		ptr -= (number & 3) * OCTET_TO_SIZEOFUNIT(set->block_size);
+		for (j = 0; j < 4; j++) {
+			if (j != (number & 3)) {
+				sys_dlist_remove((sys_dnode_t *)(ptr +
+					j * OCTET_TO_SIZEOFUNIT(set->block_size)));
+			}
+		}
+		*status = 0;
+
+		number >>= 2;
+		index--;
+	}
+}
+
+/**
+ *
+ * @brief Find the size of the largest free block of a memory pool
+ *
+ * @param P memory pool descriptor
+ *
+ * @return block size, or 0 if the pool is exhausted
+ */
+static int largest_free_block_get(struct pool_struct *P)
+{
+	int i;
+
+	for (i = 0; i < P->nr_of_block_sets; i++) {
+		if (!sys_dlist_is_empty(&P->block_set[i].free_list)) {
+			return P->block_set[i].block_size;
+		}
+	}
+
+	return 0;
+}
+
+#else
+
 /* Auto-Defrag settings */
 
 #define AD_NONE 0
@@ -77,28 +296,6 @@ void _k_mem_pool_init(void)
 	}
 }
 
-/**
- *
- * @brief Determines which block set corresponds to the specified data size
- *
- * Finds the block set with the smallest blocks that can hold the specified
- * amount of data.
- *
- * @return block set index
- */
-static int compute_block_set_index(struct pool_struct *P, int data_size)
-{
-	int block_size = P->minblock_size;
-	int offset = P->nr_of_block_sets - 1;
-
-	while (data_size > block_size) {
-		block_size = block_size << 2;
-		offset--;
-	}
-
-	return offset;
-}
-
 /**
  *
  * @brief Return an allocated block to its block set
@@ -140,6 +337,7 @@ static void free_existing_block(char *ptr, struct pool_struct *P, int index)
 }
 
 
+
 /**
  *
  * @brief Defragment the specified memory pool block sets
@@ -218,47 +416,6 @@ static void defrag(struct pool_struct *P,
 	}
 }
 
-/**
- *
- * @brief Perform defragment memory pool request
- *
- * @return N/A
- */
-void _k_defrag(struct k_args *A)
-{
-	struct pool_struct *P = _k_mem_pool_list + OBJ_INDEX(A->args.p1.pool_id);
-
-	/* do complete defragmentation of memory pool (i.e. all block sets) */
-
-	defrag(P, P->nr_of_block_sets - 1, 0);
-
-	/* reschedule anybody waiting for a block */
-
-	if (P->waiters) {
-		struct k_args *NewGet;
-
-		/*
-		 * create a command packet to re-try block allocation
-		 * for the waiting tasks, and add it to the command stack
-		 */
-
-		GETARGS(NewGet);
-		*NewGet = *A;
-		NewGet->Comm = _K_SVC_BLOCK_WAITERS_GET;
-		TO_ALIST(&_k_command_stack, NewGet);
-	}
-}
-
-
-void task_mem_pool_defragment(kmemory_pool_t Pid)
-{
-	struct k_args A;
-
-	A.Comm = _K_SVC_DEFRAG;
-	A.args.p1.pool_id = Pid;
-	KERNEL_ENTRY(&A);
-}
-
 /**
  *
  * @brief Allocate block from an existing block set
@@ -413,6 +570,153 @@ static char *get_block_recursive(struct pool_struct *P,
 	return NULL; /* can't find (or create) desired block */
 }
 
+/**
+ *
+ * @brief Allocate a block from a block set
+ *
+ * @param P memory pool descriptor
+ * @param index index of block set to allocate from
+ *
+ * @return pointer to allocated block, or NULL if none available
+ */
+static char *block_alloc(struct pool_struct *P, int index)
+{
+	return get_block_recursive(P, index, index);
+}
+
+/**
+ *
+ * @brief Free a block, leaving its merging to defragmentation
+ *
+ * @param P memory pool descriptor
+ * @param ptr pointer to start of block
+ * @param index block set identifier
+ *
+ * @return N/A
+ */
+static void block_free(struct pool_struct *P, char *ptr, int index)
+{
+	free_existing_block(ptr, P, index);
+}
+
+/**
+ *
+ * @brief Find the size of the largest free block of a memory pool
+ *
+ * Free blocks that defragmentation would merge are not taken into account.
+ *
+ * @param P memory pool descriptor
+ *
+ * @return block size, or 0 if the pool is exhausted
+ */
+static int largest_free_block_get(struct pool_struct *P)
+{
+	struct pool_quad_block *quad_block;
+	int i, j;
+
+	for (i = 0; i < P->nr_of_block_sets; i++) {
+		quad_block = P->block_set[i].quad_block;
+		for (j = 0; j < P->block_set[i].nr_of_entries; j++) {
+			if (quad_block[j].mem_blocks == NULL) {
+				break;
+			}
+			if (quad_block[j].mem_status != 0) {
+				return P->block_set[i].block_size;
+			}
+		}
+	}
+
+	return 0;
+}
+
+#endif /* CONFIG_MEM_POOL_FREE_LISTS */
+
+/**
+ *
+ * @brief Allocate a block and update the pool usage statistics
+ *
+ * @param P memory pool descriptor
+ * @param index index of block set to allocate from
+ *
+ * @return pointer to allocated block, or NULL if none available
+ */
+static char *pool_block_alloc(struct pool_struct *P, int index)
+{
+	char *block = block_alloc(P, index);
+
+	if (block != NULL) {
+		P->used_size += P->block_set[index].block_size;
+		if (P->used_size > P->max_used_size) {
+			P->max_used_size = P->used_size;
+		}
+	}
+
+	return block;
+}
+
+/**
+ *
+ * @brief Free a block and update the pool usage statistics
+ *
+ * @param P memory pool descriptor
+ * @param ptr pointer to start of block
+ * @param index block set identifier
+ *
+ * @return N/A
+ */
+static void pool_block_free(struct pool_struct *P, char *ptr, int index)
+{
+	block_free(P, ptr, index);
+	P->used_size -= P->block_set[index].block_size;
+}
+
+/**
+ *
+ * @brief Perform defragment memory pool request
+ *
+ * @return N/A
+ */
+void _k_defrag(struct k_args *A)
+{
+#ifdef CONFIG_MEM_POOL_FREE_LISTS
+	/* free blocks are merged as soon as they are released */
+
+	ARG_UNUSED(A);
+#else
+	struct pool_struct *P = _k_mem_pool_list + OBJ_INDEX(A->args.p1.pool_id);
+
+	/* do complete defragmentation of memory pool (i.e. all block sets) */
+
+	defrag(P, P->nr_of_block_sets - 1, 0);
+
+	/* reschedule anybody waiting for a block */
+
+	if (P->waiters) {
+		struct k_args *NewGet;
+
+		/*
+		 * create a command packet to re-try block allocation
+		 * for the waiting tasks, and add it to the command stack
+		 */
+
+		GETARGS(NewGet);
+		*NewGet = *A;
+		NewGet->Comm = _K_SVC_BLOCK_WAITERS_GET;
+		TO_ALIST(&_k_command_stack, NewGet);
+	}
+#endif
+}
+
+
+void task_mem_pool_defragment(kmemory_pool_t Pid)
+{
+	struct k_args A;
+
+	A.Comm = _K_SVC_DEFRAG;
+	A.args.p1.pool_id = Pid;
+	KERNEL_ENTRY(&A);
+}
+
 /**
  *
  * @brief Examine tasks that are waiting for memory pool blocks
@@ -443,8 +747,7 @@ void _k_block_waiters_get(struct k_args *A)
 			P, curr_task->args.p1.req_size);
 
 		/* allocate block (fragmenting a larger block, if needed) */
-		found_block = get_block_recursive(
-			P, offset, offset);
+		found_block = pool_block_alloc(P, offset);
 
 		/* if success : remove task from list and reschedule */
 		if (found_block != NULL) {
@@ -511,7 +814,7 @@ void _k_mem_pool_block_get(struct k_args *A)
 
 	/* allocate block (fragmenting a larger block, if needed) */
 
-	found_block = get_block_recursive(P, offset, offset);
+	found_block = pool_block_alloc(P, offset);
 
 	if (found_block != NULL) {
 		A->args.p1.rep_poolptr = found_block;
@@ -671,7 +974,7 @@ void _k_mem_pool_block_release(struct k_args *A)
 
 	/* mark the block as unused */
 
-	free_existing_block(A->args.p1.rep_poolptr, P, offset);
+	pool_block_free(P, A->args.p1.rep_poolptr, offset);
 
 	/* reschedule anybody waiting for a block */
 
@@ -728,3 +1031,31 @@ void task_free(void *ptr)
 
 	KERNEL_ENTRY(&A);
 }
+
+/**
+ *
+ * @brief Perform memory pool statistics request
+ *
+ * @return N/A
+ */
+void _k_mem_pool_stats_get(struct k_args *A)
+{
+	struct pool_struct *P = _k_mem_pool_list + OBJ_INDEX(A->args.p1.pool_id);
+	struct k_mem_pool_stats *stats = A->args.p1.rep_dataptr;
+
+	stats->total_size = P->maxblock_size * P->nr_of_maxblocks;
+	stats->used_size = P->used_size;
+	stats->max_used_size = P->max_used_size;
+	stats->largest_free_block = largest_free_block_get(P);
+}
+
+void task_mem_pool_stats_get(kmemory_pool_t pool_id,
+			     struct k_mem_pool_stats *stats)
+{
+	struct k_args A;
+
+	A.Comm = _K_SVC_MEM_POOL_STATS_GET;
+	A.args.p1.pool_id = pool_id;
+	A.args.p1.rep_dataptr = stats;
+	KERNEL_ENTRY(&A);
+}
@@ -42,6 +42,7 @@
 #include <microkernel.h>
 #include <micro_private.h>
 #include <nano_private.h>
+#include <misc/kernel_event_logger.h>
 
 /**
  * @brief Reply to a mutex lock request.
@@ -265,6 +266,39 @@ int task_mutex_lock(kmutex_t mutex, int32_t timeout)
 {
 	struct k_args A; /* argument packet */
 
+	_sys_k_event_logger_object(KERNEL_EVENT_LOGGER_OBJ_MUTEX_LOCK,
+				   (void *)mutex);
+
+#ifdef CONFIG_MICROKERNEL_FAST_PATH
+	struct _k_mutex_struct *Mutex = (struct _k_mutex_struct *)mutex;
+	unsigned int key = irq_lock();
+
+	if (Mutex->level == 0 || Mutex->owner == _k_current_task->id) {
+		/* unowned or nested lock: no need to involve the server */
+#ifdef CONFIG_OBJECT_MONITOR
+		Mutex->count++;
+#endif
+		Mutex->owner = _k_current_task->id;
+		Mutex->current_owner_priority = _k_current_task->priority;
+		if (Mutex->level == 0) {
+			Mutex->original_owner_priority =
+				Mutex->current_owner_priority;
+		}
+		Mutex->level++;
+		irq_unlock(key);
+		return RC_OK;
+	}
+
+	if (timeout == TICKS_NONE) {
+#ifdef CONFIG_OBJECT_MONITOR
+		Mutex->num_conflicts++;
+#endif
+		irq_unlock(key);
+		return RC_FAIL;
+	}
+	irq_unlock(key);
+#endif
+
 	A.Comm = _K_SVC_MUTEX_LOCK_REQUEST;
 	A.Time.ticks = timeout;
 	A.args.l1.mutex = mutex;
@@ -377,6 +411,40 @@ void _task_mutex_unlock(kmutex_t mutex)
 {
 	struct k_args A; /* argument packet */
 
+	_sys_k_event_logger_object(KERNEL_EVENT_LOGGER_OBJ_MUTEX_UNLOCK,
+				   (void *)mutex);
+
+#ifdef CONFIG_MICROKERNEL_FAST_PATH
+	struct _k_mutex_struct *Mutex = (struct _k_mutex_struct *)mutex;
+	unsigned int key = irq_lock();
+
+	if (Mutex->owner == _k_current_task->id) {
+		if (Mutex->level > 1) {
+			/* nested unlock: nothing else to do */
+			Mutex->level--;
+			irq_unlock(key);
+			return;
+		}
+
+		if (Mutex->waiters == NULL &&
+		    Mutex->current_owner_priority ==
+		    Mutex->original_owner_priority) {
+			/*
+			 * Final unlock with no waiter to hand the mutex over
+			 * to and no priority to restore.
+			 */
+#ifdef CONFIG_OBJECT_MONITOR
+			Mutex->count++;
+#endif
+			Mutex->owner = ANYTASK;
+			Mutex->level = 0;
+			irq_unlock(key);
+			return;
+		}
+	}
+	irq_unlock(key);
+#endif
+
 	A.Comm = _K_SVC_MUTEX_UNLOCK;
 	A.args.l1.mutex = mutex;
 	A.args.l1.task = _k_current_task->id;
@@ -25,6 +25,7 @@
 #include <sections.h>
 
 #include <micro_private.h>
+#include <misc/kernel_event_logger.h>
 
 /**
  *
@@ -353,6 +354,26 @@ int task_sem_take(ksem_t sema, int32_t timeout)
 {
 	struct k_args A;
 
+	_sys_k_event_logger_object(KERNEL_EVENT_LOGGER_OBJ_SEM_TAKE,
+				   (void *)sema);
+
+#ifdef CONFIG_MICROKERNEL_FAST_PATH
+	struct _k_sem_struct *S = (struct _k_sem_struct *)sema;
+	unsigned int key = irq_lock();
+
+	if (S->level) {
+		/* semaphore available: no need to involve the server */
+		S->level--;
+		irq_unlock(key);
+		return RC_OK;
+	}
+	irq_unlock(key);
+
+	if (timeout == TICKS_NONE) {
+		return RC_FAIL;
+	}
+#endif
+
 	A.Comm = _K_SVC_SEM_WAIT_REQUEST;
 	A.Time.ticks = timeout;
 	A.args.s1.sema = sema;
@@ -393,6 +414,25 @@ void task_sem_give(ksem_t sema)
 {
 	struct k_args A;
 
+	_sys_k_event_logger_object(KERNEL_EVENT_LOGGER_OBJ_SEM_GIVE,
+				   (void *)sema);
+
+#ifdef CONFIG_MICROKERNEL_FAST_PATH
+	struct _k_sem_struct *S = (struct _k_sem_struct *)sema;
+	unsigned int key = irq_lock();
+
+	if (S->waiters == NULL) {
+		/* nobody to wake up: no need to involve the server */
+#ifdef CONFIG_OBJECT_MONITOR
+		S->count++;
+#endif
+		S->level++;
+		irq_unlock(key);
+		return;
+	}
+	irq_unlock(key);
+#endif
+
 	A.Comm = _K_SVC_SEM_SIGNAL;
 	A.args.s1.sema = sema;
 	KERNEL_ENTRY(&A);
@@ -411,6 +451,9 @@ FUNC_ALIAS(isr_sem_give, fiber_sem_give, void);
 
 void isr_sem_give(ksem_t sema)
 {
+	_sys_k_event_logger_object(KERNEL_EVENT_LOGGER_OBJ_SEM_GIVE,
+				   (void *)sema);
+
 	_COMMAND_STACK_SIZE_CHECK();
 
 	nano_isr_stack_push(&_k_command_stack,
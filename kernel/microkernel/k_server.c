@@ -70,6 +70,89 @@ static struct k_task *next_task_select(void)
 	return _k_task_priority_list[K_PrioListIdx].head;
 }
 
+/**
+ *
+ * @brief Count and discard later copies of a command in a batch
+ *
+ * Semaphore gives and event signals are encoded in the command word itself,
+ * so identical words designate the same operation on the same object and can
+ * be merged. Merged entries are cleared, which is never a valid command.
+ *
+ * @param batch Commands pulled from the command stack
+ * @param first Index of the command to look for
+ * @param num Number of commands in the batch
+ *
+ * @return number of occurrences of the command, from index @a first onwards
+ */
+static int batch_coalesce(uint32_t *batch, int first, int num)
+{
+	int count = 1;
+	int i;
+
+	for (i = first + 1; i < num; i++) {
+		if (batch[i] == batch[first]) {
+			batch[i] = 0;
+			count++;
+		}
+	}
+
+	return count;
+}
+
+/**
+ *
+ * @brief Execute a single command
+ *
+ * @param cmd Command word popped from the command stack
+ * @param count Number of times the command is to be executed; only
+ *        meaningful for semaphore and event commands
+ *
+ * @return N/A
+ */
+static void command_process(uint32_t cmd, int count)
+{
+	int cmd_type = (int)cmd & KERNEL_CMD_TYPE_MASK;
+
+	if (cmd_type == KERNEL_CMD_PACKET_TYPE) {
+		struct k_args *pArgs = (struct k_args *)cmd;
+
+		/* process command packet */
+
+#ifdef CONFIG_TASK_MONITOR
+		if (_k_monitor_mask & MON_KSERV) {
+			_k_task_monitor_args(pArgs);
+		}
+#endif
+		(*pArgs->Comm)(pArgs);
+	} else if (cmd_type == KERNEL_CMD_EVENT_TYPE) {
+
+		/* give event */
+
+#ifdef CONFIG_TASK_MONITOR
+		if (_k_monitor_mask & MON_EVENT) {
+			_k_task_monitor_args((struct k_args *)cmd);
+		}
+#endif
+		kevent_t event = (int)cmd & ~KERNEL_CMD_TYPE_MASK;
+
+		if (count == 1) {
+			_k_do_event_signal(event);
+		} else {
+			_k_do_event_signal_multiple(event, count);
+		}
+	} else { /* cmd_type == KERNEL_CMD_SEMAPHORE_TYPE */
+
+		/* give semaphore */
+
+#ifdef CONFIG_TASK_MONITOR
+		/* task monitoring for giving semaphore not implemented */
+#endif
+		ksem_t sem = (int)cmd & ~KERNEL_CMD_TYPE_MASK;
+
+		_k_sem_struct_value_update(count, (struct _k_sem_struct *)sem);
+	}
+}
+
 /**
  *
  * @brief The microkernel thread entry point
@@ -79,12 +162,20 @@ static struct k_task *next_task_select(void)
  * stack and then sets up the next task that is ready to run. Next it
  * goes to wait on further inputs on the command stack.
  *
+ * Commands are pulled from the stack in batches of up to
+ * CONFIG_MICROKERNEL_SERVER_BATCH_SIZE entries. Repeated semaphore gives and
+ * event signals within a batch are executed as a single operation, and
+ * other fibers are given a chance to run after each batch rather than after
+ * each command.
+ *
  * @return Does not return.
  */
 FUNC_NORETURN void _k_server(int unused1, int unused2)
 {
-	struct k_args *pArgs;
+	uint32_t batch[CONFIG_MICROKERNEL_SERVER_BATCH_SIZE];
 	struct k_task *pNextTask;
+	int num;
+	int i;
 
 	ARG_UNUSED(unused1);
 	ARG_UNUSED(unused2);
@@ -95,43 +186,30 @@ FUNC_NORETURN void _k_server(int unused1, int unused2)
 	_thread_essential_set();
 
 	while (1) { /* forever */
-		(void) nano_fiber_stack_pop(&_k_command_stack, (uint32_t *)&pArgs,
+		(void) nano_fiber_stack_pop(&_k_command_stack, &batch[0],
 				TICKS_UNLIMITED); /* will schedule */
 		do {
-			int cmd_type = (int)pArgs & KERNEL_CMD_TYPE_MASK;
-
-			if (cmd_type == KERNEL_CMD_PACKET_TYPE) {
+			num = 1;
+			while (num < CONFIG_MICROKERNEL_SERVER_BATCH_SIZE &&
+			       nano_fiber_stack_pop(&_k_command_stack,
+						    &batch[num], TICKS_NONE)) {
+				num++;
+			}
 
-				/* process command packet */
+			for (i = 0; i < num; i++) {
+				int count = 1;
 
-#ifdef CONFIG_TASK_MONITOR
-				if (_k_monitor_mask & MON_KSERV) {
-					_k_task_monitor_args(pArgs);
+				if (batch[i] == 0) {
+					/* already merged into an earlier entry */
+					continue;
 				}
-#endif
-				(*pArgs->Comm)(pArgs);
-			} else if (cmd_type == KERNEL_CMD_EVENT_TYPE) {
-
-				/* give event */
 
-#ifdef CONFIG_TASK_MONITOR
-				if (_k_monitor_mask & MON_EVENT) {
-					_k_task_monitor_args(pArgs);
+				if ((batch[i] & KERNEL_CMD_TYPE_MASK) !=
+				    KERNEL_CMD_PACKET_TYPE) {
+					count = batch_coalesce(batch, i, num);
 				}
-#endif
-				kevent_t event = (int)pArgs & ~KERNEL_CMD_TYPE_MASK;
-
-				_k_do_event_signal(event);
-			} else { /* cmd_type == KERNEL_CMD_SEMAPHORE_TYPE */
 
-				/* give semaphore */
-
-#ifdef CONFIG_TASK_MONITOR
-				/* task monitoring for giving semaphore not implemented */
-#endif
-				ksem_t sem = (int)pArgs & ~KERNEL_CMD_TYPE_MASK;
-
-				_k_sem_struct_value_update(1, (struct _k_sem_struct *)sem);
+				command_process(batch[i], count);
 			}
 
 			/*
@@ -142,7 +220,7 @@ FUNC_NORETURN void _k_server(int unused1, int unused2)
 			if (_nanokernel.fiber) {
 				fiber_yield();
 			}
-		} while (nano_fiber_stack_pop(&_k_command_stack, (uint32_t *)&pArgs,
+		} while (nano_fiber_stack_pop(&_k_command_stack, &batch[0],
 					TICKS_NONE));
 
 		pNextTask = next_task_select();
@@ -154,14 +232,6 @@ FUNC_NORETURN void _k_server(int unused1, int unused2)
 			 * one
 			 */
 
-#ifdef CONFIG_WORKLOAD_MONITOR
-			if (pNextTask->id == 0x00000000) {
-				_k_workload_monitor_idle_start();
-			} else if (_k_current_task->id == 0x00000000) {
-				_k_workload_monitor_idle_end();
-			}
-#endif
-
 			_k_current_task = pNextTask;
 			_nanokernel.task = (struct tcs *)pNextTask->workspace;
 
@@ -24,6 +24,7 @@
 #include <micro_private.h>
 #include <drivers/system_timer.h>
 #include <misc/debug/object_tracing_common.h>
+#include <misc/kernel_event_logger.h>
 
 extern struct k_timer _k_timer_blocks[];
 
@@ -167,6 +168,9 @@ void _k_timer_list_update(int ticks)
 		}
 
 		T = _k_timer_list_head;
+		_sys_k_event_logger_object(KERNEL_EVENT_LOGGER_OBJ_TIMER_EXPIRE,
+					   T);
+
 		if (T == _k_timer_list_tail) {
 			_k_timer_list_head = _k_timer_list_tail = NULL;
 		} else {
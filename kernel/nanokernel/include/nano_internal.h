@@ -90,6 +90,20 @@ extern void _thread_exit(struct tcs *tcs);
 	} while (0)
 #endif /* CONFIG_THREAD_MONITOR */
 
+/* reset the runtime counters of a new thread */
+
+#if defined(CONFIG_THREAD_RUNTIME_STATS)
+#define _thread_runtime_init(tcs)         \
+	do {                              \
+		(tcs)->runtime = 0;       \
+		(tcs)->runtime_snap = 0;  \
+	} while (0)
+#else
+#define _thread_runtime_init(tcs) \
+	do {/* nothing */    \
+	} while (0)
+#endif /* CONFIG_THREAD_RUNTIME_STATS */
+
 /* special nanokernel object APIs */
 
 struct nano_lifo;
@@ -95,7 +95,8 @@ static inline void _nano_timeout_add(struct tcs *tcs,
 #endif /* CONFIG_NANO_TIMEOUTS */
 
 
-void _nano_timeout_handle_timeouts(void);
+void _nano_timeout_handle_timeouts(int32_t ticks);
+int32_t _nano_timeout_ticks_remain(struct _nano_timeout *t);
 
 static inline int _nano_timer_timeout_abort(struct _nano_timeout *t)
 {
@@ -40,10 +40,25 @@ static inline void _nano_wait_q_init(struct _nano_queue *wait_q)
 
 struct tcs *_nano_wait_q_remove(struct _nano_queue *wait_q);
 
+/*
+ * With timeouts, a thread can leave the middle of a wait queue: each waiting
+ * thread then records its predecessor so that it can be unlinked in constant
+ * time. The predecessor of the first thread is the wait queue itself, which
+ * works since 'link' is the first field of struct tcs.
+ */
+#if defined(CONFIG_NANO_TIMEOUTS)
+	#define _NANO_WAIT_Q_PREV_SET(tcs, prev) ((tcs)->wait_q_prev = (prev))
+#else
+	#define _NANO_WAIT_Q_PREV_SET(tcs, prev) do { } while ((0))
+#endif
+
 /* put current fiber on specified wait queue */
 static inline void _nano_wait_q_put(struct _nano_queue *wait_q)
 {
-	((struct tcs *)wait_q->tail)->link = _nanokernel.current;
+	struct tcs *tail = wait_q->tail;
+
+	tail->link = _nanokernel.current;
+	_NANO_WAIT_Q_PREV_SET(_nanokernel.current, tail);
 	wait_q->tail = _nanokernel.current;
 }
 
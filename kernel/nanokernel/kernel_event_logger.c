@@ -26,7 +26,9 @@
 #include <nano_private.h>
 #include <kernel_event_logger_arch.h>
 
+#ifndef CONFIG_KERNEL_EVENT_LOGGER_STREAM
 uint32_t _sys_k_event_logger_buffer[CONFIG_KERNEL_EVENT_LOGGER_BUFFER_SIZE];
+#endif
 
 #ifdef CONFIG_KERNEL_EVENT_LOGGER_CONTEXT_SWITCH
 void *_collector_fiber;
@@ -40,6 +42,19 @@ uint32_t _sys_k_event_logger_sleep_start_time;
 int _sys_k_event_logger_mask;
 #endif
 
+#ifdef CONFIG_KERNEL_EVENT_LOGGER_STREAM
+/* the event stream is ready as soon as the system starts */
+static inline int _sys_k_event_logger_ready(void)
+{
+	return 1;
+}
+#else
+/* events can only be logged once the ring buffer has been initialized */
+static inline int _sys_k_event_logger_ready(void)
+{
+	return sys_k_event_logger.ring_buf.buf != NULL;
+}
+
 /**
  * @brief Initialize the kernel event logger system.
  *
@@ -58,6 +73,7 @@ static int _sys_k_event_logger_init(struct device *arg)
 }
 SYS_INIT(_sys_k_event_logger_init,
 		NANOKERNEL, CONFIG_KERNEL_INIT_PRIORITY_DEFAULT);
+#endif /* CONFIG_KERNEL_EVENT_LOGGER_STREAM */
 
 #ifdef CONFIG_KERNEL_EVENT_LOGGER_CUSTOM_TIMESTAMP
 sys_k_timer_func timer_func;
@@ -73,8 +89,7 @@ void sys_k_event_logger_put_timed(uint16_t event_id)
 
 	data[0] = _sys_k_get_time();
 
-	sys_event_logger_put(&sys_k_event_logger, event_id, data,
-		ARRAY_SIZE(data));
+	sys_k_event_logger_put(event_id, data, ARRAY_SIZE(data));
 }
 
 #ifdef CONFIG_KERNEL_EVENT_LOGGER_CONTEXT_SWITCH
@@ -94,7 +109,7 @@ void _sys_k_event_logger_context_switch(void)
 	}
 
 	/* if the kernel event logger has not been initialized, we do nothing */
-	if (sys_k_event_logger.ring_buf.buf == NULL) {
+	if (!_sys_k_event_logger_ready()) {
 		return;
 	}
 
@@ -102,6 +117,11 @@ void _sys_k_event_logger_context_switch(void)
 		data[0] = _sys_k_get_time();
 		data[1] = (uint32_t)_nanokernel.current;
 
+#ifdef CONFIG_KERNEL_EVENT_LOGGER_STREAM
+		/* streaming never signals a semaphore, nor switches context */
+		sys_k_event_logger_put(KERNEL_EVENT_LOGGER_CONTEXT_SWITCH_EVENT_ID,
+			data, ARRAY_SIZE(data));
+#else
 		/*
 		 * The mechanism we use to log the kernel events uses a sync semaphore
 		 * to inform that there are available events to be collected. The
@@ -122,6 +142,7 @@ void _sys_k_event_logger_context_switch(void)
 		_sys_event_logger_put_non_preemptible(&sys_k_event_logger,
 			KERNEL_EVENT_LOGGER_CONTEXT_SWITCH_EVENT_ID, data,
 			ARRAY_SIZE(data));
+#endif
 	}
 }
 
@@ -142,7 +163,7 @@ void _sys_k_event_logger_interrupt(void)
 	}
 
 	/* if the kernel event logger has not been initialized, we do nothing */
-	if (sys_k_event_logger.ring_buf.buf == NULL) {
+	if (!_sys_k_event_logger_ready()) {
 		return;
 	}
 
@@ -192,3 +213,23 @@ void _sys_k_event_logger_exit_sleep(void)
 	}
 }
 #endif /* CONFIG_KERNEL_EVENT_LOGGER_SLEEP */
+
+
+#ifdef CONFIG_KERNEL_EVENT_LOGGER_OBJECTS
+void _sys_k_event_logger_object(uint32_t op, void *obj)
+{
+	uint32_t data[4];
+
+	if (!sys_k_must_log_event(KERNEL_EVENT_LOGGER_OBJECT_EVENT_ID)) {
+		return;
+	}
+
+	data[0] = _sys_k_get_time();
+	data[1] = op;
+	data[2] = (uint32_t)obj;
+	data[3] = (uint32_t)_nanokernel.current;
+
+	sys_k_event_logger_put(KERNEL_EVENT_LOGGER_OBJECT_EVENT_ID, data,
+		ARRAY_SIZE(data));
+}
+#endif /* CONFIG_KERNEL_EVENT_LOGGER_OBJECTS */
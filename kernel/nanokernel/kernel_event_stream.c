@@ -0,0 +1,253 @@
+/*
+ * Copyright (c) 2016 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file
+ * @brief Kernel event stream
+ *
+ * Kernel events are encoded as they are logged, in a compact binary format
+ * that scripts/decode_kernel_events.py turns into a timeline. All fields are
+ * in the byte order of the target.
+ *
+ * The stream starts with a 12-byte header:
+ *
+ *	uint32_t magic       0xc1fc1fc1
+ *	uint8_t  version     1
+ *	uint8_t  backend     0: UART, 1: RAM
+ *	uint16_t reserved
+ *	uint32_t frequency   of the event timestamps in Hz, 0 if unknown
+ *
+ * followed by one record per event:
+ *
+ *	uint8_t  event_id
+ *	uint8_t  data_size   in 32-bit words
+ *	uint32_t data[data_size]
+ *
+ * The RAM backend keeps the latest records in a ring, whose state follows
+ * the header:
+ *
+ *	uint32_t size        of the ring in bytes
+ *	uint32_t head        offset the next record is written at
+ *	uint32_t tail        offset of the oldest record
+ *	uint32_t dropped     number of records overwritten so far
+ *	uint8_t  ring[size]
+ *
+ * A record never wraps around the end of the ring: a padding byte is
+ * written instead and the record starts over at the beginning of the ring.
+ */
+
+#include <misc/kernel_event_logger.h>
+#include <misc/util.h>
+#include <string.h>
+#include <init.h>
+#include <sys_clock.h>
+#ifdef CONFIG_KERNEL_EVENT_LOGGER_STREAM_UART
+#include <uart.h>
+#include <errno.h>
+#endif
+
+#define STREAM_MAGIC         0xc1fc1fc1
+#define STREAM_VERSION       1
+#define STREAM_BACKEND_UART  0
+#define STREAM_BACKEND_RAM   1
+
+/* event ID of the padding byte, never used by actual events */
+#define STREAM_PAD           0xff
+
+#define RECORD_HEADER_SIZE   2
+
+struct stream_header {
+	uint32_t magic;
+	uint8_t version;
+	uint8_t backend;
+	uint16_t reserved;
+	uint32_t frequency;
+};
+
+static void stream_header_init(struct stream_header *header, uint8_t backend)
+{
+	header->magic = STREAM_MAGIC;
+	header->version = STREAM_VERSION;
+	header->backend = backend;
+	header->reserved = 0;
+#ifdef CONFIG_KERNEL_EVENT_LOGGER_CUSTOM_TIMESTAMP
+	/* the custom timer frequency is not known */
+	header->frequency = 0;
+#else
+	header->frequency = sys_clock_hw_cycles_per_sec;
+#endif
+}
+
+#ifdef CONFIG_KERNEL_EVENT_LOGGER_STREAM_RAM
+
+#define RING_SIZE CONFIG_KERNEL_EVENT_LOGGER_STREAM_RAM_SIZE
+
+struct stream_ram {
+	struct stream_header header;
+	uint32_t size;
+	uint32_t head;
+	uint32_t tail;
+	uint32_t dropped;
+	uint8_t ring[RING_SIZE];
+};
+
+/*
+ * Left in the BSS so that it does not take any room in the image: events
+ * logged before the stream initialization are kept nonetheless, only the
+ * header is filled in later.
+ */
+struct stream_ram _sys_k_event_stream;
+
+static inline uint32_t ring_space(struct stream_ram *s)
+{
+	return (s->tail > s->head ? 0 : RING_SIZE) + s->tail - s->head - 1;
+}
+
+static void ring_drop_oldest(struct stream_ram *s)
+{
+	uint8_t *record = &s->ring[s->tail];
+
+	if (record[0] == STREAM_PAD) {
+		s->tail = 0;
+		return;
+	}
+
+	s->tail += RECORD_HEADER_SIZE + record[1] * sizeof(uint32_t);
+	if (s->tail == RING_SIZE) {
+		s->tail = 0;
+	}
+
+	s->dropped++;
+}
+
+static void stream_write(uint8_t event_id, uint32_t *data, uint8_t data_size)
+{
+	struct stream_ram *s = &_sys_k_event_stream;
+	uint32_t len = RECORD_HEADER_SIZE + data_size * sizeof(uint32_t);
+	uint32_t needed = len;
+	int wrap;
+
+	/* this guarantees there is always room once the ring is empty */
+	if (len > RING_SIZE / 2) {
+		s->dropped++;
+		return;
+	}
+
+	wrap = (s->head + len > RING_SIZE);
+	if (wrap) {
+		needed += RING_SIZE - s->head;
+	}
+
+	while (ring_space(s) < needed) {
+		ring_drop_oldest(s);
+	}
+
+	if (wrap) {
+		s->ring[s->head] = STREAM_PAD;
+		s->head = 0;
+	}
+
+	s->ring[s->head] = event_id;
+	s->ring[s->head + 1] = data_size;
+	memcpy(&s->ring[s->head + RECORD_HEADER_SIZE], data,
+	       data_size * sizeof(uint32_t));
+
+	s->head += len;
+	if (s->head == RING_SIZE) {
+		s->head = 0;
+	}
+}
+
+static int _sys_k_event_stream_init(struct device *arg)
+{
+	ARG_UNUSED(arg);
+
+	_sys_k_event_stream.size = RING_SIZE;
+	stream_header_init(&_sys_k_event_stream.header, STREAM_BACKEND_RAM);
+
+	return 0;
+}
+
+#else /* CONFIG_KERNEL_EVENT_LOGGER_STREAM_UART */
+
+static struct device *stream_dev;
+
+static void stream_out(const void *buf, size_t len)
+{
+	const uint8_t *p = buf;
+
+	while (len--) {
+		uart_poll_out(stream_dev, *p++);
+	}
+}
+
+static void stream_write(uint8_t event_id, uint32_t *data, uint8_t data_size)
+{
+	uint8_t header[RECORD_HEADER_SIZE] = { event_id, data_size };
+
+	/* events logged before the UART is found are lost */
+	if (!stream_dev) {
+		return;
+	}
+
+	stream_out(header, sizeof(header));
+	stream_out(data, data_size * sizeof(uint32_t));
+}
+
+static int _sys_k_event_stream_init(struct device *arg)
+{
+	struct device *dev;
+	struct stream_header header;
+	unsigned int key;
+
+	ARG_UNUSED(arg);
+
+	dev = device_get_binding(
+		CONFIG_KERNEL_EVENT_LOGGER_STREAM_UART_ON_DEV_NAME);
+	if (!dev) {
+		return -ENODEV;
+	}
+
+	stream_header_init(&header, STREAM_BACKEND_UART);
+
+	/* no event may get in before the header */
+	key = irq_lock();
+	stream_dev = dev;
+	stream_out(&header, sizeof(header));
+	irq_unlock(key);
+
+	return 0;
+}
+
+#endif /* CONFIG_KERNEL_EVENT_LOGGER_STREAM_RAM */
+
+SYS_INIT(_sys_k_event_stream_init,
+		NANOKERNEL, CONFIG_KERNEL_INIT_PRIORITY_DEFAULT);
+
+void _sys_k_event_stream_put(uint16_t event_id, uint32_t *event_data,
+	uint8_t data_size)
+{
+	unsigned int key;
+
+	if (event_id >= STREAM_PAD) {
+		return;
+	}
+
+	/* records must not interleave when an interrupt logs an event */
+	key = irq_lock();
+	stream_write(event_id, event_data, data_size);
+	irq_unlock(key);
+}
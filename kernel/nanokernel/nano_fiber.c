@@ -27,6 +27,87 @@
 #include <string.h>
 #include <toolchain.h>
 #include <sections.h>
+#include <misc/util.h>
+
+#ifdef CONFIG_NANO_FIBER_READY_BITMAP
+
+#define READY_LEVELS 32
+
+/*
+ * The runnable fibers still form a single list in priority order, since
+ * the context switch code takes the next fiber from its head. In addition,
+ * the last fiber of each priority level is recorded, and a bitmap tells
+ * which levels have runnable fibers, so that a fiber can be linked after
+ * the last fiber of its own level, or of the nearest higher priority level,
+ * without walking the list.
+ *
+ * Fibers only leave the list at its head. Levels of numerically lower
+ * priority than the head fiber are thus empty, and any other level marked
+ * in the bitmap still ends with the fiber recorded for it, so the bitmap
+ * only needs to be brought up to date before each insertion.
+ */
+static uint32_t _ready_bitmap;
+static struct tcs *_ready_tail[READY_LEVELS];
+
+static inline unsigned int _ready_level(int prio)
+{
+	return min((unsigned int)prio, READY_LEVELS - 1);
+}
+
+/**
+ *
+ * @brief Add a fiber to the list of runnable fibers
+ *
+ * The list of runnable fibers is maintained via a single linked list
+ * in priority order. Numerically lower priorities represent higher priority
+ * fibers. The fiber is linked after the last fiber of the same or the
+ * nearest higher priority, in constant time.
+ *
+ * Interrupts must already be locked to ensure list cannot change
+ * while this routine is executing!
+ *
+ * @return N/A
+ */
+void _nano_fiber_ready(struct tcs *tcs)
+{
+	unsigned int level = _ready_level(tcs->prio);
+	struct tcs *pQ = (struct tcs *)&_nanokernel.fiber;
+	uint32_t higher;
+
+	if (_nanokernel.fiber) {
+		higher = BIT(_ready_level(_nanokernel.fiber->prio)) - 1;
+		_ready_bitmap &= ~higher;
+	} else {
+		_ready_bitmap = 0;
+	}
+
+	higher = _ready_bitmap & (BIT(level) - 1);
+
+	if (level < READY_LEVELS - 1) {
+		if (_ready_bitmap & BIT(level)) {
+			pQ = _ready_tail[level];
+		} else if (higher) {
+			pQ = _ready_tail[find_msb_set(higher) - 1];
+		}
+
+		_ready_bitmap |= BIT(level);
+		_ready_tail[level] = tcs;
+	} else {
+		if (higher) {
+			pQ = _ready_tail[find_msb_set(higher) - 1];
+		}
+
+		/* the last level is shared, keep it sorted */
+		while (pQ->link && (tcs->prio >= pQ->link->prio)) {
+			pQ = pQ->link;
+		}
+	}
+
+	tcs->link = pQ->link;
+	pQ->link = tcs;
+}
+
+#else
 
 /**
  *
@@ -60,6 +141,7 @@ void _nano_fiber_ready(struct tcs *tcs)
 	pQ->link = tcs;
 }
 
+#endif /* CONFIG_NANO_FIBER_READY_BITMAP */
 
 /* currently the fiber and task implementations are identical */
 
@@ -40,6 +40,7 @@
 #include <sections.h>
 #include <wait_q.h>
 #include <misc/__assert.h>
+#include <misc/kernel_event_logger.h>
 
 struct fifo_node {
 	void *next;
@@ -128,6 +129,8 @@ void _fifo_put_non_preemptible(struct nano_fifo *fifo, void *data)
 	struct tcs *tcs;
 	unsigned int key;
 
+	_sys_k_event_logger_object(KERNEL_EVENT_LOGGER_OBJ_FIFO_PUT, fifo);
+
 	key = irq_lock();
 
 	tcs = _nano_wait_q_remove(&fifo->wait_q);
@@ -147,6 +150,8 @@ void nano_task_fifo_put(struct nano_fifo *fifo, void *data)
 	struct tcs *tcs;
 	unsigned int key;
 
+	_sys_k_event_logger_object(KERNEL_EVENT_LOGGER_OBJ_FIFO_PUT, fifo);
+
 	key = irq_lock();
 	tcs = _nano_wait_q_remove(&fifo->wait_q);
 	if (tcs) {
@@ -187,6 +192,8 @@ void _fifo_put_list_non_preemptible(struct nano_fifo *fifo,
 {
 	__ASSERT(head && tail, "invalid head or tail");
 
+	_sys_k_event_logger_object(KERNEL_EVENT_LOGGER_OBJ_FIFO_PUT, fifo);
+
 	unsigned int key = irq_lock();
 	struct tcs *fiber;
 
@@ -223,6 +230,8 @@ void nano_task_fifo_put_list(struct nano_fifo *fifo, void *head, void *tail)
 	__ASSERT(head && tail, "invalid head or tail");
 	__ASSERT(*(void **)tail == NULL, "list is not NULL-terminated");
 
+	_sys_k_event_logger_object(KERNEL_EVENT_LOGGER_OBJ_FIFO_PUT, fifo);
+
 	unsigned int key = irq_lock();
 	struct tcs *fiber, *first_fiber;
 
@@ -300,6 +309,8 @@ void *_fifo_get(struct nano_fifo *fifo, int32_t timeout_in_ticks)
 	unsigned int key;
 	void *data = NULL;
 
+	_sys_k_event_logger_object(KERNEL_EVENT_LOGGER_OBJ_FIFO_GET, fifo);
+
 	key = irq_lock();
 
 	if (likely(!is_q_empty(&fifo->data_q))) {
@@ -321,6 +332,8 @@ void *nano_task_fifo_get(struct nano_fifo *fifo, int32_t timeout_in_ticks)
 	int64_t limit = 0x7fffffffffffffffll;
 	unsigned int key;
 
+	_sys_k_event_logger_object(KERNEL_EVENT_LOGGER_OBJ_FIFO_GET, fifo);
+
 	key = irq_lock();
 	cur_ticks = _NANO_TIMEOUT_TICK_GET();
 	if (timeout_in_ticks != TICKS_UNLIMITED) {
@@ -87,7 +87,13 @@ char __noinit __stack main_task_stack[CONFIG_MAIN_STACK_SIZE];
 #endif
 char __noinit __stack _interrupt_stack[CONFIG_ISR_STACK_SIZE];
 
-#if defined(CONFIG_NANO_TIMEOUTS) || defined(CONFIG_NANO_TIMERS)
+#if defined(CONFIG_NANO_TIMEOUT_WHEEL)
+	extern void _nano_timeout_wheel_init(void);
+	#define initialize_nano_timeouts() do { \
+		_nano_timeout_wheel_init(); \
+		_nanokernel.task_timeout = TICKS_UNLIMITED; \
+	} while ((0))
+#elif defined(CONFIG_NANO_TIMEOUTS) || defined(CONFIG_NANO_TIMERS)
 	#include <misc/dlist.h>
 	#define initialize_nano_timeouts() do { \
 		sys_dlist_init(&_nanokernel.timeout_q); \
@@ -45,6 +45,7 @@
 #include <toolchain.h>
 #include <sections.h>
 #include <wait_q.h>
+#include <misc/kernel_event_logger.h>
 
 /**
  * INTERNAL
@@ -81,6 +82,8 @@ void _sem_give_non_preemptible(struct nano_sem *sem)
 	struct tcs *tcs;
 	unsigned int imask;
 
+	_sys_k_event_logger_object(KERNEL_EVENT_LOGGER_OBJ_SEM_GIVE, sem);
+
 	imask = irq_lock();
 	tcs = _nano_wait_q_remove(&sem->wait_q);
 	if (!tcs) {
@@ -99,6 +102,8 @@ void nano_task_sem_give(struct nano_sem *sem)
 	struct tcs *tcs;
 	unsigned int imask;
 
+	_sys_k_event_logger_object(KERNEL_EVENT_LOGGER_OBJ_SEM_GIVE, sem);
+
 	imask = irq_lock();
 	tcs = _nano_wait_q_remove(&sem->wait_q);
 	if (tcs) {
@@ -130,7 +135,11 @@ FUNC_ALIAS(_sem_take, nano_fiber_sem_take, int);
 
 int _sem_take(struct nano_sem *sem, int32_t timeout_in_ticks)
 {
-	unsigned int key = irq_lock();
+	unsigned int key;
+
+	_sys_k_event_logger_object(KERNEL_EVENT_LOGGER_OBJ_SEM_TAKE, sem);
+
+	key = irq_lock();
 
 	if (likely(sem->nsig > 0)) {
 		sem->nsig--;
@@ -159,6 +168,8 @@ int nano_task_sem_take(struct nano_sem *sem, int32_t timeout_in_ticks)
 	int64_t limit = 0x7fffffffffffffffll;
 	unsigned int key;
 
+	_sys_k_event_logger_object(KERNEL_EVENT_LOGGER_OBJ_SEM_TAKE, sem);
+
 	key = irq_lock();
 	cur_ticks = _NANO_TIMEOUT_TICK_GET();
 	if (timeout_in_ticks != TICKS_UNLIMITED) {
@@ -155,14 +155,8 @@ uint32_t sys_tick_delta_32(int64_t *reftime)
 
 static inline void handle_expired_nano_timeouts(int32_t ticks)
 {
-	struct _nano_timeout *head =
-		(struct _nano_timeout *)sys_dlist_peek_head(&_nanokernel.timeout_q);
-
 	_nanokernel.task_timeout = TICKS_UNLIMITED;
-	if (head) {
-		head->delta_ticks_from_prev -= ticks;
-		_nano_timeout_handle_timeouts();
-	}
+	_nano_timeout_handle_timeouts(ticks);
 }
 #else
 	#define handle_expired_nano_timeouts(ticks) do { } while ((0))
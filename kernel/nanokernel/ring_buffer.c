@@ -17,6 +17,31 @@
  */
 
 #include <misc/ring_buffer.h>
+#include <string.h>
+#include <atomic.h>
+
+/*
+ * Lock-free single producer, single consumer operation
+ *
+ * The producer only ever writes the tail index and the consumer the head
+ * index. Each side reads the index of the other side with atomic_get(),
+ * which orders the accesses to the buffer contents that follow it, and
+ * publishes its own index with atomic_set() once it is done with the
+ * buffer contents, which orders the accesses that precede it. The data
+ * stored by the producer is thus visible to the consumer before the new
+ * tail is, and the consumer is done with the data before the producer can
+ * see the room freed by the new head.
+ *
+ * Indexes always stay below the buffer size and advance by at most the
+ * buffer size, so they wrap with a subtraction instead of a modulo.
+ */
+#define INDEX_GET(index)         atomic_get((atomic_t *)&(index))
+#define INDEX_SET(index, value)  atomic_set((atomic_t *)&(index), (value))
+
+static inline uint32_t index_wrap(uint32_t index, uint32_t size)
+{
+	return index >= size ? index - size : index;
+}
 
 /**
  * Internal data structure for a buffer header.
@@ -30,52 +55,69 @@ struct ring_element {
 	uint32_t  value  :8;  /**< Room for small integral values */
 };
 
+static inline uint32_t space_get(uint32_t head, uint32_t tail, uint32_t size)
+{
+	return (tail < head ? 0 : size) + head - tail - 1;
+}
+
+/* copy in or out at most two contiguous spans, the second one at the start */
+static void copy_in(uint32_t *ring, uint32_t size, uint32_t index,
+		    const uint32_t *data, uint32_t size32)
+{
+	uint32_t first = min(size32, size - index);
+
+	memcpy(&ring[index], data, first * sizeof(uint32_t));
+	memcpy(ring, &data[first], (size32 - first) * sizeof(uint32_t));
+}
+
+static void copy_out(const uint32_t *ring, uint32_t size, uint32_t index,
+		     uint32_t *data, uint32_t size32)
+{
+	uint32_t first = min(size32, size - index);
+
+	memcpy(data, &ring[index], first * sizeof(uint32_t));
+	memcpy(&data[first], ring, (size32 - first) * sizeof(uint32_t));
+}
+
 int sys_ring_buf_put(struct ring_buf *buf, uint16_t type, uint8_t value,
 		     uint32_t *data, uint8_t size32)
 {
-	uint32_t i, space, index, rc;
-
-	space = sys_ring_buf_space_get(buf);
-	if (space >= (size32 + 1)) {
-		struct ring_element *header =
-				(struct ring_element *)&buf->buf[buf->tail];
-		header->type = type;
-		header->length = size32;
-		header->value = value;
-
-		if (likely(buf->mask)) {
-			for (i = 0; i < size32; ++i) {
-				index = (i + buf->tail + 1) & buf->mask;
-				buf->buf[index] = data[i];
-			}
-			buf->tail = (buf->tail + size32 + 1) & buf->mask;
-		} else {
-			for (i = 0; i < size32; ++i) {
-				index = (i + buf->tail + 1) % buf->size;
-				buf->buf[index] = data[i];
-			}
-			buf->tail = (buf->tail + size32 + 1) % buf->size;
-		}
-		rc = 0;
-	} else {
+	uint32_t head = INDEX_GET(buf->head);
+	uint32_t tail = buf->tail;
+	struct ring_element *header;
+
+	if (space_get(head, tail, buf->size) < (size32 + 1)) {
 		buf->dropped_put_count++;
-		rc = -EMSGSIZE;
+		return -EMSGSIZE;
 	}
 
-	return rc;
+	header = (struct ring_element *)&buf->buf[tail];
+	header->type = type;
+	header->length = size32;
+	header->value = value;
+
+	tail = index_wrap(tail + 1, buf->size);
+	if (size32) {
+		copy_in(buf->buf, buf->size, tail, data, size32);
+	}
+
+	INDEX_SET(buf->tail, index_wrap(tail + size32, buf->size));
+
+	return 0;
 }
 
 int sys_ring_buf_get(struct ring_buf *buf, uint16_t *type, uint8_t *value,
 		     uint32_t *data, uint8_t *size32)
 {
+	uint32_t tail = INDEX_GET(buf->tail);
+	uint32_t head = buf->head;
 	struct ring_element *header;
-	uint32_t i, index;
 
-	if (sys_ring_buf_is_empty(buf)) {
+	if (head == tail) {
 		return -EAGAIN;
 	}
 
-	header = (struct ring_element *) &buf->buf[buf->head];
+	header = (struct ring_element *) &buf->buf[head];
 
 	if (header->length > *size32) {
 		*size32 = header->length;
@@ -86,20 +128,108 @@ int sys_ring_buf_get(struct ring_buf *buf, uint16_t *type, uint8_t *value,
 	*type = header->type;
 	*value = header->value;
 
-	if (likely(buf->mask)) {
-		for (i = 0; i < header->length; ++i) {
-			index = (i + buf->head + 1) & buf->mask;
-			data[i] = buf->buf[index];
-		}
-		buf->head = (buf->head + header->length + 1) & buf->mask;
-	} else {
-		for (i = 0; i < header->length; ++i) {
-			index = (i + buf->head + 1) % buf->size;
-			data[i] = buf->buf[index];
-		}
-		buf->head = (buf->head + header->length + 1) % buf->size;
+	head = index_wrap(head + 1, buf->size);
+	if (header->length) {
+		copy_out(buf->buf, buf->size, head, data, header->length);
 	}
 
+	INDEX_SET(buf->head, index_wrap(head + *size32, buf->size));
+
 	return 0;
 }
 
+uint32_t sys_ring_buf8_put(struct ring_buf8 *buf, const uint8_t *data,
+			   uint32_t size)
+{
+	uint32_t head = INDEX_GET(buf->head);
+	uint32_t tail = buf->tail;
+	uint32_t first;
+
+	size = min(size, space_get(head, tail, buf->size));
+	first = min(size, buf->size - tail);
+
+	memcpy(&buf->buf[tail], data, first);
+	memcpy(buf->buf, &data[first], size - first);
+
+	INDEX_SET(buf->tail, index_wrap(tail + size, buf->size));
+
+	return size;
+}
+
+uint32_t sys_ring_buf8_get(struct ring_buf8 *buf, uint8_t *data,
+			   uint32_t size)
+{
+	uint32_t tail = INDEX_GET(buf->tail);
+	uint32_t head = buf->head;
+	uint32_t first;
+
+	size = min(size, buf->size - 1 - space_get(head, tail, buf->size));
+	first = min(size, buf->size - head);
+
+	memcpy(data, &buf->buf[head], first);
+	memcpy(&data[first], buf->buf, size - first);
+
+	INDEX_SET(buf->head, index_wrap(head + size, buf->size));
+
+	return size;
+}
+
+/* contiguous room after the tail, one byte short of the head */
+static inline uint32_t put_span(struct ring_buf8 *buf)
+{
+	uint32_t head = INDEX_GET(buf->head);
+	uint32_t tail = buf->tail;
+
+	if (tail < head) {
+		return head - tail - 1;
+	}
+
+	return buf->size - tail - (head == 0 ? 1 : 0);
+}
+
+/* contiguous data after the head, up to the tail or the end of the buffer */
+static inline uint32_t get_span(struct ring_buf8 *buf)
+{
+	uint32_t tail = INDEX_GET(buf->tail);
+	uint32_t head = buf->head;
+
+	return (head <= tail ? tail : buf->size) - head;
+}
+
+uint32_t sys_ring_buf8_put_claim(struct ring_buf8 *buf, uint8_t **data,
+				 uint32_t size)
+{
+	*data = &buf->buf[buf->tail];
+
+	return min(size, put_span(buf));
+}
+
+int sys_ring_buf8_put_finish(struct ring_buf8 *buf, uint32_t size)
+{
+	if (size > put_span(buf)) {
+		return -EINVAL;
+	}
+
+	INDEX_SET(buf->tail, index_wrap(buf->tail + size, buf->size));
+
+	return 0;
+}
+
+uint32_t sys_ring_buf8_get_claim(struct ring_buf8 *buf, uint8_t **data,
+				 uint32_t size)
+{
+	*data = &buf->buf[buf->head];
+
+	return min(size, get_span(buf));
+}
+
+int sys_ring_buf8_get_finish(struct ring_buf8 *buf, uint32_t size)
+{
+	if (size > get_span(buf)) {
+		return -EINVAL;
+	}
+
+	INDEX_SET(buf->head, index_wrap(buf->head + size, buf->size));
+
+	return 0;
+}
@@ -0,0 +1,167 @@
+/*
+ * Copyright (c) 2016 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file
+ * @brief Per-thread CPU usage accounting
+ *
+ * The cycles elapsed since the last accounting point are charged to the
+ * current thread when it is switched out or interrupted, and to the ISR
+ * counter when the outermost interrupt returns. Whatever runs between two
+ * accounting points, including idling, is thus charged to exactly one
+ * owner, without any sampling or calibration.
+ */
+
+#include <nano_private.h>
+#include <drivers/system_timer.h>
+#include <misc/thread_runtime.h>
+
+static uint32_t last_stamp;   /* cycle count at the last accounting point */
+static uint32_t snap_stamp;   /* cycle count at the previous snapshot */
+static unsigned int isr_depth;
+static uint64_t isr_runtime;
+static uint64_t isr_runtime_snap;
+
+static inline uint32_t elapsed(void)
+{
+	uint32_t now = sys_cycle_get_32();
+	int32_t delta = (int32_t)(now - last_stamp);
+
+	/*
+	 * Some timer drivers read one tick behind between the tick interrupt
+	 * and its handler accumulating the count: charge nothing until the
+	 * clock has caught up again.
+	 */
+	if (delta <= 0) {
+		return 0;
+	}
+
+	last_stamp = now;
+
+	return delta;
+}
+
+void _sys_thread_runtime_switch(void)
+{
+	unsigned int key = irq_lock();
+
+	/* _nanokernel.current is still the outgoing thread */
+	_nanokernel.current->runtime += elapsed();
+
+	irq_unlock(key);
+}
+
+void _sys_thread_runtime_isr_enter(void)
+{
+	unsigned int key = irq_lock();
+
+	if (isr_depth++ == 0) {
+		_nanokernel.current->runtime += elapsed();
+	}
+
+	irq_unlock(key);
+}
+
+void _sys_thread_runtime_isr_exit(void)
+{
+	unsigned int key = irq_lock();
+
+	if (--isr_depth == 0) {
+		isr_runtime += elapsed();
+	}
+
+	irq_unlock(key);
+}
+
+void _sys_thread_runtime_clock_sync(void)
+{
+	unsigned int key = irq_lock();
+
+	/* the time the clock lagged belongs to whatever the tick interrupted */
+	if (isr_depth == 1) {
+		_nanokernel.current->runtime += elapsed();
+	} else {
+		isr_runtime += elapsed();
+	}
+
+	irq_unlock(key);
+}
+
+int sys_runtime_snapshot(struct sys_runtime_snapshot *snap,
+			 struct sys_thread_runtime *threads, int max)
+{
+	struct tcs *thread;
+	unsigned int key;
+	int count = 0;
+
+	key = irq_lock();
+
+	/* bring the calling thread up to date */
+	if (isr_depth == 0) {
+		_nanokernel.current->runtime += elapsed();
+	}
+
+	snap->window = last_stamp - snap_stamp;
+	snap_stamp = last_stamp;
+
+	snap->isr = (uint32_t)(isr_runtime - isr_runtime_snap);
+	isr_runtime_snap = isr_runtime;
+
+	for (thread = _nanokernel.threads; thread;
+	     thread = thread->next_thread) {
+		if (count < max) {
+			threads[count].thread = thread;
+			threads[count].prio = thread->prio;
+			threads[count].cycles =
+				(uint32_t)(thread->runtime - thread->runtime_snap);
+			count++;
+		}
+
+		thread->runtime_snap = thread->runtime;
+	}
+
+	irq_unlock(key);
+
+	snap->num_threads = count;
+
+	return count;
+}
+
+uint64_t sys_thread_runtime_get(nano_thread_id_t thread)
+{
+	unsigned int key = irq_lock();
+	uint64_t runtime;
+
+	if (thread == _nanokernel.current && isr_depth == 0) {
+		thread->runtime += elapsed();
+	}
+
+	runtime = thread->runtime;
+
+	irq_unlock(key);
+
+	return runtime;
+}
+
+uint64_t sys_isr_runtime_get(void)
+{
+	unsigned int key = irq_lock();
+	uint64_t runtime = isr_runtime;
+
+	irq_unlock(key);
+
+	return runtime;
+}
@@ -22,28 +22,24 @@
 
 
 #include <wait_q.h>
+#include <misc/kernel_event_logger.h>
 
 #if defined(CONFIG_NANO_TIMEOUTS)
 
 static void _nano_timeout_remove_tcs_from_wait_q(
 	struct tcs *tcs, struct _nano_queue *wait_q)
 {
-	if (wait_q->head == tcs) {
-		if (wait_q->tail == wait_q->head) {
+	struct tcs *prev = tcs->wait_q_prev;
+
+	if (wait_q->tail == tcs) {
+		if (prev == (struct tcs *)&wait_q->head) {
 			_nano_wait_q_reset(wait_q);
 		} else {
-			wait_q->head = tcs->link;
+			wait_q->tail = prev;
 		}
 	} else {
-		struct tcs *prev = wait_q->head;
-
-		while (prev->link != tcs) {
-			prev = prev->link;
-		}
 		prev->link = tcs->link;
-		if (wait_q->tail == tcs) {
-			wait_q->tail = prev;
-		}
+		tcs->link->wait_q_prev = prev;
 	}
 
 	tcs->nano_timeout.wait_q = NULL;
@@ -74,18 +70,20 @@ static void _nano_timeout_object_dequeue(
 #endif /* CONFIG_NANO_TIMEOUTS */
 
 /*
- * Handle one expired timeout.
- * This removes the fiber from the timeout queue head, and also removes it
- * from the wait queue it is on if waiting for an object. In that case, it
- * also sets the return value to 0/NULL.
+ * Handle one expired timeout that has already been taken off the timeout
+ * queue. This also removes the fiber from the wait queue it is on if waiting
+ * for an object. In that case, it also sets the return value to 0/NULL.
  */
 
-static struct _nano_timeout *_nano_timeout_handle_one_timeout(
-	sys_dlist_t *timeout_q)
+static void _nano_timeout_expire(struct _nano_timeout *t)
 {
-	struct _nano_timeout *t = (void *)sys_dlist_get(timeout_q);
 	struct tcs *tcs = t->tcs;
 
+	_sys_k_event_logger_object(KERNEL_EVENT_LOGGER_OBJ_TIMER_EXPIRE, t);
+
+	/* before the callback, which may add the timeout again */
+	t->delta_ticks_from_prev = -1;
+
 	if (tcs != NULL) {
 		_nano_timeout_object_dequeue(tcs, t);
 		if (_IS_MICROKERNEL_TASK(tcs)) {
@@ -96,18 +94,293 @@ static struct _nano_timeout *_nano_timeout_handle_one_timeout(
 	} else if (t->func) {
 		t->func(t);
 	}
+}
+
+#if defined(CONFIG_NANO_TIMEOUT_WHEEL)
+
+/*
+ * Hierarchical timing wheel
+ *
+ * Timeouts are hashed on their absolute expiry tick into one of
+ * WHEEL_LEVELS levels of WHEEL_SLOTS slots. Level 0 holds the timeouts
+ * expiring within the next WHEEL_SLOTS ticks, one slot per tick; each
+ * following level covers WHEEL_SLOTS times the span of the previous one.
+ * Every time a level wraps around, the current slot of the level above is
+ * cascaded down, i.e. its timeouts are re-hashed into the lower levels.
+ *
+ * Adding and aborting a timeout are O(1), and each timeout is cascaded at
+ * most WHEEL_LEVELS - 1 times before expiring. Timeouts farther away than
+ * the span of the whole wheel are parked in the last level and re-hashed
+ * every time they are cascaded.
+ *
+ * delta_ticks_from_prev is not used as a delta in this mode: it is 0 while
+ * a timeout is queued and -1 when it is not, as for the delta list.
+ */
+
+#define WHEEL_LEVELS 4
+#define WHEEL_SLOT_BITS CONFIG_NANO_TIMEOUT_WHEEL_SLOT_BITS
+#define WHEEL_SLOTS (1 << WHEEL_SLOT_BITS)
+#define WHEEL_SLOT_MASK (WHEEL_SLOTS - 1)
+#define WHEEL_MAX_DELTA ((1 << (WHEEL_LEVELS * WHEEL_SLOT_BITS)) - 1)
+
+#define WHEEL_SHIFT(level) ((level) * WHEEL_SLOT_BITS)
+#define WHEEL_INDEX(tick, level) (((tick) >> WHEEL_SHIFT(level)) & WHEEL_SLOT_MASK)
+
+static struct {
+	uint32_t now; /* next tick to be processed */
+	sys_dlist_t slots[WHEEL_LEVELS][WHEEL_SLOTS];
+} wheel;
+
+void _nano_timeout_wheel_init(void)
+{
+	int level;
+	int slot;
+
+	wheel.now = 0;
+	for (level = 0; level < WHEEL_LEVELS; level++) {
+		for (slot = 0; slot < WHEEL_SLOTS; slot++) {
+			sys_dlist_init(&wheel.slots[level][slot]);
+		}
+	}
+}
+
+/* hash a timeout into the wheel slot matching its expiry tick */
+static void _nano_timeout_wheel_insert(struct _nano_timeout *t)
+{
+	uint32_t expiry = t->expiry;
+	int32_t delta = (int32_t)(expiry - wheel.now);
+	int level;
+
+	if (delta < 0) {
+		/* already due: expire it when processing the next tick */
+		expiry = wheel.now;
+		delta = 0;
+	} else if (delta > WHEEL_MAX_DELTA) {
+		/* park it in the last level until it gets closer */
+		expiry = wheel.now + WHEEL_MAX_DELTA;
+		delta = WHEEL_MAX_DELTA;
+	}
+
+	for (level = 0; level < WHEEL_LEVELS - 1; level++) {
+		if (delta < (1 << WHEEL_SHIFT(level + 1))) {
+			break;
+		}
+	}
+
+	sys_dlist_append(&wheel.slots[level][WHEEL_INDEX(expiry, level)],
+			 &t->node);
+}
+
+/* move all the timeouts of a slot to an empty list */
+static void _nano_timeout_wheel_detach(sys_dlist_t *slot, sys_dlist_t *list)
+{
+	if (sys_dlist_is_empty(slot)) {
+		sys_dlist_init(list);
+		return;
+	}
+
+	list->head = slot->head;
+	list->tail = slot->tail;
+	list->head->prev = list;
+	list->tail->next = list;
+	sys_dlist_init(slot);
+}
+
+/* re-hash all the timeouts of a slot into the lower levels */
+static void _nano_timeout_wheel_cascade(int level, int index)
+{
+	sys_dlist_t pending;
+	sys_dnode_t *node;
+
+	/*
+	 * Detach the whole slot first: a timeout parked in the last level can
+	 * be hashed back into the very slot that is being cascaded.
+	 */
+	_nano_timeout_wheel_detach(&wheel.slots[level][index], &pending);
+
+	while ((node = sys_dlist_get(&pending)) != NULL) {
+		_nano_timeout_wheel_insert((struct _nano_timeout *)node);
+	}
+}
+
+/* process tick 'wheel.now' and advance the wheel by one tick */
+static void _nano_timeout_wheel_tick(void)
+{
+	sys_dlist_t *slot = &wheel.slots[0][WHEEL_INDEX(wheel.now, 0)];
+	sys_dlist_t expired;
+	struct _nano_timeout *t;
+	int level;
+
+	if (WHEEL_INDEX(wheel.now, 0) == 0) {
+		for (level = 1; level < WHEEL_LEVELS; level++) {
+			int index = WHEEL_INDEX(wheel.now, level);
+
+			_nano_timeout_wheel_cascade(level, index);
+			if (index != 0) {
+				break;
+			}
+		}
+	}
+
+	wheel.now++;
+
+	/*
+	 * Detach the slot first: a timeout re-added by a callback with a delay
+	 * of a multiple of WHEEL_SLOTS ticks is hashed back into this slot,
+	 * and must wait for the wheel to come around again.
+	 */
+	_nano_timeout_wheel_detach(slot, &expired);
+
+	while ((t = (struct _nano_timeout *)sys_dlist_get(&expired)) != NULL) {
+		_nano_timeout_expire(t);
+	}
+}
+
+/*
+ * Find how many ticks can be processed before reaching one that touches a
+ * non-empty slot, either to expire it (level 0) or to cascade it (upper
+ * levels). Returns WHEEL_MAX_DELTA + 1 if the wheel is empty.
+ */
+static uint32_t _nano_timeout_wheel_idle_ticks(void)
+{
+	uint32_t idle = WHEEL_MAX_DELTA + 1;
+	int level;
+	int i;
+
+	for (level = 0; level < WHEEL_LEVELS; level++) {
+		uint32_t span = 1 << WHEEL_SHIFT(level);
+		/* first tick at which this level's current slot is handled */
+		uint32_t tick = (wheel.now + span - 1) & ~(span - 1);
+
+		for (i = 0; i < WHEEL_SLOTS; i++, tick += span) {
+			if (tick - wheel.now >= idle) {
+				break;
+			}
+			if (!sys_dlist_is_empty(
+				    &wheel.slots[level][WHEEL_INDEX(tick, level)])) {
+				idle = tick - wheel.now;
+				break;
+			}
+		}
+	}
+
+	return idle;
+}
+
+/* announce ticks to the timing wheel and handle the expired timeouts */
+void _nano_timeout_handle_timeouts(int32_t ticks)
+{
+	while (ticks > 0) {
+		if (ticks > 1) {
+			/* skip over empty slots, e.g. after tickless idle */
+			uint32_t idle = _nano_timeout_wheel_idle_ticks();
+
+			if (idle >= (uint32_t)ticks) {
+				wheel.now += ticks;
+				return;
+			}
+			wheel.now += idle;
+			ticks -= idle;
+		}
+		_nano_timeout_wheel_tick();
+		ticks--;
+	}
+}
+
+/**
+ *
+ * @brief abort a timeout
+ *
+ * @param t Timeout to abort
+ *
+ * @return 0 in success and -1 if the timer has expired
+ */
+int _do_nano_timeout_abort(struct _nano_timeout *t)
+{
+	if (-1 == t->delta_ticks_from_prev) {
+		return -1;
+	}
+
+	sys_dlist_remove(&t->node);
 	t->delta_ticks_from_prev = -1;
 
+	return 0;
+}
+
+/**
+ *
+ * @brief Put timeout on the timeout queue, record waiting fiber and wait queue
+ *
+ * @param tcs Fiber waiting on a timeout
+ * @param t Timeout structure to be added to the nanokernel queue
+ * @wait_q nanokernel object wait queue
+ * @timeout Timeout in ticks
+ *
+ * @return N/A
+ */
+void _do_nano_timeout_add(struct tcs *tcs,
+			  struct _nano_timeout *t,
+			  struct _nano_queue *wait_q,
+			  int32_t timeout)
+{
+	t->tcs = tcs;
+	t->delta_ticks_from_prev = 0;
+	t->wait_q = wait_q;
+
+	/* a timeout of N ticks expires when the Nth next tick is processed */
+	t->expiry = wheel.now + (timeout > 0 ? timeout - 1 : 0);
+	_nano_timeout_wheel_insert(t);
+}
+
+/* get the number of ticks remaining before a timeout expires */
+int32_t _nano_timeout_ticks_remain(struct _nano_timeout *t)
+{
+	int32_t remaining;
+
+	if (t->delta_ticks_from_prev == -1) {
+		return 0;
+	}
+
+	remaining = (int32_t)(t->expiry - wheel.now) + 1;
+	return remaining > 0 ? remaining : 0;
+}
+
+/* find the closest deadline in the timeout queue */
+uint32_t _nano_get_earliest_timeouts_deadline(void)
+{
+	uint32_t idle = _nano_timeout_wheel_idle_ticks();
+
+	/*
+	 * The first non-empty slot may only need cascading, in which case
+	 * this is an early deadline: the wheel is then simply re-examined.
+	 */
+	return (idle > WHEEL_MAX_DELTA) ? (uint32_t)_nanokernel.task_timeout
+		: min(idle + 1, (uint32_t)_nanokernel.task_timeout);
+}
+
+#else
+
+/* dequeue the expired timeout at the head of the delta list and handle it */
+static struct _nano_timeout *_nano_timeout_handle_one_timeout(
+	sys_dlist_t *timeout_q)
+{
+	struct _nano_timeout *t = (void *)sys_dlist_get(timeout_q);
+
+	_nano_timeout_expire(t);
+
 	return (struct _nano_timeout *)sys_dlist_peek_head(timeout_q);
 }
 
-/* loop over all expired timeouts and handle them one by one */
-void _nano_timeout_handle_timeouts(void)
+/* announce ticks to the timeout queue and handle the expired timeouts */
+void _nano_timeout_handle_timeouts(int32_t ticks)
 {
 	sys_dlist_t *timeout_q = &_nanokernel.timeout_q;
 	struct _nano_timeout *next;
 
 	next = (struct _nano_timeout *)sys_dlist_peek_head(timeout_q);
+	if (next) {
+		next->delta_ticks_from_prev -= ticks;
+	}
 	while (next && next->delta_ticks_from_prev == 0) {
 		next = _nano_timeout_handle_one_timeout(timeout_q);
 	}
@@ -193,6 +466,35 @@ void _do_nano_timeout_add(struct tcs *tcs,
 						&t->delta_ticks_from_prev);
 }
 
+/* get the number of ticks remaining before a timeout expires */
+int32_t _nano_timeout_ticks_remain(struct _nano_timeout *t)
+{
+	sys_dlist_t *timeout_q = &_nanokernel.timeout_q;
+	struct _nano_timeout *iterator;
+	int32_t remaining_ticks;
+
+	if (t->delta_ticks_from_prev == -1) {
+		return 0;
+	}
+
+	/*
+	 * As nanokernel timeouts are stored in a linked list with
+	 * delta_ticks_from_prev, to get the actual number of ticks
+	 * remaining for the timer, walk through the timeouts list
+	 * and accumulate all the delta_ticks_from_prev values up to
+	 * the timer.
+	 */
+	iterator = (struct _nano_timeout *)sys_dlist_peek_head(timeout_q);
+	remaining_ticks = iterator->delta_ticks_from_prev;
+	while (iterator != t) {
+		iterator = (struct _nano_timeout *)sys_dlist_peek_next(
+			timeout_q, &iterator->node);
+		remaining_ticks += iterator->delta_ticks_from_prev;
+	}
+
+	return remaining_ticks;
+}
+
 /* find the closest deadline in the timeout queue */
 uint32_t _nano_get_earliest_timeouts_deadline(void)
 {
@@ -205,3 +507,4 @@ uint32_t _nano_get_earliest_timeouts_deadline(void)
 			 : (uint32_t)_nanokernel.task_timeout;
 }
 
+#endif /* CONFIG_NANO_TIMEOUT_WHEEL */
@@ -34,6 +34,8 @@ static struct tcs *_nano_wait_q_remove_no_check(struct _nano_queue *wait_q)
 		_nano_wait_q_reset(wait_q);
 	} else {
 		wait_q->head = tcs->link;
+		_NANO_WAIT_Q_PREV_SET((struct tcs *)wait_q->head,
+				      (struct tcs *)&wait_q->head);
 	}
 	tcs->link = 0;
 
@@ -17,6 +17,31 @@
  */
 
 #include <string.h>
+#include <stdint.h>
+
+/*
+ * Word-at-a-time helpers. Accesses through mem_word_t may alias any other
+ * type. An aligned word never crosses a page or MPU region boundary, so
+ * reading a whole word that is only partly inside a buffer is safe.
+ */
+typedef unsigned int __attribute__((__may_alias__)) mem_word_t;
+
+#define WORD_SIZE sizeof(mem_word_t)
+#define WORD_MASK (WORD_SIZE - 1)
+
+#define BLOCK_SIZE (4 * WORD_SIZE)
+
+/* non-zero if any byte of <w> is zero */
+#define HAS_ZERO_BYTE(w) (((w) - 0x01010101) & ~(w) & 0x80808080)
+
+/* merge the bytes following a misaligned address from two aligned words */
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+#define MERGE_WORDS(lo, hi, shift) \
+	(((lo) << (shift)) | ((hi) >> (8 * WORD_SIZE - (shift))))
+#else
+#define MERGE_WORDS(lo, hi, shift) \
+	(((lo) >> (shift)) | ((hi) << (8 * WORD_SIZE - (shift))))
+#endif
 
 /**
  *
@@ -93,14 +118,29 @@ char *strchr(const char *s, int c)
 
 size_t strlen(const char *s)
 {
-	size_t n = 0;
+	const char *p = s;
+	const mem_word_t *w;
 
-	while (*s != '\0') {
-		s++;
-		n++;
+	/* check bytes until word-aligned */
+
+	while ((uintptr_t)p & WORD_MASK) {
+		if (*p == '\0') {
+			return p - s;
+		}
+		p++;
 	}
 
-	return n;
+	/* check a word at a time until one contains the terminator */
+
+	for (w = (const mem_word_t *)p; !HAS_ZERO_BYTE(*w); w++) {
+	}
+
+	/* find the terminator within the word */
+
+	for (p = (const char *)w; *p != '\0'; p++) {
+	}
+
+	return p - s;
 }
 
 /**
@@ -166,18 +206,46 @@ char *strncat(char *_Restrict dest, const char *_Restrict src, size_t n)
  */
 int memcmp(const void *m1, const void *m2, size_t n)
 {
-	const char *c1 = m1;
-	const char *c2 = m2;
+	const unsigned char *c1 = m1;
+	const unsigned char *c2 = m2;
+
+	/* compare words only if both areas have identical alignment */
 
-	if (!n)
-		return 0;
+	if ((((uintptr_t)c1 ^ (uintptr_t)c2) & WORD_MASK) == 0) {
 
-	while ((--n > 0) && (*c1 == *c2)) {
+		while (((uintptr_t)c1 & WORD_MASK) && n > 0 && *c1 == *c2) {
+			c1++;
+			c2++;
+			n--;
+		}
+
+		/* skip equal words, the bytes that differ are checked below */
+
+		const mem_word_t *w1 = (const mem_word_t *)c1;
+		const mem_word_t *w2 = (const mem_word_t *)c2;
+
+		if (((uintptr_t)c1 & WORD_MASK) == 0) {
+			while (n >= WORD_SIZE && *w1 == *w2) {
+				w1++;
+				w2++;
+				n -= WORD_SIZE;
+			}
+		}
+
+		c1 = (const unsigned char *)w1;
+		c2 = (const unsigned char *)w2;
+	}
+
+	while (n > 0) {
+		if (*c1 != *c2) {
+			return *c1 - *c2;
+		}
 		c1++;
 		c2++;
+		n--;
 	}
 
-	return *c1 - *c2;
+	return 0;
 }
 
 /**
@@ -222,37 +290,109 @@ void *memmove(void *d, const void *s, size_t n)
  * @return pointer to start of destination buffer
  */
 
+#if defined(CONFIG_X86)
+
 void *memcpy(void *_Restrict d, const void *_Restrict s, size_t n)
 {
-	/* attempt word-sized copying only if buffers have identical alignment */
+	void *dest = d;
+	size_t words = n / 4;
+
+	/* string moves are the fastest way on all IA-32 cores we support */
+
+	__asm__ volatile("rep movsl\n\t"
+			 "movl %[bytes], %%ecx\n\t"
+			 "rep movsb\n\t"
+			 : "+D"(d), "+S"(s), "+c"(words)
+			 : [bytes] "r"(n & 3)
+			 : "memory");
+
+	return dest;
+}
+
+#else
+
+/*
+ * Copy words from an aligned source to an aligned destination, returns the
+ * number of bytes left.
+ */
+static inline size_t copy_words(mem_word_t **d_word, const mem_word_t **s_word,
+				size_t n)
+{
+	mem_word_t *d = *d_word;
+	const mem_word_t *s = *s_word;
+
+	while (n >= BLOCK_SIZE) {
+#if defined(CONFIG_CPU_CORTEX_M3_M4)
+		__asm__ volatile("ldmia %[s]!, {r3, r4, r5, r12}\n\t"
+				 "stmia %[d]!, {r3, r4, r5, r12}\n\t"
+				 : [s] "+r"(s), [d] "+r"(d)
+				 :
+				 : "r3", "r4", "r5", "r12", "memory");
+#else
+		mem_word_t w0 = s[0], w1 = s[1], w2 = s[2], w3 = s[3];
+
+		d[0] = w0;
+		d[1] = w1;
+		d[2] = w2;
+		d[3] = w3;
+		d += 4;
+		s += 4;
+#endif
+		n -= BLOCK_SIZE;
+	}
+
+	while (n >= WORD_SIZE) {
+		*(d++) = *(s++);
+		n -= WORD_SIZE;
+	}
 
+	*d_word = d;
+	*s_word = s;
+
+	return n;
+}
+
+void *memcpy(void *_Restrict d, const void *_Restrict s, size_t n)
+{
 	unsigned char *d_byte = (unsigned char *)d;
 	const unsigned char *s_byte = (const unsigned char *)s;
 
-	if ((((unsigned int)d ^ (unsigned int)s_byte) & 0x3) == 0) {
+	/* do byte-sized copying until the destination is word-aligned */
 
-		/* do byte-sized copying until word-aligned or finished */
+	while (((uintptr_t)d_byte & WORD_MASK) && n > 0) {
+		*(d_byte++) = *(s_byte++);
+		n--;
+	}
 
-		while (((unsigned int)d_byte) & 0x3) {
-			if (n == 0) {
-				return d;
+	if (n >= WORD_SIZE) {
+		mem_word_t *d_word = (mem_word_t *)d_byte;
+		unsigned int shift = ((uintptr_t)s_byte & WORD_MASK) * 8;
+
+		if (shift == 0) {
+			const mem_word_t *s_word = (const mem_word_t *)s_byte;
+
+			n = copy_words(&d_word, &s_word, n);
+			s_byte = (const unsigned char *)s_word;
+		} else {
+			/*
+			 * Read aligned source words and merge each pair into
+			 * one destination word instead of copying bytes.
+			 */
+			const mem_word_t *s_word =
+				(const mem_word_t *)(s_byte - shift / 8);
+			mem_word_t lo = *(s_word++), hi;
+
+			while (n >= WORD_SIZE) {
+				hi = *(s_word++);
+				*(d_word++) = MERGE_WORDS(lo, hi, shift);
+				lo = hi;
+				n -= WORD_SIZE;
 			}
-			*(d_byte++) = *(s_byte++);
-			n--;
-		};
-
-		/* do word-sized copying as long as possible */
 
-		unsigned int *d_word = (unsigned int *)d_byte;
-		const unsigned int *s_word = (const unsigned int *)s_byte;
-
-		while (n >= sizeof(unsigned int)) {
-			*(d_word++) = *(s_word++);
-			n -= sizeof(unsigned int);
+			s_byte = (const unsigned char *)(s_word - 1) + shift / 8;
 		}
 
 		d_byte = (unsigned char *)d_word;
-		s_byte = (unsigned char *)s_word;
 	}
 
 	/* do byte-sized copying until finished */
@@ -265,6 +405,8 @@ void *memcpy(void *_Restrict d, const void *_Restrict s, size_t n)
 	return d;
 }
 
+#endif /* CONFIG_X86 */
+
 /**
  *
  * @brief Set bytes in memory
@@ -272,6 +414,29 @@ void *memcpy(void *_Restrict d, const void *_Restrict s, size_t n)
  * @return pointer to start of buffer
  */
 
+#if defined(CONFIG_X86)
+
+void *memset(void *buf, int c, size_t n)
+{
+	void *d = buf;
+	size_t words = n / 4;
+	unsigned int c_word = (unsigned char)c;
+
+	c_word |= c_word << 8;
+	c_word |= c_word << 16;
+
+	__asm__ volatile("rep stosl\n\t"
+			 "movl %[bytes], %%ecx\n\t"
+			 "rep stosb\n\t"
+			 : "+D"(d), "+c"(words)
+			 : "a"(c_word), [bytes] "r"(n & 3)
+			 : "memory");
+
+	return buf;
+}
+
+#else
+
 void *memset(void *buf, int c, size_t n)
 {
 	/* do byte-sized initialization until word-aligned or finished */
@@ -279,25 +444,42 @@ void *memset(void *buf, int c, size_t n)
 	unsigned char *d_byte = (unsigned char *)buf;
 	unsigned char c_byte = (unsigned char)c;
 
-	while (((unsigned int)d_byte) & 0x3) {
-		if (n == 0) {
-			return buf;
-		}
+	while (((uintptr_t)d_byte & WORD_MASK) && n > 0) {
 		*(d_byte++) = c_byte;
 		n--;
-	};
+	}
 
 	/* do word-sized initialization as long as possible */
 
-	unsigned int *d_word = (unsigned int *)d_byte;
-	unsigned int c_word = (unsigned int)(unsigned char)c;
+	mem_word_t *d_word = (mem_word_t *)d_byte;
+	mem_word_t c_word = (mem_word_t)c_byte;
 
 	c_word |= c_word << 8;
 	c_word |= c_word << 16;
 
-	while (n >= sizeof(unsigned int)) {
+	while (n >= BLOCK_SIZE) {
+#if defined(CONFIG_CPU_CORTEX_M3_M4)
+		__asm__ volatile("mov r3, %[c]\n\t"
+				 "mov r4, %[c]\n\t"
+				 "mov r5, %[c]\n\t"
+				 "mov r12, %[c]\n\t"
+				 "stmia %[d]!, {r3, r4, r5, r12}\n\t"
+				 : [d] "+r"(d_word)
+				 : [c] "r"(c_word)
+				 : "r3", "r4", "r5", "r12", "memory");
+#else
+		d_word[0] = c_word;
+		d_word[1] = c_word;
+		d_word[2] = c_word;
+		d_word[3] = c_word;
+		d_word += 4;
+#endif
+		n -= BLOCK_SIZE;
+	}
+
+	while (n >= WORD_SIZE) {
 		*(d_word++) = c_word;
-		n -= sizeof(unsigned int);
+		n -= WORD_SIZE;
 	}
 
 	/* do byte-sized initialization until finished */
@@ -312,6 +494,8 @@ void *memset(void *buf, int c, size_t n)
 	return buf;
 }
 
+#endif /* CONFIG_X86 */
+
 /**
  *
  * @brief Scan byte in memory
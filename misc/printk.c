@@ -27,6 +27,14 @@
 #include <toolchain.h>
 #include <sections.h>
 
+#ifdef CONFIG_PRINTK_DEFERRED
+#include <nanokernel.h>
+#include <atomic.h>
+#include <init.h>
+#include <string.h>
+#include <misc/util.h>
+#endif
+
 static void _printk_dec_ulong(const unsigned long num);
 static void _printk_hex_ulong(const unsigned long num);
 
@@ -62,15 +70,67 @@ void __printk_hook_install(int (*fn)(int))
 }
 
 /**
- * @brief Printk internals
+ * @brief Output one conversion
+ *
+ * @param conv Conversion specifier character
+ * @param arg Argument of the conversion, the string address for %s
+ *
+ * @return N/A
+ */
+static void _printk_conv(char conv, unsigned long arg)
+{
+	switch (conv) {
+	case 'd':
+	case 'i': {
+		long d = (long)arg;
+
+		if (d < 0) {
+			_char_out((int)'-');
+			d = -d;
+		}
+		_printk_dec_ulong(d);
+		break;
+	}
+	case 'u':
+		_printk_dec_ulong(arg);
+		break;
+	case 'x':
+	case 'X':
+	case 'p':
+		_printk_hex_ulong(arg);
+		break;
+	case 's': {
+		const char *s = (const char *)arg;
+
+		while (*s)
+			_char_out((int)(*s++));
+		break;
+	}
+	case 'c':
+		_char_out((int)arg);
+		break;
+	case '%':
+		_char_out((int)'%');
+		break;
+	default:
+		_char_out((int)'%');
+		_char_out((int)conv);
+		break;
+	}
+}
+
+/**
+ * @brief Format a string
  *
- * See printk() for description.
  * @param fmt Format string
- * @param ap Variable parameters
+ * @param next_arg Routine fetching the argument of each conversion
+ * @param ctx Context passed to next_arg
  *
  * @return N/A
  */
-static inline void _vprintk(const char *fmt, va_list ap)
+static void _printk_format(const char *fmt,
+			   unsigned long (*next_arg)(char conv, void *ctx),
+			   void *ctx)
 {
 	int might_format = 0; /* 1 if encountered a '%' */
 
@@ -84,61 +144,436 @@ static inline void _vprintk(const char *fmt, va_list ap)
 				might_format = 1;
 			}
 		} else {
-			switch (*fmt) {
-			case 'd':
-			case 'i': {
-				long d = va_arg(ap, long);
-
-				if (d < 0) {
-					_char_out((int)'-');
-					d = -d;
-				}
-				_printk_dec_ulong(d);
-				break;
-			}
-			case 'u': {
-				unsigned long u = va_arg(
-					ap, unsigned long);
-				_printk_dec_ulong(u);
-				break;
-			}
-			case 'x':
-			case 'X':
-			case 'p': {
-				unsigned long x = va_arg(
-					ap, unsigned long);
-				_printk_hex_ulong(x);
-				break;
-			}
-			case 's': {
-				char *s = va_arg(ap, char *);
+			_printk_conv(*fmt, next_arg(*fmt, ctx));
+			might_format = 0;
+		}
 
-				while (*s)
-					_char_out((int)(*s++));
-				break;
-			}
-			case 'c': {
-				int c = va_arg(ap, int);
+		++fmt;
+	}
+}
 
-				_char_out(c);
-				break;
-			}
-			case '%': {
-				_char_out((int)'%');
-				break;
+/**
+ * @brief Check whether a conversion takes an argument
+ *
+ * @param conv Conversion specifier character
+ *
+ * @return 1 if it does, 0 otherwise
+ */
+static int _printk_has_arg(char conv)
+{
+	switch (conv) {
+	case 'd':
+	case 'i':
+	case 'u':
+	case 'x':
+	case 'X':
+	case 'p':
+	case 's':
+	case 'c':
+		return 1;
+	default:
+		return 0;
+	}
+}
+
+/**
+ * @brief Fetch a conversion argument from a variable argument list
+ *
+ * @param conv Conversion specifier character
+ * @param ctx Variable argument list
+ *
+ * @return Argument, or 0 if the conversion takes none
+ */
+static unsigned long _printk_va_arg(char conv, void *ctx)
+{
+	va_list *ap = ctx;
+
+	switch (conv) {
+	case 'd':
+	case 'i':
+		return (unsigned long)va_arg(*ap, long);
+	case 'u':
+	case 'x':
+	case 'X':
+	case 'p':
+		return va_arg(*ap, unsigned long);
+	case 's':
+		return (unsigned long)va_arg(*ap, char *);
+	case 'c':
+		return (unsigned long)va_arg(*ap, int);
+	default:
+		return 0;
+	}
+}
+
+/**
+ * @brief Printk internals
+ *
+ * See printk() for description.
+ * @param fmt Format string
+ * @param ap Variable parameters
+ *
+ * @return N/A
+ */
+static inline void _vprintk(const char *fmt, va_list ap)
+{
+	va_list args;
+
+	va_copy(args, ap);
+	_printk_format(fmt, _printk_va_arg, &args);
+	va_end(args);
+}
+
+#ifdef CONFIG_PRINTK_DEFERRED
+
+/*
+ * Deferred messages are kept in a ring of 32-bit words. Each record starts
+ * with a header word holding its length in words and a ready flag,
+ * followed by the timestamp, the format string pointer and one word per
+ * argument. String arguments are copied into the record, NUL terminated
+ * and padded to a whole word. A record never wraps: when it does not fit
+ * before the end of the ring, the remaining words are taken by a padding
+ * record.
+ *
+ * Space is reserved by moving the head index with a compare and swap, so
+ * any context, ISRs included, can capture a message without locking
+ * interrupts. The record is then filled in and published by storing its
+ * header last. The fiber outputs ready records in order, clears them and
+ * moves the tail index. A record whose writer was preempted before
+ * publishing it stops the fiber until that writer wakes it up again.
+ */
+
+#if (CONFIG_PRINTK_DEFERRED_BUF_SIZE & (CONFIG_PRINTK_DEFERRED_BUF_SIZE - 1))
+#error "CONFIG_PRINTK_DEFERRED_BUF_SIZE must be a power of two"
+#endif
+
+#define LOG_WORDS (CONFIG_PRINTK_DEFERRED_BUF_SIZE / sizeof(uint32_t))
+#define LOG_MASK (LOG_WORDS - 1)
+
+#define LOG_HDR_LEN_MASK 0xffff
+#define LOG_HDR_READY BIT(16)
+#define LOG_HDR_PAD BIT(17)
+
+/* header, timestamp and format string */
+#define LOG_REC_FIXED 3
+
+#define LOG_STR_WORDS(len) (((len) + sizeof(uint32_t)) / sizeof(uint32_t))
+
+/* messages from tasks do not wake up the fiber, it polls for them */
+#define LOG_POLL_TICKS max(sys_clock_ticks_per_sec / 10, 1)
+
+static uint32_t log_buf[LOG_WORDS];
+
+/* free running word indexes */
+static atomic_t log_head;
+static atomic_t log_tail;
+
+static atomic_t log_deferred;
+static atomic_t log_dropped;
+static uint32_t log_max_used;
+
+static int log_panic;
+
+static struct nano_sem log_sem;
+
+static size_t _printk_str_len(const char *s)
+{
+	size_t len;
+
+	for (len = 0; len < CONFIG_PRINTK_DEFERRED_STR_MAX && s[len]; len++) {
+	}
+
+	return len;
+}
+
+/**
+ * @brief Compute the record size of a message
+ *
+ * @param fmt Format string
+ * @param ap Variable parameters
+ *
+ * @return Record size in words
+ */
+static uint32_t _printk_rec_words(const char *fmt, va_list *ap)
+{
+	uint32_t words = LOG_REC_FIXED;
+
+	for (; *fmt; fmt++) {
+		if (*fmt != '%') {
+			continue;
+		}
+
+		if (!*++fmt) {
+			break;
+		}
+
+		if (*fmt == 's') {
+			words += LOG_STR_WORDS(_printk_str_len(va_arg(*ap,
+								      char *)));
+		} else if (_printk_has_arg(*fmt)) {
+			_printk_va_arg(*fmt, ap);
+			words++;
+		}
+	}
+
+	return words;
+}
+
+/**
+ * @brief Copy the arguments of a message into its record
+ *
+ * @param rec First argument word of the record
+ * @param fmt Format string
+ * @param ap Variable parameters
+ *
+ * @return N/A
+ */
+static void _printk_rec_fill(uint32_t *rec, const char *fmt, va_list *ap)
+{
+	const char *s;
+	size_t len;
+
+	for (; *fmt; fmt++) {
+		if (*fmt != '%') {
+			continue;
+		}
+
+		if (!*++fmt) {
+			break;
+		}
+
+		if (*fmt == 's') {
+			s = va_arg(*ap, char *);
+			len = _printk_str_len(s);
+			memcpy(rec, s, len);
+			((char *)rec)[len] = '\0';
+			rec += LOG_STR_WORDS(len);
+		} else if (_printk_has_arg(*fmt)) {
+			*rec++ = _printk_va_arg(*fmt, ap);
+		}
+	}
+}
+
+/**
+ * @brief Reserve space for a record
+ *
+ * @param words Record size in words
+ *
+ * @return Index of the record in the ring, or -1 if it does not fit
+ */
+static int _printk_rec_alloc(uint32_t words)
+{
+	uint32_t head, ofs, pad, used;
+
+	do {
+		head = atomic_get(&log_head);
+		ofs = head & LOG_MASK;
+		pad = (ofs + words > LOG_WORDS) ? LOG_WORDS - ofs : 0;
+		used = head + pad + words - atomic_get(&log_tail);
+
+		if (used > LOG_WORDS) {
+			return -1;
+		}
+	} while (!atomic_cas(&log_head, head, head + pad + words));
+
+	if (pad) {
+		atomic_set((atomic_t *)&log_buf[ofs],
+			   LOG_HDR_READY | LOG_HDR_PAD | pad);
+		ofs = 0;
+	}
+
+	/* only a statistic, a lost update does no harm */
+	if (used * sizeof(uint32_t) > log_max_used) {
+		log_max_used = used * sizeof(uint32_t);
+	}
+
+	return ofs;
+}
+
+/**
+ * @brief Capture a message into the deferred printk() buffer
+ *
+ * The time taken only depends on the format string and the string
+ * arguments, never on the console.
+ *
+ * @param fmt Format string
+ * @param ap Variable parameters
+ *
+ * @return N/A
+ */
+static void _printk_defer(const char *fmt, va_list ap)
+{
+	uint32_t words;
+	va_list args;
+	int ofs;
+
+	va_copy(args, ap);
+	words = _printk_rec_words(fmt, &args);
+	va_end(args);
+
+	ofs = _printk_rec_alloc(words);
+	if (ofs < 0) {
+		atomic_inc(&log_dropped);
+		return;
+	}
+
+	log_buf[ofs + 1] = sys_cycle_get_32();
+	log_buf[ofs + 2] = (uint32_t)fmt;
+
+	va_copy(args, ap);
+	_printk_rec_fill(&log_buf[ofs + LOG_REC_FIXED], fmt, &args);
+	va_end(args);
+
+	/* publish the record, atomic_set() orders the stores above */
+	atomic_set((atomic_t *)&log_buf[ofs], LOG_HDR_READY | words);
+
+	atomic_inc(&log_deferred);
+
+	if (sys_execution_context_type_get() != NANO_CTX_TASK) {
+		nano_sem_give(&log_sem);
+	}
+}
+
+static unsigned long _printk_rec_arg(char conv, void *ctx)
+{
+	uint32_t **rec = ctx;
+	unsigned long arg;
+
+	if (conv == 's') {
+		arg = (unsigned long)*rec;
+		*rec += LOG_STR_WORDS(strlen((char *)*rec));
+		return arg;
+	}
+
+	return _printk_has_arg(conv) ? *(*rec)++ : 0;
+}
+
+/**
+ * @brief Output the ready records of the deferred printk() buffer
+ *
+ * @return N/A
+ */
+static void _printk_drain(void)
+{
+	static uint32_t dropped_seen;
+	static int line_start = 1;
+	uint32_t tail, hdr, words, dropped;
+	uint32_t *rec;
+
+	tail = atomic_get(&log_tail);
+
+	while (tail != atomic_get(&log_head)) {
+		rec = &log_buf[tail & LOG_MASK];
+		hdr = atomic_get((atomic_t *)rec);
+
+		/* the writer was preempted, it wakes us up when done */
+		if (!(hdr & LOG_HDR_READY)) {
+			break;
+		}
+
+		words = hdr & LOG_HDR_LEN_MASK;
+
+		if (!(hdr & LOG_HDR_PAD)) {
+			const char *fmt = (const char *)rec[2];
+			uint32_t *args = &rec[LOG_REC_FIXED];
+
+#ifdef CONFIG_PRINTK_DEFERRED_TIMESTAMP
+			if (line_start) {
+				_char_out((int)'[');
+				_printk_hex_ulong(rec[1]);
+				_char_out((int)']');
+				_char_out((int)' ');
 			}
-			default:
-				_char_out((int)'%');
-				_char_out((int)*fmt);
-				break;
+#endif
+
+			_printk_format(fmt, _printk_rec_arg, &args);
+
+			if (*fmt) {
+				line_start = (fmt[strlen(fmt) - 1] == '\n');
 			}
-			might_format = 0;
 		}
 
-		++fmt;
+		/* writers expect the space they reserve to be zeroed */
+		memset(rec, 0, words * sizeof(uint32_t));
+
+		tail += words;
+		atomic_set(&log_tail, tail);
+	}
+
+	dropped = atomic_get(&log_dropped);
+	if (dropped != dropped_seen && line_start) {
+		_printk_conv('u', dropped - dropped_seen);
+		_printk_conv('s', (unsigned long)" printk messages dropped\n");
+		dropped_seen = dropped;
+	}
+}
+
+static void _printk_fiber(int arg1, int arg2)
+{
+	ARG_UNUSED(arg1);
+	ARG_UNUSED(arg2);
+
+	while (1) {
+		_printk_drain();
+		nano_fiber_sem_take(&log_sem, LOG_POLL_TICKS);
 	}
 }
 
+void printk_panic(void)
+{
+	unsigned int key = irq_lock();
+
+	log_panic = 1;
+	_printk_drain();
+
+	irq_unlock(key);
+}
+
+void printk_stats_get(struct printk_stats *stats)
+{
+	stats->deferred = atomic_get(&log_deferred);
+	stats->dropped = atomic_get(&log_dropped);
+	stats->max_used = log_max_used;
+}
+
+static char __stack log_stack[CONFIG_PRINTK_DEFERRED_FIBER_STACK_SIZE];
+
+static const struct fiber_config log_fiber_config = {
+	.stack = log_stack,
+	.stack_size = sizeof(log_stack),
+	.prio = CONFIG_PRINTK_DEFERRED_FIBER_PRIORITY,
+};
+
+static int _printk_deferred_init(struct device *dev)
+{
+	ARG_UNUSED(dev);
+
+	nano_sem_init(&log_sem);
+	fiber_start_config(&log_fiber_config, _printk_fiber, 0, 0, 0);
+
+	return 0;
+}
+
+SYS_INIT(_printk_deferred_init, PRIMARY, CONFIG_KERNEL_INIT_PRIORITY_DEFAULT);
+
+static inline int _printk_deferred(void)
+{
+	return !log_panic;
+}
+
+#else
+
+static inline int _printk_deferred(void)
+{
+	return 0;
+}
+
+static inline void _printk_defer(const char *fmt, va_list ap)
+{
+}
+
+#endif /* CONFIG_PRINTK_DEFERRED */
+
 /**
  * @brief Output a string
  *
@@ -162,7 +597,13 @@ void printk(const char *fmt, ...)
 	va_list ap;
 
 	va_start(ap, fmt);
-	_vprintk(fmt, ap);
+
+	if (_printk_deferred()) {
+		_printk_defer(fmt, ap);
+	} else {
+		_vprintk(fmt, ap);
+	}
+
 	va_end(ap);
 }
 
@@ -25,6 +25,7 @@
 #include <atomic.h>
 #include <misc/byteorder.h>
 #include <misc/util.h>
+#include <misc/stack.h>
 #include <misc/nano_work.h>
 
 #include <bluetooth/log.h>
@@ -45,14 +46,30 @@
 #define BT_DBG(fmt, ...)
 #endif
 
-/* Pool for outgoing ACL fragments */
+/* Number of outgoing ACL fragments which can be in the driver at once */
+#define CONN_FRAG_COUNT 4
+
+/* Pool for the ACL headers of outgoing fragments */
 static struct nano_fifo frag_buf;
-static NET_BUF_POOL(frag_pool, 1, BT_L2CAP_BUF_SIZE(23), &frag_buf, NULL,
+static NET_BUF_POOL(frag_pool, CONN_FRAG_COUNT,
+		    CONFIG_BLUETOOTH_HCI_SEND_RESERVE +
+		    sizeof(struct bt_hci_acl_hdr), &frag_buf, NULL,
 		    BT_BUF_USER_DATA_MIN);
 
-/* Pool for dummy buffers to wake up the tx fibers */
-static struct nano_fifo dummy;
-static NET_BUF_POOL(dummy_pool, CONFIG_BLUETOOTH_MAX_CONN, 0, &dummy, NULL, 0);
+/* Pool for references to the data of outgoing fragments */
+static struct nano_fifo ref_buf;
+static BT_CONN_REF_POOL(ref_pool, CONN_FRAG_COUNT * 2, &ref_buf);
+
+/* The referenced buffer is kept after the buffer type in user data */
+#define ref_parent(buf) (*(struct net_buf **)((uint8_t *) \
+			 net_buf_user_data(buf) + BT_BUF_USER_DATA_MIN))
+
+/* TX scheduler fiber shared by all connections */
+static BT_STACK_NOINIT(tx_fiber_stack, 256);
+static struct nano_sem tx_sem;
+
+/* Connection served last, the round-robin continues after it */
+static uint8_t tx_last;
 
 /* How long until we cancel HCI_LE_Create_Connection */
 #define CONN_TIMEOUT	(3 * sys_clock_ticks_per_sec)
@@ -749,6 +766,21 @@ static void bt_conn_reset_rx_state(struct bt_conn *conn)
 	conn->rx_len = 0;
 }
 
+/* Check if the PDU being received may be passed on as a fragment chain,
+ * which only LE dynamic channels support.
+ */
+static bool conn_rx_chain(struct bt_conn *conn)
+{
+#if defined(CONFIG_BLUETOOTH_L2CAP_DYNAMIC_CHANNEL)
+	struct bt_l2cap_hdr *hdr = (void *)conn->rx->data;
+
+	return conn->type == BT_CONN_TYPE_LE &&
+	       sys_le16_to_cpu(hdr->cid) >= BT_L2CAP_CID_DYN_START;
+#else
+	return false;
+#endif /* CONFIG_BLUETOOTH_L2CAP_DYNAMIC_CHANNEL */
+}
+
 void bt_conn_recv(struct bt_conn *conn, struct net_buf *buf, uint8_t flags)
 {
 	struct bt_l2cap_hdr *hdr;
@@ -794,17 +826,24 @@ void bt_conn_recv(struct bt_conn *conn, struct net_buf *buf, uint8_t flags)
 
 		BT_DBG("Cont, len %u rx_len %u", buf->len, conn->rx_len);
 
-		if (buf->len > net_buf_tailroom(conn->rx)) {
-			BT_ERR("Not enough buffer space for L2CAP data");
-			bt_conn_reset_rx_state(conn);
+		conn->rx_len -= buf->len;
+
+		if (conn_rx_chain(conn)) {
+			/* Chain the data instead of copying it */
+			net_buf_frag_last(conn->rx)->frags = buf;
+		} else {
+			if (buf->len > net_buf_tailroom(conn->rx)) {
+				BT_ERR("Not enough buffer space for L2CAP data");
+				bt_conn_reset_rx_state(conn);
+				net_buf_unref(buf);
+				return;
+			}
+
+			memcpy(net_buf_add(conn->rx, buf->len), buf->data,
+			       buf->len);
 			net_buf_unref(buf);
-			return;
 		}
 
-		memcpy(net_buf_add(conn->rx, buf->len), buf->data, buf->len);
-		conn->rx_len -= buf->len;
-		net_buf_unref(buf);
-
 		if (conn->rx_len) {
 			return;
 		}
@@ -824,8 +863,9 @@ void bt_conn_recv(struct bt_conn *conn, struct net_buf *buf, uint8_t flags)
 	hdr = (void *)buf->data;
 	len = sys_le16_to_cpu(hdr->len);
 
-	if (sizeof(*hdr) + len != buf->len) {
-		BT_ERR("ACL len mismatch (%u != %u)", len, buf->len);
+	if (sizeof(*hdr) + len != net_buf_frags_len(buf)) {
+		BT_ERR("ACL len mismatch (%u != %u)", len,
+		       net_buf_frags_len(buf));
 		net_buf_unref(buf);
 		return;
 	}
@@ -851,48 +891,26 @@ int bt_conn_send(struct bt_conn *conn, struct net_buf *buf)
 		return -ENOTCONN;
 	}
 
+#if defined(CONFIG_BLUETOOTH_L2CAP_DYNAMIC_CHANNEL)
+	if (buf->len >= sizeof(struct bt_l2cap_hdr)) {
+		struct bt_l2cap_hdr *hdr = (void *)buf->data;
+
+		if (sys_le16_to_cpu(hdr->cid) >= BT_L2CAP_CID_DYN_START) {
+			net_buf_put(&conn->tx_dyn_queue, buf);
+			bt_conn_tx_notify();
+			return 0;
+		}
+	}
+#endif /* CONFIG_BLUETOOTH_L2CAP_DYNAMIC_CHANNEL */
+
 	net_buf_put(&conn->tx_queue, buf);
+	bt_conn_tx_notify();
 	return 0;
 }
 
-static bool send_frag(struct bt_conn *conn, struct net_buf *buf, uint8_t flags,
-		      bool always_consume)
+void bt_conn_tx_notify(void)
 {
-	struct bt_hci_acl_hdr *hdr;
-	int err;
-
-	BT_DBG("conn %p buf %p len %u flags 0x%02x", conn, buf, buf->len,
-	       flags);
-
-	/* Wait until the controller can accept ACL packets */
-	nano_fiber_sem_take(bt_conn_get_pkts(conn), TICKS_UNLIMITED);
-
-	/* Check for disconnection while waiting for pkts_sem */
-	if (conn->state != BT_CONN_CONNECTED) {
-		goto fail;
-	}
-
-	hdr = net_buf_push(buf, sizeof(*hdr));
-	hdr->handle = sys_cpu_to_le16(bt_acl_handle_pack(conn->handle, flags));
-	hdr->len = sys_cpu_to_le16(buf->len - sizeof(*hdr));
-
-	bt_buf_set_type(buf, BT_BUF_ACL_OUT);
-
-	err = bt_send(buf);
-	if (err) {
-		BT_ERR("Unable to send to driver (err %d)", err);
-		goto fail;
-	}
-
-	conn->pending_pkts++;
-	return true;
-
-fail:
-	nano_fiber_sem_give(bt_conn_get_pkts(conn));
-	if (always_consume) {
-		net_buf_unref(buf);
-	}
-	return false;
+	nano_sem_give(&tx_sem);
 }
 
 static inline uint16_t conn_mtu(struct bt_conn *conn)
@@ -906,10 +924,62 @@ static inline uint16_t conn_mtu(struct bt_conn *conn)
 	return bt_dev.le.mtu;
 }
 
+void bt_conn_ref_destroy(struct net_buf *buf)
+{
+	struct net_buf *parent = ref_parent(buf);
+
+	nano_fifo_put(buf->free, buf);
+	net_buf_unref(parent);
+}
+
+struct net_buf *bt_conn_ref_frags(struct nano_fifo *fifo, struct net_buf *buf,
+				  uint16_t len)
+{
+	struct net_buf *head = NULL, *tail = NULL, *ref;
+	uint16_t ref_len;
+
+	for (; buf && len; buf = buf->frags) {
+		if (!buf->len) {
+			continue;
+		}
+
+		/* Only wait for the first reference, the others are just
+		 * left for the next call if the pool is empty.
+		 */
+		if (!head) {
+			ref = net_buf_get(fifo, 0);
+		} else {
+			ref = net_buf_get_timeout(fifo, 0, TICKS_NONE);
+		}
+
+		if (!ref) {
+			break;
+		}
+
+		ref_len = min(buf->len, len);
+
+		ref->data = buf->data;
+		ref->len = ref_len;
+		ref_parent(ref) = net_buf_ref(buf);
+
+		net_buf_pull(buf, ref_len);
+		len -= ref_len;
+
+		if (tail) {
+			tail->frags = ref;
+		} else {
+			head = ref;
+		}
+
+		tail = ref;
+	}
+
+	return head;
+}
+
 static struct net_buf *create_frag(struct bt_conn *conn, struct net_buf *buf)
 {
 	struct net_buf *frag;
-	uint16_t frag_len;
 
 	frag = bt_conn_create_pdu(&frag_buf, 0);
 
@@ -918,93 +988,294 @@ static struct net_buf *create_frag(struct bt_conn *conn, struct net_buf *buf)
 		return NULL;
 	}
 
-	frag_len = min(conn_mtu(conn), net_buf_tailroom(frag));
-
-	memcpy(net_buf_add(frag, frag_len), buf->data, frag_len);
-	net_buf_pull(buf, frag_len);
+	/* The fragment only holds the ACL header, the data is referenced */
+	frag->frags = bt_conn_ref_frags(&ref_buf, buf, conn_mtu(conn));
+	if (!frag->frags) {
+		net_buf_unref(frag);
+		return NULL;
+	}
 
 	return frag;
 }
 
-static bool send_buf(struct bt_conn *conn, struct net_buf *buf)
+static struct net_buf *conn_tx_dequeue(struct bt_conn *conn)
 {
-	struct net_buf *frag;
+#if defined(CONFIG_BLUETOOTH_L2CAP_DYNAMIC_CHANNEL)
+	struct nano_fifo *queues[] = { &conn->tx_queue, &conn->tx_dyn_queue };
+	static const uint8_t weights[] = {
+		CONFIG_BLUETOOTH_CONN_TX_FIXED_WEIGHT,
+		CONFIG_BLUETOOTH_CONN_TX_DYN_WEIGHT,
+	};
+	struct net_buf *buf;
+	int i;
 
-	BT_DBG("conn %p buf %p len %u", conn, buf, buf->len);
+	/* Serve the current queue until it used up its weight, then the
+	 * other one. The current queue gets another turn if the other one
+	 * has nothing to send.
+	 */
+	for (i = 0; i <= ARRAY_SIZE(queues); i++) {
+		if (conn->tx_chan_sent < weights[conn->tx_chan]) {
+			buf = net_buf_get_timeout(queues[conn->tx_chan], 0,
+						  TICKS_NONE);
+			if (buf) {
+				conn->tx_chan_sent++;
+				return buf;
+			}
+		}
 
-	/* Send directly if the packet fits the ACL MTU */
-	if (buf->len <= conn_mtu(conn)) {
-		return send_frag(conn, buf, BT_ACL_START_NO_FLUSH, false);
+		conn->tx_chan = (conn->tx_chan + 1) % ARRAY_SIZE(queues);
+		conn->tx_chan_sent = 0;
 	}
 
-	/* Create & enqueue first fragment */
-	frag = create_frag(conn, buf);
-	if (!frag) {
+	return NULL;
+#else
+	return net_buf_get_timeout(&conn->tx_queue, 0, TICKS_NONE);
+#endif /* CONFIG_BLUETOOTH_L2CAP_DYNAMIC_CHANNEL */
+}
+
+/* Check if a connection has data to send, fetching its next PDU */
+static bool conn_tx_pending(struct bt_conn *conn)
+{
+	if (conn->state != BT_CONN_CONNECTED) {
 		return false;
 	}
 
-	if (!send_frag(conn, frag, BT_ACL_START_NO_FLUSH, true)) {
+	if (!conn->tx_buf) {
+		conn->tx_buf = conn_tx_dequeue(conn);
+		if (!conn->tx_buf) {
+			return false;
+		}
+
+		conn->tx_acl_flags = BT_ACL_START_NO_FLUSH;
+		conn->tx_stats.pdus++;
+		conn->tx_stats.bytes += net_buf_frags_len(conn->tx_buf);
+	}
+
+	return true;
+}
+
+static void conn_tx_drop(struct bt_conn *conn)
+{
+	if (conn->tx_buf) {
+		net_buf_unref(conn->tx_buf);
+		conn->tx_buf = NULL;
+	}
+}
+
+/* Send the next ACL fragment of the current PDU of a connection. Returns
+ * false if the controller has no free buffer for it.
+ */
+static bool conn_tx_frag(struct bt_conn *conn)
+{
+	struct bt_hci_acl_hdr *hdr;
+	struct net_buf *frag;
+	uint16_t len;
+	int err;
+
+	if (!nano_fiber_sem_take(bt_conn_get_pkts(conn), TICKS_NONE)) {
 		return false;
 	}
 
-	/*
-	 * Send the fragments. For the last one simply use the original
-	 * buffer (which works since we've used net_buf_pull on it.
-	 */
-	while (buf->len > conn_mtu(conn)) {
-		frag = create_frag(conn, buf);
+	if (conn->tx_acl_flags == BT_ACL_START_NO_FLUSH &&
+	    net_buf_frags_len(conn->tx_buf) <= conn_mtu(conn)) {
+		/* The whole PDU fits, send the original buffer. Only done
+		 * for the first fragment since otherwise the header would
+		 * overwrite data still referenced by the previous one.
+		 */
+		frag = conn->tx_buf;
+		conn->tx_buf = NULL;
+	} else {
+		frag = create_frag(conn, conn->tx_buf);
 		if (!frag) {
-			return false;
+			goto fail;
 		}
 
-		if (!send_frag(conn, frag, BT_ACL_CONT, true)) {
-			return false;
+		if (!net_buf_frags_len(conn->tx_buf)) {
+			net_buf_unref(conn->tx_buf);
+			conn->tx_buf = NULL;
 		}
 	}
 
-	return send_frag(conn, buf, BT_ACL_CONT, false);
+	len = net_buf_frags_len(frag);
+
+	BT_DBG("conn %p buf %p len %u flags 0x%02x", conn, frag, len,
+	       conn->tx_acl_flags);
+
+	hdr = net_buf_push(frag, sizeof(*hdr));
+	hdr->handle = sys_cpu_to_le16(bt_acl_handle_pack(conn->handle,
+							 conn->tx_acl_flags));
+	hdr->len = sys_cpu_to_le16(len);
+
+	bt_buf_set_type(frag, BT_BUF_ACL_OUT);
+
+	conn->tx_acl_flags = BT_ACL_CONT;
+
+	err = bt_send(frag);
+	if (err) {
+		BT_ERR("Unable to send to driver (err %d)", err);
+		net_buf_unref(frag);
+		goto fail;
+	}
+
+	conn->pending_pkts++;
+	conn->tx_stats.frags++;
+	return true;
+
+fail:
+	/* The rest of the PDU cannot be sent anymore */
+	conn_tx_drop(conn);
+	nano_fiber_sem_give(bt_conn_get_pkts(conn));
+	return true;
 }
 
-static void conn_tx_fiber(int arg1, int arg2)
+/* Pick the connection to serve next: the highest priority one with data
+ * to send, round-robin among connections of equal priority. Connections
+ * whose controller buffers ran out are skipped.
+ */
+static struct bt_conn *conn_tx_next(uint32_t blocked)
 {
-	struct bt_conn *conn = (struct bt_conn *)arg1;
-	struct net_buf *buf;
+	struct bt_conn *next = NULL;
+	int i, idx;
 
-	BT_DBG("Started for handle %u", conn->handle);
+	for (i = 1; i <= ARRAY_SIZE(conns); i++) {
+		idx = (tx_last + i) % ARRAY_SIZE(conns);
 
-	while (conn->state == BT_CONN_CONNECTED) {
-		/* Get next ACL packet for connection */
-		buf = net_buf_get_timeout(&conn->tx_queue, 0, TICKS_UNLIMITED);
-		if (conn->state != BT_CONN_CONNECTED) {
-			net_buf_unref(buf);
-			break;
+		if ((blocked & BIT(idx)) ||
+		    !atomic_test_bit(conns[idx].flags, BT_CONN_TX) ||
+		    !conn_tx_pending(&conns[idx])) {
+			continue;
 		}
 
-		if (!send_buf(conn, buf)) {
-			net_buf_unref(buf);
+		if (!next || conns[idx].tx_prio > next->tx_prio) {
+			next = &conns[idx];
 		}
 	}
 
+	return next;
+}
+
+static void conn_tx_stop(struct bt_conn *conn)
+{
+	struct net_buf *buf;
+
 	BT_DBG("handle %u disconnected - cleaning up", conn->handle);
 
 	/* Give back any allocated buffers */
-	while ((buf = net_buf_get_timeout(&conn->tx_queue, 0, TICKS_NONE))) {
+	conn_tx_drop(conn);
+
+	while ((buf = conn_tx_dequeue(conn))) {
 		net_buf_unref(buf);
 	}
 
 	/* Return any unacknowledged packets */
-	if (conn->pending_pkts) {
-		while (conn->pending_pkts--) {
-			nano_fiber_sem_give(bt_conn_get_pkts(conn));
-		}
+	while (conn->pending_pkts) {
+		nano_fiber_sem_give(bt_conn_get_pkts(conn));
+		conn->pending_pkts--;
 	}
 
 	bt_conn_reset_rx_state(conn);
 
-	BT_DBG("handle %u exiting", conn->handle);
+	atomic_clear_bit(conn->flags, BT_CONN_TX);
 	bt_conn_unref(conn);
 }
 
+static void conn_tx_start(struct bt_conn *conn)
+{
+	/* Clean up after the previous link if the scheduler did not yet */
+	if (atomic_test_bit(conn->flags, BT_CONN_TX)) {
+		conn_tx_stop(conn);
+	}
+
+	nano_fifo_init(&conn->tx_queue);
+#if defined(CONFIG_BLUETOOTH_L2CAP_DYNAMIC_CHANNEL)
+	nano_fifo_init(&conn->tx_dyn_queue);
+	conn->tx_chan = 0;
+	conn->tx_chan_sent = 0;
+#endif /* CONFIG_BLUETOOTH_L2CAP_DYNAMIC_CHANNEL */
+
+	conn->tx_buf = NULL;
+	conn->tx_prio = 0;
+	conn->tx_weight = 1;
+	memset(&conn->tx_stats, 0, sizeof(conn->tx_stats));
+	conn->tx_start = sys_tick_get_32();
+
+	/* The scheduler keeps a reference until it has cleaned up */
+	bt_conn_ref(conn);
+	atomic_set_bit(conn->flags, BT_CONN_TX);
+}
+
+static void conn_tx_fiber(int arg1, int arg2)
+{
+	struct bt_conn *conn;
+	uint32_t blocked;
+	int i, sent;
+
+	ARG_UNUSED(arg1);
+	ARG_UNUSED(arg2);
+
+	while (1) {
+		/* Wait for queued data, freed controller buffers or a
+		 * disconnection.
+		 */
+		nano_fiber_sem_take(&tx_sem, TICKS_UNLIMITED);
+
+		for (i = 0; i < ARRAY_SIZE(conns); i++) {
+			conn = &conns[i];
+
+			if (atomic_test_bit(conn->flags, BT_CONN_TX) &&
+			    conn->state != BT_CONN_CONNECTED &&
+			    conn->state != BT_CONN_DISCONNECT) {
+				stack_analyze("conn tx stack", tx_fiber_stack,
+					      sizeof(tx_fiber_stack));
+				conn_tx_stop(conn);
+			}
+		}
+
+		/* Give each connection a turn of up to its weight in ACL
+		 * fragments until no one can send anymore.
+		 */
+		blocked = 0;
+		while ((conn = conn_tx_next(blocked))) {
+			tx_last = conn - conns;
+
+			for (sent = 0; sent < conn->tx_weight &&
+			     conn_tx_pending(conn); sent++) {
+				if (!conn_tx_frag(conn)) {
+					blocked |= BIT(tx_last);
+					break;
+				}
+			}
+		}
+	}
+}
+
+static void conn_timeout(struct nano_work *work)
+{
+	struct bt_conn *conn = CONTAINER_OF(work, struct bt_conn, timeout);
+
+	/* A fired delayed work stays attached to its workqueue, detach it
+	 * so that conn_timeout_cancel() does not drop the reference again.
+	 */
+	nano_delayed_work_cancel(&conn->timeout);
+
+	/* The connection may have been established meanwhile */
+	if (conn->state == BT_CONN_CONNECT) {
+		bt_conn_disconnect(conn, BT_HCI_ERR_REMOTE_USER_TERM_CONN);
+	}
+
+	bt_conn_unref(conn);
+}
+
+static void conn_timeout_cancel(struct bt_conn *conn)
+{
+	/* Drop the reference taken for the timeout unless it already
+	 * fired, in which case conn_timeout() drops it.
+	 */
+	if (!nano_delayed_work_cancel(&conn->timeout)) {
+		bt_conn_unref(conn);
+	}
+}
+
 struct bt_conn *bt_conn_add_le(const bt_addr_le_t *peer)
 {
 	struct bt_conn *conn = conn_new();
@@ -1022,22 +1293,11 @@ struct bt_conn *bt_conn_add_le(const bt_addr_le_t *peer)
 	conn->le.interval_min = BT_GAP_INIT_CONN_INT_MIN;
 	conn->le.interval_max = BT_GAP_INIT_CONN_INT_MAX;
 	nano_delayed_work_init(&conn->le.update_work, le_conn_update);
+	nano_delayed_work_init(&conn->timeout, conn_timeout);
 
 	return conn;
 }
 
-static void timeout_fiber(int arg1, int arg2)
-{
-	struct bt_conn *conn = (struct bt_conn *)arg1;
-
-	ARG_UNUSED(arg2);
-
-	conn->timeout = NULL;
-
-	bt_conn_disconnect(conn, BT_HCI_ERR_REMOTE_USER_TERM_CONN);
-	bt_conn_unref(conn);
-}
-
 void bt_conn_set_state(struct bt_conn *conn, bt_conn_state_t state)
 {
 	bt_conn_state_t old_state;
@@ -1062,12 +1322,8 @@ void bt_conn_set_state(struct bt_conn *conn, bt_conn_state_t state)
 		bt_conn_ref(conn);
 		break;
 	case BT_CONN_CONNECT:
-		if (conn->timeout) {
-			fiber_delayed_start_cancel(conn->timeout);
-			conn->timeout = NULL;
-
-			/* Drop the reference taken by timeout fiber */
-			bt_conn_unref(conn);
+		if (conn->type == BT_CONN_TYPE_LE) {
+			conn_timeout_cancel(conn);
 		}
 		break;
 	default:
@@ -1077,24 +1333,22 @@ void bt_conn_set_state(struct bt_conn *conn, bt_conn_state_t state)
 	/* Actions needed for entering the new state */
 	switch (conn->state) {
 	case BT_CONN_CONNECTED:
-		nano_fifo_init(&conn->tx_queue);
-		fiber_start(conn->stack, sizeof(conn->stack), conn_tx_fiber,
-			    (int)bt_conn_ref(conn), 0, 7, 0);
+		conn_tx_start(conn);
 
 		bt_l2cap_connected(conn);
 		notify_connected(conn);
 		break;
 	case BT_CONN_DISCONNECTED:
-		/* Notify disconnection and queue a dummy buffer to wake
-		 * up and stop the tx fiber for states where it was
-		 * running.
+		/* Notify disconnection and wake up the TX scheduler to
+		 * clean up after the connection for states where it was
+		 * served.
 		 */
 		if (old_state == BT_CONN_CONNECTED ||
 		    old_state == BT_CONN_DISCONNECT) {
 			bt_l2cap_disconnected(conn);
 			notify_disconnected(conn);
 
-			net_buf_put(&conn->tx_queue, net_buf_get(&dummy, 0));
+			bt_conn_tx_notify();
 		} else if (old_state == BT_CONN_CONNECT) {
 			/* conn->err will be set in this case */
 			notify_connected(conn);
@@ -1125,11 +1379,8 @@ void bt_conn_set_state(struct bt_conn *conn, bt_conn_state_t state)
 		}
 
 		/* Add LE Create Connection timeout */
-		conn->timeout = fiber_delayed_start(conn->stack,
-						    sizeof(conn->stack),
-						    timeout_fiber,
-						    (int)bt_conn_ref(conn),
-						    0, 7, 0, CONN_TIMEOUT);
+		bt_conn_ref(conn);
+		nano_delayed_work_submit(&conn->timeout, CONN_TIMEOUT);
 		break;
 	case BT_CONN_DISCONNECT:
 		break;
@@ -1259,6 +1510,33 @@ int bt_conn_get_info(const struct bt_conn *conn, struct bt_conn_info *info)
 	return -EINVAL;
 }
 
+int bt_conn_get_tx_stats(const struct bt_conn *conn,
+			 struct bt_conn_tx_stats *stats)
+{
+	*stats = conn->tx_stats;
+	stats->ticks = sys_tick_get_32() - conn->tx_start;
+
+	return 0;
+}
+
+int bt_conn_set_tx_priority(struct bt_conn *conn, uint8_t prio,
+			    uint8_t weight)
+{
+	if (!weight) {
+		return -EINVAL;
+	}
+
+	/* Scheduling parameters are reset when the link is established */
+	if (conn->state != BT_CONN_CONNECTED) {
+		return -ENOTCONN;
+	}
+
+	conn->tx_prio = prio;
+	conn->tx_weight = weight;
+
+	return 0;
+}
+
 static int bt_hci_disconnect(struct bt_conn *conn, uint8_t reason)
 {
 	struct net_buf *buf;
@@ -1286,13 +1564,7 @@ static int bt_hci_disconnect(struct bt_conn *conn, uint8_t reason)
 
 static int bt_hci_connect_le_cancel(struct bt_conn *conn)
 {
-	if (conn->timeout) {
-		fiber_delayed_start_cancel(conn->timeout);
-		conn->timeout = NULL;
-
-		/* Drop the reference took by timeout fiber */
-		bt_conn_unref(conn);
-	}
+	conn_timeout_cancel(conn);
 
 	return bt_hci_cmd_send(BT_HCI_OP_LE_CREATE_CONN_CANCEL, NULL);
 }
@@ -1658,7 +1930,11 @@ int bt_conn_init(void)
 	int err;
 
 	net_buf_pool_init(frag_pool);
-	net_buf_pool_init(dummy_pool);
+	net_buf_pool_init(ref_pool);
+
+	nano_sem_init(&tx_sem);
+	fiber_start(tx_fiber_stack, sizeof(tx_fiber_stack), conn_tx_fiber,
+		    0, 0, 7, 0);
 
 	bt_att_init();
 
@@ -33,6 +33,7 @@ enum {
 	BT_CONN_BR_PAIRING,		/* BR connection in pairing context */
 	BT_CONN_BR_NOBOND,		/* SSP no bond pairing tracker */
 	BT_CONN_BR_PAIRING_INITIATOR,	/* local host starts authentication */
+	BT_CONN_TX,			/* served by the TX scheduler */
 
 	/* Total number of flags - must be at the end of the enum */
 	BT_CONN_NUM_FLAGS,
@@ -97,8 +98,29 @@ struct bt_conn {
 	uint16_t		rx_len;
 	struct net_buf		*rx;
 
-	/* Queue for outgoing ACL data */
+	/* Queue for outgoing ACL data of fixed L2CAP channels */
 	struct nano_fifo	tx_queue;
+#if defined(CONFIG_BLUETOOTH_L2CAP_DYNAMIC_CHANNEL)
+	/* Queue for outgoing ACL data of dynamic L2CAP channels */
+	struct nano_fifo	tx_dyn_queue;
+#endif /* CONFIG_BLUETOOTH_L2CAP_DYNAMIC_CHANNEL */
+
+	/* TX scheduler state: PDU being fragmented with the ACL flags of
+	 * its next fragment, priority and fragments sent per round.
+	 */
+	struct net_buf		*tx_buf;
+	uint8_t			tx_acl_flags;
+	uint8_t			tx_prio;
+	uint8_t			tx_weight;
+#if defined(CONFIG_BLUETOOTH_L2CAP_DYNAMIC_CHANNEL)
+	/* Queue being served and the PDUs it sent in its turn */
+	uint8_t			tx_chan;
+	uint8_t			tx_chan_sent;
+#endif /* CONFIG_BLUETOOTH_L2CAP_DYNAMIC_CHANNEL */
+
+	/* TX statistics and the tick the connection was established */
+	struct bt_conn_tx_stats	tx_stats;
+	uint32_t		tx_start;
 
 	struct bt_keys		*keys;
 
@@ -112,8 +134,8 @@ struct bt_conn {
 
 	bt_conn_state_t		state;
 
-	/* Handle allowing to cancel timeout fiber */
-	nano_thread_id_t timeout;
+	/* LE Create Connection timeout */
+	struct nano_delayed_work timeout;
 
 	union {
 		struct bt_conn_le	le;
@@ -121,12 +143,6 @@ struct bt_conn {
 		struct bt_conn_br	br;
 #endif
 	};
-
-	/* Stack for TX fiber and timeout fiber.
-	 * Since these fibers don't overlap, one stack can be used by
-	 * both of them.
-	 */
-	BT_STACK(stack, 256);
 };
 
 /* Process incoming data for a connection */
@@ -135,6 +151,9 @@ void bt_conn_recv(struct bt_conn *conn, struct net_buf *buf, uint8_t flags);
 /* Send data over a connection */
 int bt_conn_send(struct bt_conn *conn, struct net_buf *buf);
 
+/* Wake up the TX scheduler, e.g. when controller buffers were freed */
+void bt_conn_tx_notify(void);
+
 /* Add a new LE connection */
 struct bt_conn *bt_conn_add_le(const bt_addr_le_t *peer);
 
@@ -185,6 +204,23 @@ void bt_conn_security_changed(struct bt_conn *conn);
 /* Prepare a PDU to be sent over a connection */
 struct net_buf *bt_conn_create_pdu(struct nano_fifo *fifo, size_t reserve);
 
+/* Pool of buffers referencing the data of other buffers. They have no
+ * storage of their own and keep the referenced buffer until freed.
+ */
+#define BT_CONN_REF_POOL(_name, _count, _fifo)				\
+	NET_BUF_POOL(_name, _count, 0, _fifo, bt_conn_ref_destroy,	\
+		     BT_BUF_USER_DATA_MIN + sizeof(struct net_buf *))
+
+void bt_conn_ref_destroy(struct net_buf *buf);
+
+/* Take up to len bytes from the front of a buffer chain without copying
+ * them. The data is pulled from the chain and returned as a chain of
+ * buffers from a BT_CONN_REF_POOL, which may hold less than len bytes
+ * if the pool runs low.
+ */
+struct net_buf *bt_conn_ref_frags(struct nano_fifo *fifo, struct net_buf *buf,
+				  uint16_t len);
+
 /* Initialize connection management */
 int bt_conn_init(void);
 
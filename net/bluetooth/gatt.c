@@ -46,76 +46,122 @@
 #define BT_DBG(fmt, ...)
 #endif
 
-static struct bt_gatt_attr *db;
+/* Registered attribute arrays, sorted by handle. Handles are strictly
+ * increasing within and across the arrays, which is what allows
+ * attributes to be looked up by handle without walking the database.
+ */
+struct gatt_db_range {
+	struct bt_gatt_attr *attrs;
+	size_t count;
+};
+
+#if defined(CONFIG_BLUETOOTH_GATT_DYNAMIC_DB)
+static struct gatt_db_range db[CONFIG_BLUETOOTH_GATT_DYNAMIC_DB_MAX_SERVICES];
+#else
+static struct gatt_db_range db[1];
+#endif /* CONFIG_BLUETOOTH_GATT_DYNAMIC_DB */
+static size_t db_count;
 
 #if defined(CONFIG_BLUETOOTH_GATT_CLIENT)
 static struct bt_gatt_subscribe_params *subscriptions;
 #endif /* CONFIG_BLUETOOTH_GATT_CLIENT */
 
-#if !defined(CONFIG_BLUETOOTH_GATT_DYNAMIC_DB)
-static size_t attr_count;
-#endif /* CONFIG_BLUETOOTH_GATT_DYNAMIC_DB */
+static bool gatt_is_ccc(const struct bt_gatt_attr *attr)
+{
+	/* Check attribute user_data must be of type struct _bt_gatt_ccc */
+	return !bt_uuid_cmp(attr->uuid, BT_UUID_GATT_CCC) &&
+	       attr->write == bt_gatt_attr_write_ccc;
+}
+
+/* Link each attribute to the CCC descriptor of its characteristic, which
+ * is found after the attribute and before the next characteristic.
+ */
+static void gatt_link_ccc(struct bt_gatt_attr *attrs, size_t count)
+{
+	size_t i, j;
+
+	for (i = 0; i < count; i++) {
+		attrs[i]._ccc = 0;
+
+		for (j = i + 1; j < count && j - i <= UINT8_MAX; j++) {
+			if (!bt_uuid_cmp(attrs[j].uuid, BT_UUID_GATT_CHRC)) {
+				break;
+			}
+
+			if (gatt_is_ccc(&attrs[j])) {
+				attrs[i]._ccc = j - i;
+				break;
+			}
+		}
+	}
+}
 
 int bt_gatt_register(struct bt_gatt_attr *attrs, size_t count)
 {
-#if defined(CONFIG_BLUETOOTH_GATT_DYNAMIC_DB)
-	struct bt_gatt_attr *last;
-#endif /* CONFIG_BLUETOOTH_GATT_DYNAMIC_DB */
+	struct gatt_db_range *range;
 	uint16_t handle;
+	size_t i;
 
 	if (!attrs || !count) {
 		return -EINVAL;
 	}
 
-#if !defined(CONFIG_BLUETOOTH_GATT_DYNAMIC_DB)
-	handle = 0;
-	db = attrs;
-	attr_count = count;
-#else
-	if (!db) {
-		db = attrs;
-		last = NULL;
-		handle = 0;
-		goto populate;
+#if defined(CONFIG_BLUETOOTH_GATT_DYNAMIC_DB)
+	if (db_count == ARRAY_SIZE(db)) {
+		BT_ERR("No space left in the GATT database index");
+		return -ENOMEM;
 	}
 
-	/* Fast forward to last attribute in the list */
-	for (last = db; last->_next;) {
-		last = last->_next;
+	if (db_count) {
+		range = &db[db_count - 1];
+		handle = range->attrs[range->count - 1].handle;
+	} else {
+		handle = 0;
 	}
-
-	handle = last->handle;
-	last->_next = attrs;
-
-populate:
+#else
+	handle = 0;
+	db_count = 0;
 #endif /* CONFIG_BLUETOOTH_GATT_DYNAMIC_DB */
-	/* Populate the handles and _next pointers */
-	for (; attrs && count; attrs++, count--) {
-		if (!attrs->handle) {
+
+	/* Populate the handles */
+	for (i = 0; i < count; i++) {
+		if (!attrs[i].handle) {
 			/* Allocate handle if not set already */
-			attrs->handle = ++handle;
-		} else if (attrs->handle > handle) {
+			attrs[i].handle = ++handle;
+		} else if (attrs[i].handle > handle) {
 			/* Use existing handle if valid */
-			handle = attrs->handle;
+			handle = attrs[i].handle;
 		} else {
 			/* Service has conflicting handles */
-#if defined(CONFIG_BLUETOOTH_GATT_DYNAMIC_DB)
-			last->_next = NULL;
-#endif
 			BT_ERR("Unable to register handle 0x%04x",
-			       attrs->handle);
+			       attrs[i].handle);
 			return -EINVAL;
 		}
+	}
 
 #if defined(CONFIG_BLUETOOTH_GATT_DYNAMIC_DB)
-		if (count > 1) {
-			attrs->_next = &attrs[1];
-		}
-#endif
+	/* Populate the _next pointers */
+	for (i = 0; i < count; i++) {
+		attrs[i]._next = (i + 1 < count) ? &attrs[i + 1] : NULL;
+	}
+
+	if (db_count) {
+		range = &db[db_count - 1];
+		range->attrs[range->count - 1]._next = attrs;
+	}
+#endif /* CONFIG_BLUETOOTH_GATT_DYNAMIC_DB */
+
+	gatt_link_ccc(attrs, count);
 
+	range = &db[db_count++];
+	range->attrs = attrs;
+	range->count = count;
+
+	for (i = 0; i < count; i++) {
 		BT_DBG("attr %p next %p handle 0x%04x uuid %s perm 0x%02x",
-		       attrs, bt_gatt_attr_next(attrs), attrs->handle,
-		       bt_uuid_str(attrs->uuid), attrs->perm);
+		       &attrs[i], bt_gatt_attr_next(&attrs[i]),
+		       attrs[i].handle, bt_uuid_str(attrs[i].uuid),
+		       attrs[i].perm);
 	}
 
 	return 0;
@@ -256,19 +302,84 @@ ssize_t bt_gatt_attr_read_chrc(struct bt_conn *conn,
 	return bt_gatt_attr_read(conn, attr, buf, len, offset, &pdu, value_len);
 }
 
+/* Find the first attribute with a handle not below the given one */
+static bool gatt_find(uint16_t handle, size_t *range_idx, size_t *attr_idx)
+{
+	const struct gatt_db_range *range;
+	size_t lo, hi, mid;
+
+	/* Registered arrays are few, find the one holding the handle */
+	lo = 0;
+	hi = db_count;
+	while (lo < hi) {
+		mid = (lo + hi) / 2;
+		range = &db[mid];
+
+		if (range->attrs[range->count - 1].handle < handle) {
+			lo = mid + 1;
+		} else {
+			hi = mid;
+		}
+	}
+
+	if (lo == db_count) {
+		return false;
+	}
+
+	*range_idx = lo;
+	range = &db[lo];
+
+	if (handle <= range->attrs[0].handle) {
+		*attr_idx = 0;
+		return true;
+	}
+
+	/* Handles are usually contiguous so try direct indexing first */
+	mid = handle - range->attrs[0].handle;
+	if (mid < range->count && range->attrs[mid].handle == handle) {
+		*attr_idx = mid;
+		return true;
+	}
+
+	lo = 0;
+	hi = range->count - 1;
+	while (lo < hi) {
+		mid = (lo + hi) / 2;
+
+		if (range->attrs[mid].handle < handle) {
+			lo = mid + 1;
+		} else {
+			hi = mid;
+		}
+	}
+
+	*attr_idx = lo;
+
+	return true;
+}
+
 void bt_gatt_foreach_attr(uint16_t start_handle, uint16_t end_handle,
 			  bt_gatt_attr_func_t func, void *user_data)
 {
 	const struct bt_gatt_attr *attr;
+	size_t r, i;
 
-	for (attr = db; attr; attr = bt_gatt_attr_next(attr)) {
-		/* Check if attribute handle is within range */
-		if (attr->handle < start_handle || attr->handle > end_handle) {
-			continue;
-		}
+	if (!gatt_find(start_handle, &r, &i)) {
+		return;
+	}
 
-		if (func(attr, user_data) == BT_GATT_ITER_STOP) {
-			break;
+	for (; r < db_count; r++, i = 0) {
+		for (; i < db[r].count; i++) {
+			attr = &db[r].attrs[i];
+
+			/* Handles are sorted so nothing follows in range */
+			if (attr->handle > end_handle) {
+				return;
+			}
+
+			if (func(attr, user_data) == BT_GATT_ITER_STOP) {
+				return;
+			}
 		}
 	}
 }
@@ -278,8 +389,12 @@ struct bt_gatt_attr *bt_gatt_attr_next(const struct bt_gatt_attr *attr)
 #if defined(CONFIG_BLUETOOTH_GATT_DYNAMIC_DB)
 	return attr->_next;
 #else
-	return ((attr < db || attr > &db[attr_count - 2]) ? NULL :
-		(struct bt_gatt_attr *)&attr[1]);
+	if (!db_count) {
+		return NULL;
+	}
+
+	return ((attr < db[0].attrs || attr > &db[0].attrs[db[0].count - 2]) ?
+		NULL : (struct bt_gatt_attr *)&attr[1]);
 #endif /* CONFIG_BLUETOOTH_GATT_DYNAMIC_DB */
 }
 
@@ -493,23 +608,24 @@ static int att_indicate(struct bt_conn *conn,
 	return gatt_send(conn, buf, gatt_indicate_rsp, params, NULL);
 }
 
-static uint8_t notify_cb(const struct bt_gatt_attr *attr, void *user_data)
+static const struct bt_gatt_attr *gatt_ccc_attr(const struct bt_gatt_attr *attr)
+{
+	if (gatt_is_ccc(attr)) {
+		return attr;
+	}
+
+	return attr->_ccc ? &attr[attr->_ccc] : NULL;
+}
+
+static void gatt_notify_ccc(const struct bt_gatt_attr *attr,
+			    struct notify_data *data)
 {
-	struct notify_data *data = user_data;
 	struct _bt_gatt_ccc *ccc;
 	size_t i;
 
-	if (bt_uuid_cmp(attr->uuid, BT_UUID_GATT_CCC)) {
-		/* Stop if we reach the next characteristic */
-		if (!bt_uuid_cmp(attr->uuid, BT_UUID_GATT_CHRC)) {
-			return BT_GATT_ITER_STOP;
-		}
-		return BT_GATT_ITER_CONTINUE;
-	}
-
-	/* Check attribute user_data must be of type struct _bt_gatt_ccc */
-	if (attr->write != bt_gatt_attr_write_ccc) {
-		return BT_GATT_ITER_CONTINUE;
+	attr = gatt_ccc_attr(attr);
+	if (!attr) {
+		return;
 	}
 
 	ccc = attr->user_data;
@@ -538,11 +654,9 @@ static uint8_t notify_cb(const struct bt_gatt_attr *attr, void *user_data)
 		bt_conn_unref(conn);
 
 		if (err < 0) {
-			return BT_GATT_ITER_STOP;
+			return;
 		}
 	}
-
-	return BT_GATT_ITER_CONTINUE;
 }
 
 int bt_gatt_notify(struct bt_conn *conn, const struct bt_gatt_attr *attr,
@@ -563,7 +677,7 @@ int bt_gatt_notify(struct bt_conn *conn, const struct bt_gatt_attr *attr,
 	nfy.data = data;
 	nfy.len = len;
 
-	bt_gatt_foreach_attr(attr->handle, 0xffff, notify_cb, &nfy);
+	gatt_notify_ccc(attr, &nfy);
 
 	return 0;
 }
@@ -584,7 +698,7 @@ int bt_gatt_indicate(struct bt_conn *conn,
 	nfy.type = BT_GATT_CCC_INDICATE;
 	nfy.params = params;
 
-	bt_gatt_foreach_attr(params->attr->handle, 0xffff, notify_cb, &nfy);
+	gatt_notify_ccc(params->attr, &nfy);
 
 	return 0;
 }
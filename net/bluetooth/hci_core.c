@@ -75,6 +75,29 @@ const struct bt_storage *bt_storage;
 
 static bt_le_scan_cb_t *scan_dev_found_cb;
 
+#if CONFIG_BLUETOOTH_SCAN_DUP_CACHE_SIZE > 0
+/* Recently reported advertisers, used to filter duplicates the
+ * controller lets through.
+ */
+static struct adv_dup {
+	bt_addr_le_t addr;
+	uint8_t evt_type;
+	uint32_t hash;
+} adv_dups[CONFIG_BLUETOOTH_SCAN_DUP_CACHE_SIZE];
+static uint8_t adv_dup_count;
+static uint8_t adv_dup_next;
+static bool adv_dup_filter;
+#endif /* CONFIG_BLUETOOTH_SCAN_DUP_CACHE_SIZE > 0 */
+
+#if defined(CONFIG_BLUETOOTH_RX_STATS)
+static struct bt_rx_stats rx_stats;
+static atomic_t rx_evt_depth;
+static atomic_t rx_bulk_depth;
+
+/* Enqueue timestamp, stored after the buffer type in user data */
+#define rx_stamp(buf) (*(uint32_t *)((uint8_t *)net_buf_user_data(buf) + 4))
+#endif /* CONFIG_BLUETOOTH_RX_STATS */
+
 static uint8_t pub_key[64];
 static struct bt_pub_key_cb *pub_key_cb;
 static bt_dh_key_cb_t dh_key_cb;
@@ -568,6 +591,9 @@ static void hci_num_completed_packets(struct net_buf *buf)
 
 		bt_conn_unref(conn);
 	}
+
+	/* Let the TX scheduler use the freed controller buffers */
+	bt_conn_tx_notify();
 }
 
 static int hci_le_create_conn(const struct bt_conn *conn)
@@ -622,7 +648,6 @@ static void hci_disconn_complete(struct net_buf *buf)
 	stack_analyze("rx stack", rx_fiber_stack, sizeof(rx_fiber_stack));
 	stack_analyze("cmd tx stack", cmd_tx_fiber_stack,
 		      sizeof(cmd_tx_fiber_stack));
-	stack_analyze("conn tx stack", conn->stack, sizeof(conn->stack));
 
 	bt_conn_set_state(conn, BT_CONN_DISCONNECTED);
 	conn->handle = 0;
@@ -2484,6 +2509,62 @@ int bt_le_scan_update(bool fast_scan)
 #endif /* CONFIG_BLUETOOTH_CENTRAL */
 }
 
+#if CONFIG_BLUETOOTH_SCAN_DUP_CACHE_SIZE > 0
+static void adv_dup_reset(bool filter)
+{
+	adv_dup_count = 0;
+	adv_dup_next = 0;
+	adv_dup_filter = filter;
+}
+
+/* Returns true if the report was seen recently, otherwise remembers it */
+static bool adv_dup_check(const struct bt_hci_ev_le_advertising_info *info)
+{
+	uint32_t hash = 2166136261u;
+	struct adv_dup *dup;
+	int i;
+
+	if (!adv_dup_filter) {
+		return false;
+	}
+
+	/* FNV-1a over the advertising data */
+	for (i = 0; i < info->length; i++) {
+		hash = (hash ^ info->data[i]) * 16777619u;
+	}
+
+	for (i = 0; i < adv_dup_count; i++) {
+		dup = &adv_dups[i];
+
+		if (dup->hash == hash && dup->evt_type == info->evt_type &&
+		    !bt_addr_le_cmp(&dup->addr, &info->addr)) {
+#if defined(CONFIG_BLUETOOTH_RX_STATS)
+			rx_stats.adv_dups++;
+#endif /* CONFIG_BLUETOOTH_RX_STATS */
+			return true;
+		}
+	}
+
+	dup = &adv_dups[adv_dup_next];
+	adv_dup_next = (adv_dup_next + 1) % ARRAY_SIZE(adv_dups);
+	if (adv_dup_count < ARRAY_SIZE(adv_dups)) {
+		adv_dup_count++;
+	}
+
+	bt_addr_le_copy(&dup->addr, &info->addr);
+	dup->evt_type = info->evt_type;
+	dup->hash = hash;
+
+	return false;
+}
+#else
+static inline bool
+adv_dup_check(const struct bt_hci_ev_le_advertising_info *info)
+{
+	return false;
+}
+#endif /* CONFIG_BLUETOOTH_SCAN_DUP_CACHE_SIZE > 0 */
+
 static void le_adv_report(struct net_buf *buf)
 {
 	uint8_t num_reports = net_buf_pull_u8(buf);
@@ -2506,7 +2587,7 @@ static void le_adv_report(struct net_buf *buf)
 
 		addr = find_id_addr(&info->addr);
 
-		if (scan_dev_found_cb) {
+		if (scan_dev_found_cb && !adv_dup_check(info)) {
 			struct net_buf_simple_state state;
 
 			net_buf_simple_save(&buf->b, &state);
@@ -3202,11 +3283,123 @@ int bt_send(struct net_buf *buf)
 {
 	BT_DBG("buf %p len %u type %u", buf, buf->len, bt_buf_get_type(buf));
 
-	bt_monitor_send(bt_monitor_opcode(buf), buf->data, buf->len);
+	bt_monitor_send_buf(bt_monitor_opcode(buf), buf);
 
 	return bt_dev.drv->send(buf);
 }
 
+#if defined(CONFIG_BLUETOOTH_RX_STATS)
+static void rx_stats_queued(struct bt_rx_path_stats *stats, atomic_t *depth,
+			    struct net_buf *buf)
+{
+	atomic_val_t cur = atomic_inc(depth) + 1;
+
+	if (cur > stats->max_depth) {
+		stats->max_depth = cur;
+	}
+
+	rx_stamp(buf) = sys_cycle_get_32();
+}
+
+static void rx_stats_processed(struct bt_rx_path_stats *stats,
+			       atomic_t *depth, struct net_buf *buf)
+{
+	uint32_t us;
+	int bucket;
+
+	atomic_dec(depth);
+
+	us = SYS_CLOCK_HW_CYCLES_TO_NS(sys_cycle_get_32() - rx_stamp(buf)) /
+	     NSEC_PER_USEC;
+	bucket = min(find_msb_set(us), BT_RX_STATS_BUCKETS - 1);
+
+	stats->count++;
+	stats->latency[bucket]++;
+}
+#endif /* CONFIG_BLUETOOTH_RX_STATS */
+
+int bt_rx_stats_get(struct bt_rx_stats *stats)
+{
+#if defined(CONFIG_BLUETOOTH_RX_STATS)
+	int key = irq_lock();
+
+	memcpy(stats, &rx_stats, sizeof(*stats));
+	stats->evt.depth = atomic_get(&rx_evt_depth);
+	stats->bulk.depth = atomic_get(&rx_bulk_depth);
+
+	irq_unlock(key);
+
+	return 0;
+#else
+	return -ENOTSUP;
+#endif /* CONFIG_BLUETOOTH_RX_STATS */
+}
+
+int bt_rx_stats_reset(void)
+{
+#if defined(CONFIG_BLUETOOTH_RX_STATS)
+	int key = irq_lock();
+
+	memset(&rx_stats, 0, sizeof(rx_stats));
+	rx_stats.evt.max_depth = atomic_get(&rx_evt_depth);
+	rx_stats.bulk.max_depth = atomic_get(&rx_bulk_depth);
+
+	irq_unlock(key);
+
+	return 0;
+#else
+	return -ENOTSUP;
+#endif /* CONFIG_BLUETOOTH_RX_STATS */
+}
+
+bool bt_hci_evt_is_bulk(struct net_buf *buf)
+{
+	struct bt_hci_evt_hdr *hdr = (void *)buf->data;
+	struct bt_hci_evt_le_meta_event *meta;
+
+	/* Only the events which refer to no link may overtake the others.
+	 * The events of a link, whether they carry its handle or its peer
+	 * address, only make sense between its Connection Complete and its
+	 * Disconnection Complete, and a controller may reuse the handle of
+	 * a disconnected link right away. They are handled in the order
+	 * they are received, and in order with the ACL data of the link.
+	 */
+	switch (hdr->evt) {
+#if defined(CONFIG_BLUETOOTH_BREDR)
+	case BT_HCI_EVT_INQUIRY_COMPLETE:
+	case BT_HCI_EVT_REMOTE_NAME_REQ_COMPLETE:
+		return false;
+#endif /* CONFIG_BLUETOOTH_BREDR */
+	case BT_HCI_EVT_LE_META_EVENT:
+		if (buf->len < sizeof(*hdr) + sizeof(*meta)) {
+			return false;
+		}
+
+		meta = (void *)(buf->data + sizeof(*hdr));
+
+		return meta->subevent != BT_HCI_EVT_LE_P256_PUBLIC_KEY_COMPLETE;
+	default:
+		return true;
+	}
+}
+
+static void rx_queue_put(struct net_buf *buf, bool bulk)
+{
+	if (bulk) {
+#if defined(CONFIG_BLUETOOTH_RX_STATS)
+		rx_stats_queued(&rx_stats.bulk, &rx_bulk_depth, buf);
+#endif /* CONFIG_BLUETOOTH_RX_STATS */
+		net_buf_put(&bt_dev.rx_bulk_queue, buf);
+	} else {
+#if defined(CONFIG_BLUETOOTH_RX_STATS)
+		rx_stats_queued(&rx_stats.evt, &rx_evt_depth, buf);
+#endif /* CONFIG_BLUETOOTH_RX_STATS */
+		net_buf_put(&bt_dev.rx_queue, buf);
+	}
+
+	nano_sem_give(&bt_dev.rx_sem);
+}
+
 /* Interface to HCI driver layer */
 
 int bt_recv(struct net_buf *buf)
@@ -3230,7 +3423,7 @@ int bt_recv(struct net_buf *buf)
 	}
 
 	if (bt_buf_get_type(buf) == BT_BUF_ACL_IN) {
-		net_buf_put(&bt_dev.rx_queue, buf);
+		rx_queue_put(buf, true);
 		return 0;
 	}
 
@@ -3269,7 +3462,7 @@ int bt_recv(struct net_buf *buf)
 		}
 #endif /* CONFIG_BLUETOOTH_HOST_BUFFERS */
 
-		net_buf_put(&bt_dev.rx_queue, net_buf_ref(buf));
+		rx_queue_put(net_buf_ref(buf), bt_hci_evt_is_bulk(buf));
 		break;
 	}
 
@@ -3380,6 +3573,7 @@ static int bt_init(void)
 static void hci_rx_fiber(bt_ready_cb_t ready_cb)
 {
 	struct net_buf *buf;
+	int batch = 0;
 
 	BT_DBG("started");
 
@@ -3388,8 +3582,24 @@ static void hci_rx_fiber(bt_ready_cb_t ready_cb)
 	}
 
 	while (1) {
-		BT_DBG("calling fifo_get_wait");
-		buf = net_buf_get_timeout(&bt_dev.rx_queue, 0, TICKS_UNLIMITED);
+		BT_DBG("calling sem_take_wait");
+		nano_fiber_sem_take(&bt_dev.rx_sem, TICKS_UNLIMITED);
+
+		/* Events which refer to no link go first, so that a burst
+		 * of ACL data or advertising reports does not delay them.
+		 */
+		buf = net_buf_get_timeout(&bt_dev.rx_queue, 0, TICKS_NONE);
+		if (buf) {
+#if defined(CONFIG_BLUETOOTH_RX_STATS)
+			rx_stats_processed(&rx_stats.evt, &rx_evt_depth, buf);
+#endif /* CONFIG_BLUETOOTH_RX_STATS */
+		} else {
+			buf = net_buf_get_timeout(&bt_dev.rx_bulk_queue, 0,
+						  TICKS_NONE);
+#if defined(CONFIG_BLUETOOTH_RX_STATS)
+			rx_stats_processed(&rx_stats.bulk, &rx_bulk_depth, buf);
+#endif /* CONFIG_BLUETOOTH_RX_STATS */
+		}
 
 		BT_DBG("buf %p type %u len %u", buf, bt_buf_get_type(buf),
 		       buf->len);
@@ -3409,10 +3619,13 @@ static void hci_rx_fiber(bt_ready_cb_t ready_cb)
 			break;
 		}
 
-		/* Make sure we don't hog the CPU if the rx_queue never
-		 * gets empty.
+		/* Make sure we don't hog the CPU if the RX queues never
+		 * get empty, but avoid a context switch for every buffer.
 		 */
-		fiber_yield();
+		if (++batch >= CONFIG_BLUETOOTH_RX_BATCH) {
+			batch = 0;
+			fiber_yield();
+		}
 	}
 }
 
@@ -3455,6 +3668,8 @@ int bt_enable(bt_ready_cb_t cb)
 
 	/* RX fiber */
 	nano_fifo_init(&bt_dev.rx_queue);
+	nano_fifo_init(&bt_dev.rx_bulk_queue);
+	nano_sem_init(&bt_dev.rx_sem);
 	fiber_start(rx_fiber_stack, sizeof(rx_fiber_stack),
 		    (nano_fiber_entry_t)hci_rx_fiber, (int)cb, 0, 7, 0);
 
@@ -3716,6 +3931,10 @@ int bt_le_scan_start(const struct bt_le_scan_param *param, bt_le_scan_cb_t cb)
 		}
 	}
 
+#if CONFIG_BLUETOOTH_SCAN_DUP_CACHE_SIZE > 0
+	adv_dup_reset(param->filter_dup == BT_HCI_LE_SCAN_FILTER_DUP_ENABLE);
+#endif /* CONFIG_BLUETOOTH_SCAN_DUP_CACHE_SIZE > 0 */
+
 	err = start_le_scan(param->type, param->interval, param->window,
 			    param->filter_dup);
 	if (err) {
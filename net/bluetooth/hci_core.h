@@ -101,14 +101,19 @@ struct bt_dev {
 	/* Last sent HCI command */
 	struct net_buf		*sent_cmd;
 
-	/* Queue for incoming HCI events & ACL data */
+	/* Queue for incoming HCI events. Command Complete/Status and
+	 * Number of Completed Packets never get here, they are handled
+	 * directly from bt_recv().
+	 */
 	struct nano_fifo	rx_queue;
 
-	/* Queue for high priority HCI events which may unlock waiters
-	 * in other fibers. Such events include Number of Completed
-	 * Packets, as well as the Command Complete/Status events.
+	/* Queue for incoming ACL data, advertising reports and the
+	 * events which must stay in order with ACL data.
 	 */
-	struct nano_fifo	rx_prio_queue;
+	struct nano_fifo	rx_bulk_queue;
+
+	/* Counts the buffers queued in both RX queues */
+	struct nano_sem		rx_sem;
 
 	/* Queue for outgoing HCI commands */
 	struct nano_fifo	cmd_tx_queue;
@@ -194,3 +199,8 @@ bool bt_addr_le_is_bonded(const bt_addr_le_t *addr);
 int bt_send(struct net_buf *buf);
 
 uint16_t bt_hci_get_cmd_opcode(struct net_buf *buf);
+
+/* Check if an HCI event goes to the bulk RX queue, in order with ACL data,
+ * rather than ahead of it.
+ */
+bool bt_hci_evt_is_bulk(struct net_buf *buf);
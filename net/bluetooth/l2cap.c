@@ -91,11 +91,19 @@ static NET_BUF_POOL(le_sig_pool, CONFIG_BLUETOOTH_MAX_CONN,
 		    BT_BUF_USER_DATA_MIN);
 
 #if defined(CONFIG_BLUETOOTH_L2CAP_DYNAMIC_CHANNEL)
-/* Pool for outgoing LE data packets, MTU is 23 */
+/* Segments queued per connection before the sender has to wait */
+#define L2CAP_LE_SEG_COUNT	(CONFIG_BLUETOOTH_MAX_CONN * 2)
+
+/* Pool for the headers of outgoing LE data segments */
 static struct nano_fifo le_data;
-static NET_BUF_POOL(le_data_pool, CONFIG_BLUETOOTH_MAX_CONN,
-		    BT_L2CAP_BUF_SIZE(L2CAP_LE_MIN_MTU), &le_data, NULL,
+static NET_BUF_POOL(le_data_pool, L2CAP_LE_SEG_COUNT,
+		    BT_L2CAP_BUF_SIZE(BT_L2CAP_SDU_HDR_LEN), &le_data, NULL,
 		    BT_BUF_USER_DATA_MIN);
+
+/* Pool for references to the SDU data of outgoing segments */
+static struct nano_fifo le_data_ref;
+static BT_CONN_REF_POOL(le_data_ref_pool, L2CAP_LE_SEG_COUNT * 2,
+			&le_data_ref);
 #endif /* CONFIG_BLUETOOTH_L2CAP_DYNAMIC_CHANNEL */
 
 /* L2CAP signalling channel specific context */
@@ -358,7 +366,7 @@ void bt_l2cap_send(struct bt_conn *conn, uint16_t cid, struct net_buf *buf)
 	struct bt_l2cap_hdr *hdr;
 
 	hdr = net_buf_push(buf, sizeof(*hdr));
-	hdr->len = sys_cpu_to_le16(buf->len - sizeof(*hdr));
+	hdr->len = sys_cpu_to_le16(net_buf_frags_len(buf) - sizeof(*hdr));
 	hdr->cid = sys_cpu_to_le16(cid);
 
 	bt_conn_send(conn, buf);
@@ -951,20 +959,49 @@ static void l2cap_recv(struct bt_l2cap_chan *chan, struct net_buf *buf)
 }
 
 #if defined(CONFIG_BLUETOOTH_L2CAP_DYNAMIC_CHANNEL)
+/* Number of received buffers held by a segmented SDU being reassembled */
+static uint16_t l2cap_chan_held_bufs(struct bt_l2cap_le_chan *chan)
+{
+	struct net_buf *frag;
+	uint16_t held = 0;
+
+	/* A channel buffer holds a copy of the segments */
+	if (chan->chan.ops->alloc_buf) {
+		return 0;
+	}
+
+	for (frag = chan->_sdu; frag; frag = frag->frags) {
+		held++;
+	}
+
+	return held;
+}
+
 static void l2cap_chan_update_credits(struct bt_l2cap_le_chan *chan)
 {
 	struct net_buf *buf;
 	struct bt_l2cap_sig_hdr *hdr;
 	struct bt_l2cap_le_credits *ev;
-	uint16_t credits;
+	uint16_t credits, held;
+
+	/* Every credit lets the peer fill an ACL buffer: the credits given
+	 * and the buffers held by the SDU being reassembled must leave one
+	 * ACL buffer free, or the driver would wait for one forever.
+	 */
+	held = l2cap_chan_held_bufs(chan);
 
 	/* Only give more credits if it went bellow the defined threshold */
-	if (chan->rx.credits.nsig > L2CAP_LE_CREDITS_THRESHOLD) {
+	if (chan->rx.credits.nsig &&
+	    chan->rx.credits.nsig + held > L2CAP_LE_CREDITS_THRESHOLD) {
+		goto done;
+	}
+
+	if (chan->rx.credits.nsig + held >= L2CAP_LE_MAX_CREDITS) {
 		goto done;
 	}
 
 	/* Restore credits */
-	credits = L2CAP_LE_MAX_CREDITS - chan->rx.credits.nsig;
+	credits = L2CAP_LE_MAX_CREDITS - held - chan->rx.credits.nsig;
 	l2cap_chan_rx_give_credits(chan, credits);
 
 	buf = bt_l2cap_create_pdu(&le_sig);
@@ -991,22 +1028,55 @@ done:
 static void l2cap_chan_le_recv_sdu(struct bt_l2cap_le_chan *chan,
 				   struct net_buf *buf)
 {
-	BT_DBG("chan %p len %u sdu len %u", chan, buf->len, chan->_sdu->len);
+	size_t len = net_buf_frags_len(buf);
+	size_t sdu_len = net_buf_frags_len(chan->_sdu);
+	struct net_buf *last, *frag;
+
+	BT_DBG("chan %p len %u sdu len %u", chan, len, sdu_len);
 
-	if (chan->_sdu->len + buf->len > chan->_sdu_len) {
+	if (sdu_len + len > chan->_sdu_len) {
 		BT_ERR("SDU length mismatch");
 		bt_l2cap_chan_disconnect(&chan->chan);
 		return;
 	}
 
-	memcpy(net_buf_add(chan->_sdu, buf->len), buf->data, buf->len);
+	last = net_buf_frag_last(chan->_sdu);
 
-	if (chan->_sdu->len == chan->_sdu_len) {
+	if (chan->chan.ops->alloc_buf) {
+		for (frag = buf; frag; frag = frag->frags) {
+			if (frag->len > net_buf_tailroom(chan->_sdu)) {
+				BT_ERR("Not enough buffer space for SDU");
+				bt_l2cap_chan_disconnect(&chan->chan);
+				return;
+			}
+
+			memcpy(net_buf_add(chan->_sdu, frag->len), frag->data,
+			       frag->len);
+		}
+	} else if (len <= net_buf_tailroom(last)) {
+		/* Small segments are packed into the buffers already held,
+		 * so that the SDU holds as few ACL buffers as possible.
+		 */
+		for (frag = buf; frag; frag = frag->frags) {
+			memcpy(net_buf_add(last, frag->len), frag->data,
+			       frag->len);
+		}
+	} else {
+		/* Chain the segment to the SDU instead of copying it */
+		last->frags = net_buf_ref(buf);
+	}
+
+	if (sdu_len + len == chan->_sdu_len) {
 		/* Receiving complete SDU, notify channel and reset SDU buf */
 		chan->chan.ops->recv(&chan->chan, chan->_sdu);
 		net_buf_unref(chan->_sdu);
 		chan->_sdu = NULL;
 		chan->_sdu_len = 0;
+	} else if (l2cap_chan_held_bufs(chan) >= L2CAP_LE_MAX_CREDITS) {
+		/* No credit could be given for the rest of the SDU */
+		BT_ERR("SDU too big to be received without alloc_buf");
+		bt_l2cap_chan_disconnect(&chan->chan);
+		return;
 	}
 
 	l2cap_chan_update_credits(chan);
@@ -1029,11 +1099,18 @@ static void l2cap_chan_le_recv(struct bt_l2cap_le_chan *chan,
 		return;
 	}
 
+	if (buf->len < BT_L2CAP_SDU_HDR_LEN) {
+		BT_ERR("Too small first SDU segment");
+		bt_l2cap_chan_disconnect(&chan->chan);
+		return;
+	}
+
 	sdu_len = net_buf_pull_le16(buf);
 
-	BT_DBG("chan %p len %u sdu_len %u", chan, buf->len, sdu_len);
+	BT_DBG("chan %p len %u sdu_len %u", chan, net_buf_frags_len(buf),
+	       sdu_len);
 
-	if (sdu_len > chan->rx.mtu) {
+	if (sdu_len > chan->rx.mtu || net_buf_frags_len(buf) > sdu_len) {
 		BT_ERR("Invalid SDU length");
 		bt_l2cap_chan_disconnect(&chan->chan);
 		return;
@@ -1052,6 +1129,16 @@ static void l2cap_chan_le_recv(struct bt_l2cap_le_chan *chan,
 		return;
 	}
 
+	/* Without a channel buffer a segmented SDU is passed on as a chain
+	 * of the received segments.
+	 */
+	if (net_buf_frags_len(buf) < sdu_len) {
+		chan->_sdu = net_buf_ref(buf);
+		chan->_sdu_len = sdu_len;
+		l2cap_chan_update_credits(chan);
+		return;
+	}
+
 	chan->chan.ops->recv(&chan->chan, buf);
 
 	l2cap_chan_update_credits(chan);
@@ -1204,6 +1291,7 @@ void bt_l2cap_init(void)
 	net_buf_pool_init(le_sig_pool);
 #if defined(CONFIG_BLUETOOTH_L2CAP_DYNAMIC_CHANNEL)
 	net_buf_pool_init(le_data_pool);
+	net_buf_pool_init(le_data_ref_pool);
 #endif /* CONFIG_BLUETOOTH_L2CAP_DYNAMIC_CHANNEL */
 
 	bt_l2cap_le_fixed_chan_register(&chan);
@@ -1382,10 +1470,13 @@ static struct net_buf *l2cap_chan_create_seg(struct bt_l2cap_le_chan *ch,
 {
 	struct net_buf *seg;
 	uint16_t headroom;
-	uint16_t len;
+	size_t len = net_buf_frags_len(buf);
 
-	/* Segment if data (+ data headroom) is bigger than MPS */
-	if (buf->len + sdu_hdr_len > ch->tx.mps) {
+	/* Segment if data (+ data headroom) is bigger than MPS. Only the
+	 * first segment may use the headroom of the SDU, later ones would
+	 * overwrite data still referenced by the previous segment.
+	 */
+	if (!sdu_hdr_len || len + sdu_hdr_len > ch->tx.mps) {
 		goto segment;
 	}
 
@@ -1394,10 +1485,7 @@ static struct net_buf *l2cap_chan_create_seg(struct bt_l2cap_le_chan *ch,
 
 	/* Check if original buffer has enough headroom */
 	if (net_buf_headroom(buf) >= headroom) {
-		if (sdu_hdr_len) {
-			/* Push SDU length if set */
-			net_buf_push_le16(buf, buf->len);
-		}
+		net_buf_push_le16(buf, len);
 		return net_buf_ref(buf);
 	}
 
@@ -1408,14 +1496,18 @@ segment:
 	}
 
 	if (sdu_hdr_len) {
-		net_buf_add_le16(seg, buf->len);
+		net_buf_add_le16(seg, len);
 	}
 
-	len = min(min(buf->len, L2CAP_LE_MIN_MTU - sdu_hdr_len), ch->tx.mps);
-	memcpy(net_buf_add(seg, len), buf->data, len);
-	net_buf_pull(buf, len);
+	/* The segment only holds the headers, the data is referenced */
+	seg->frags = bt_conn_ref_frags(&le_data_ref, buf,
+				       ch->tx.mps - sdu_hdr_len);
+	if (!seg->frags) {
+		net_buf_unref(seg);
+		return NULL;
+	}
 
-	BT_DBG("ch %p seg %p len %u", ch, seg, seg->len);
+	BT_DBG("ch %p seg %p len %u", ch, seg, net_buf_frags_len(seg));
 
 	return seg;
 }
@@ -1439,10 +1531,11 @@ static int l2cap_chan_le_send(struct bt_l2cap_le_chan *ch, struct net_buf *buf,
 		return -ECONNRESET;
 	}
 
-	BT_DBG("ch %p cid 0x%04x len %u credits %u", ch, ch->tx.cid,
-	       buf->len, ch->tx.credits.nsig);
+	/* Only count SDU data */
+	len = net_buf_frags_len(buf) - sdu_hdr_len;
 
-	len = buf->len;
+	BT_DBG("ch %p cid 0x%04x len %u credits %u", ch, ch->tx.cid,
+	       len, ch->tx.credits.nsig);
 
 	bt_l2cap_send(ch->chan.conn, ch->tx.cid, buf);
 
@@ -1454,12 +1547,12 @@ static int l2cap_chan_le_send_sdu(struct bt_l2cap_le_chan *ch,
 {
 	int ret, sent, total_len;
 
-	if (buf->len > ch->tx.mtu) {
+	total_len = net_buf_frags_len(buf);
+
+	if (total_len > ch->tx.mtu) {
 		return -EMSGSIZE;
 	}
 
-	total_len = buf->len;
-
 	/* Add SDU length for the first segment */
 	ret = l2cap_chan_le_send(ch, buf, BT_L2CAP_SDU_HDR_LEN);
 	if (ret < 0) {
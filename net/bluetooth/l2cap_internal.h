@@ -25,6 +25,9 @@
 #define BT_L2CAP_CID_LE_SIG		0x0005
 #define BT_L2CAP_CID_SMP		0x0006
 
+/* First CID of dynamically allocated channels */
+#define BT_L2CAP_CID_DYN_START		0x0040
+
 /* Supported BR/EDR fixed channels mask (first octet) */
 #define BT_L2CAP_MASK_BR_SIG		0x02
 #define BT_L2CAP_MASK_SMP		0x80
@@ -128,6 +128,24 @@ void bt_monitor_send(uint16_t opcode, const void *data, size_t len)
 	irq_unlock(key);
 }
 
+void bt_monitor_send_buf(uint16_t opcode, struct net_buf *buf)
+{
+	struct bt_monitor_hdr hdr;
+	int key;
+
+	encode_hdr(&hdr, opcode, net_buf_frags_len(buf));
+
+	key = irq_lock();
+
+	monitor_send(&hdr, sizeof(hdr));
+
+	for (; buf; buf = buf->frags) {
+		monitor_send(buf->data, buf->len);
+	}
+
+	irq_unlock(key);
+}
+
 void bt_monitor_new_index(uint8_t type, uint8_t bus, bt_addr_t *addr,
 			  const char *name)
 {
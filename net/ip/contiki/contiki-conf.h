@@ -251,4 +251,8 @@ typedef unsigned int uip_stats_t;
 #define NBR_TABLE_CONF_MAX_NEIGHBORS CONFIG_NETWORKING_MAX_NEIGHBORS
 #endif
 
+#if defined(CONFIG_NETWORKING_MAX_ROUTES)
+#define UIP_CONF_MAX_ROUTES CONFIG_NETWORKING_MAX_ROUTES
+#endif
+
 #endif /* __CONTIKI_CONF_H__ */
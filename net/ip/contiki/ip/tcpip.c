@@ -410,7 +410,7 @@ eventhandler(process_event_t ev, process_data_t data, struct net_buf *buf)
         for(cptr = &uip_udp_conns[0];
             cptr < &uip_udp_conns[UIP_UDP_CONNS]; ++cptr) {
           if(cptr->appstate.p == p) {
-            cptr->lport = 0;
+            uip_udp_remove(cptr);
           }
         }
       }
@@ -562,6 +562,26 @@ tcpip_input(struct net_buf *buf)
 }
 /*---------------------------------------------------------------------------*/
 #if NETSTACK_CONF_WITH_IPV6
+#if UIP_CONF_IPV6_QUEUE_PKT
+/* Copy the packet, and the data in its fragments, to the queuing buffer */
+static void
+queue_packet(struct net_buf *buf, struct uip_packetqueue_handle *handle)
+{
+  uint8_t *ptr = uip_packetqueue_buf(handle);
+  struct net_buf *frag;
+
+  memcpy(ptr, UIP_IP_BUF(buf), uip_len(buf));
+  ptr += uip_len(buf);
+
+  for(frag = buf->frags; frag != NULL; frag = frag->frags) {
+    memcpy(ptr, frag->data, frag->len);
+    ptr += frag->len;
+  }
+
+  uip_packetqueue_set_buflen(handle, uip_len(buf) + ip_buf_frags_len(buf));
+}
+#endif /* UIP_CONF_IPV6_QUEUE_PKT */
+/*---------------------------------------------------------------------------*/
 uint8_t
 tcpip_ipv6_output(struct net_buf *buf)
 {
@@ -575,7 +595,7 @@ tcpip_ipv6_output(struct net_buf *buf)
 
   PRINTF("%s(): buf %p len %d\n", __FUNCTION__, buf, uip_len(buf));
 
-  if(uip_len(buf) > UIP_LINK_MTU) {
+  if(uip_len(buf) + ip_buf_frags_len(buf) > UIP_LINK_MTU) {
     UIP_LOG("tcpip_ipv6_output: Packet too big");
     uip_len(buf) = 0;
     uip_ext_len(buf) = 0;
@@ -693,8 +713,7 @@ tcpip_ipv6_output(struct net_buf *buf)
 #if UIP_CONF_IPV6_QUEUE_PKT
         /* Copy outgoing pkt in the queuing buffer for later transmit. */
         if(uip_packetqueue_alloc(buf, &nbr->packethandle, UIP_DS6_NBR_PACKET_LIFETIME) != NULL) {
-          memcpy(uip_packetqueue_buf(&nbr->packethandle), UIP_IP_BUF(buf), uip_len(buf));
-          uip_packetqueue_set_buflen(&nbr->packethandle, uip_len(buf));
+          queue_packet(buf, &nbr->packethandle);
         }
 #else
 	PRINTF("IP packet buf %p len %d discarded because NS is "
@@ -748,8 +767,7 @@ tcpip_ipv6_output(struct net_buf *buf)
         /* Copy outgoing pkt in the queuing buffer for later transmit and set
            the destination nbr to nbr. */
         if(uip_packetqueue_alloc(buf, &nbr->packethandle, UIP_DS6_NBR_PACKET_LIFETIME) != NULL) {
-          memcpy(uip_packetqueue_buf(&nbr->packethandle), UIP_IP_BUF(buf), uip_len(buf));
-          uip_packetqueue_set_buflen(&nbr->packethandle, uip_len(buf));
+          queue_packet(buf, &nbr->packethandle);
         } else {
           PRINTF("IP packet buf %p len %d discarded because no space "
                  "in the queue\n", buf, uip_len(buf));
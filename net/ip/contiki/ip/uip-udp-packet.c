@@ -57,11 +57,18 @@ uip_udp_packet_send(struct net_buf *buf, struct uip_udp_conn *c, const void *dat
 {
 #if UIP_UDP
   if(data != NULL) {
+    uint8_t *appdata = &uip_buf(buf)[UIP_LLH_LEN + UIP_IPUDPH_LEN];
+    /* Data in fragments is sent from the fragments themselves */
+    int buf_len = len - ip_buf_frags_len(buf);
+
     uip_set_udp_conn(buf) = c;
     uip_slen(buf) = len;
-    memcpy(&uip_buf(buf)[UIP_LLH_LEN + UIP_IPUDPH_LEN], data,
-           len > UIP_BUFSIZE - UIP_LLH_LEN - UIP_IPUDPH_LEN?
-           UIP_BUFSIZE - UIP_LLH_LEN - UIP_IPUDPH_LEN: len);
+    /* Applications usually write the data in place already */
+    if(data != appdata) {
+      memmove(appdata, data,
+              buf_len > UIP_BUFSIZE - UIP_LLH_LEN - UIP_IPUDPH_LEN?
+              UIP_BUFSIZE - UIP_LLH_LEN - UIP_IPUDPH_LEN: buf_len);
+    }
     if (uip_process(&buf, UIP_UDP_SEND_CONN) == 0) {
       /* The packet was dropped, we can return now */
       return 0;
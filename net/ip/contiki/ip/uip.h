@@ -824,7 +824,11 @@ struct uip_udp_conn *uip_udp_new(const uip_ipaddr_t *ripaddr, uint16_t rport);
  *
  * \hideinitializer
  */
+#if NETSTACK_CONF_WITH_IPV6
+#define uip_udp_remove(conn) uip_udp_set_lport(conn, 0)
+#else
 #define uip_udp_remove(conn) (conn)->lport = 0
+#endif
 
 /**
  * Bind a UDP connection to a local port.
@@ -836,7 +840,15 @@ struct uip_udp_conn *uip_udp_new(const uip_ipaddr_t *ripaddr, uint16_t rport);
  *
  * \hideinitializer
  */
+#if NETSTACK_CONF_WITH_IPV6
+#define uip_udp_bind(conn, port) uip_udp_set_lport(conn, port)
+
+/* Sets the local port of a UDP connection, port in network byte order */
+struct uip_udp_conn;
+void uip_udp_set_lport(struct uip_udp_conn *conn, uint16_t port);
+#else
 #define uip_udp_bind(conn, port) (conn)->lport = port
+#endif
 
 /**
  * Send a UDP datagram of length len on the current connection.
@@ -82,6 +82,7 @@
 #include "contiki/ip/uip-debug.h"
 
 #include <net/ip_buf.h>
+#include <net/net_chksum.h>
 #include <string.h>
 #include <errno.h>
 
@@ -290,32 +291,8 @@ uip_add32(uint8_t *op32, uint16_t op16)
 static uint16_t
 chksum(uint16_t sum, const uint8_t *data, uint16_t len)
 {
-  uint16_t t;
-  const uint8_t *dataptr;
-  const uint8_t *last_byte;
-
-  dataptr = data;
-  last_byte = data + len - 1;
-
-  while(dataptr < last_byte) {	/* At least two more bytes */
-    t = (dataptr[0] << 8) + dataptr[1];
-    sum += t;
-    if(sum < t) {
-      sum++;		/* carry */
-    }
-    dataptr += 2;
-  }
-
-  if(dataptr == last_byte) {
-    t = (dataptr[0] << 8) + 0;
-    sum += t;
-    if(sum < t) {
-      sum++;		/* carry */
-    }
-  }
-
-  /* Return sum in host byte order. */
-  return sum;
+  /* Summed word-wise, returns sum in host byte order. */
+  return net_chksum(sum, data, len);
 }
 /*---------------------------------------------------------------------------*/
 uint16_t
@@ -1323,7 +1300,8 @@ uip_process(struct net_buf **buf_out, uint8_t flag)
   if(uip_slen(buf) == 0) {
     goto drop;
   }
-  uip_len(buf) = uip_slen(buf) + UIP_IPUDPH_LEN;
+  /* The payload data in fragments is not part of uip_len */
+  uip_len(buf) = uip_slen(buf) - ip_buf_frags_len(buf) + UIP_IPUDPH_LEN;
   ip_buf_len(buf) = uip_len(buf);
 
 #if NETSTACK_CONF_WITH_IPV6
@@ -1332,8 +1310,8 @@ uip_process(struct net_buf **buf_out, uint8_t flag)
   BUF->len[0] = ((uip_len - UIP_IPH_LEN) >> 8);
   BUF->len[1] = ((uip_len - UIP_IPH_LEN) & 0xff);
 #else /* NETSTACK_CONF_WITH_IPV6 */
-  BUF(buf)->len[0] = (uip_len(buf) >> 8);
-  BUF(buf)->len[1] = (uip_len(buf) & 0xff);
+  BUF(buf)->len[0] = ((uip_slen(buf) + UIP_IPUDPH_LEN) >> 8);
+  BUF(buf)->len[1] = ((uip_slen(buf) + UIP_IPUDPH_LEN) & 0xff);
 #endif /* NETSTACK_CONF_WITH_IPV6 */
 
   BUF(buf)->ttl = uip_udp_conn(buf)->ttl;
@@ -72,6 +72,26 @@ LIST(notificationlist);
 
 static int num_routes = 0;
 
+#ifdef CONFIG_NETWORKING_ROUTE_TRIE
+/* Routes are also indexed in a path compressed binary trie, so that the
+   longest prefix match of an address is found by walking at most one
+   node per prefix length. A node either holds the routes with its exact
+   prefix, or only branches between two subtrees. Nodes do not store a
+   copy of their prefix, they point to the address of a route of their
+   subtree instead. A trie of N routes needs at most 2N - 1 nodes. */
+struct route_trie_node {
+  struct route_trie_node *child[2];
+  uip_ds6_route_t *route;
+  const uip_ipaddr_t *prefix;
+  uint8_t length;
+  /* Number of routes with this exact prefix, 0 for a branching node */
+  uint8_t refs;
+};
+
+MEMB(routetriememb, struct route_trie_node, 2 * UIP_DS6_ROUTE_NB);
+static struct route_trie_node *trie_root;
+#endif /* CONFIG_NETWORKING_ROUTE_TRIE */
+
 #ifdef CONFIG_NETWORK_IP_STACK_DEBUG_IPV6_ROUTE
 #define DEBUG 1
 #endif
@@ -144,6 +164,192 @@ uip_ds6_notification_rm(struct uip_ds6_notification *n)
 }
 #endif
 /*---------------------------------------------------------------------------*/
+#ifdef CONFIG_NETWORKING_ROUTE_TRIE
+static uint8_t
+trie_bit(const uip_ipaddr_t *addr, uint8_t bit)
+{
+  return (addr->u8[bit >> 3] >> (7 - (bit & 7))) & 1;
+}
+/*---------------------------------------------------------------------------*/
+/* Number of leading bits, at most max, that both addresses have in common */
+static uint8_t
+trie_common_len(const uip_ipaddr_t *a, const uip_ipaddr_t *b, uint8_t max)
+{
+  uint8_t len = 0;
+  uint8_t diff;
+  int i;
+
+  for(i = 0; i < sizeof(uip_ipaddr_t) && len < max; i++) {
+    diff = a->u8[i] ^ b->u8[i];
+    if(diff != 0) {
+      while(!(diff & 0x80)) {
+        diff <<= 1;
+        len++;
+      }
+      break;
+    }
+    len += 8;
+  }
+
+  return len < max ? len : max;
+}
+/*---------------------------------------------------------------------------*/
+static uint8_t
+trie_prefix_match(const uip_ipaddr_t *addr, const uip_ipaddr_t *prefix,
+                  uint8_t length)
+{
+  return trie_common_len(addr, prefix, length) == length;
+}
+/*---------------------------------------------------------------------------*/
+static uip_ds6_route_t *
+trie_lookup(const uip_ipaddr_t *addr)
+{
+  struct route_trie_node *n;
+  uip_ds6_route_t *found_route = NULL;
+
+  for(n = trie_root;
+      n != NULL && trie_prefix_match(addr, n->prefix, n->length);
+      n = n->child[trie_bit(addr, n->length)]) {
+    if(n->route != NULL) {
+      found_route = n->route;
+    }
+    if(n->length == 128) {
+      break;
+    }
+  }
+
+  return found_route;
+}
+/*---------------------------------------------------------------------------*/
+static int
+trie_add(uip_ds6_route_t *route)
+{
+  struct route_trie_node **link;
+  struct route_trie_node *n, *node, *branch;
+  uint8_t len = 0;
+  uint8_t bit;
+
+  for(link = &trie_root; (n = *link) != NULL;
+      link = &n->child[trie_bit(&route->ipaddr, n->length)]) {
+    len = trie_common_len(&route->ipaddr, n->prefix,
+                          route->length < n->length ?
+                          route->length : n->length);
+    if(len < n->length) {
+      break;
+    }
+    if(n->length == route->length) {
+      /* The most recently added route with this prefix is used */
+      n->route = route;
+      n->prefix = &route->ipaddr;
+      n->refs++;
+      return 1;
+    }
+  }
+
+  node = memb_alloc(&routetriememb);
+  if(node == NULL) {
+    return 0;
+  }
+  node->child[0] = NULL;
+  node->child[1] = NULL;
+  node->route = route;
+  node->prefix = &route->ipaddr;
+  node->length = route->length;
+  node->refs = 1;
+
+  if(n == NULL) {
+    *link = node;
+    return 1;
+  }
+
+  if(len == route->length) {
+    /* The new prefix is a prefix of the node found: insert above it */
+    node->child[trie_bit(n->prefix, len)] = n;
+    *link = node;
+    return 1;
+  }
+
+  /* The prefixes diverge after len bits: branch there */
+  branch = memb_alloc(&routetriememb);
+  if(branch == NULL) {
+    memb_free(&routetriememb, node);
+    return 0;
+  }
+  bit = trie_bit(&route->ipaddr, len);
+  branch->child[bit] = node;
+  branch->child[!bit] = n;
+  branch->route = NULL;
+  branch->prefix = &route->ipaddr;
+  branch->length = len;
+  branch->refs = 0;
+  *link = branch;
+
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+static void
+trie_rm(uip_ds6_route_t *route)
+{
+  struct route_trie_node **link = &trie_root;
+  struct route_trie_node **parent_link = NULL;
+  struct route_trie_node *n, *child;
+  uip_ds6_route_t *r;
+  uint8_t bit;
+
+  while((n = *link) != NULL && n->length < route->length) {
+    if(!trie_prefix_match(&route->ipaddr, n->prefix, n->length)) {
+      return;
+    }
+    bit = trie_bit(&route->ipaddr, n->length);
+    /* Nodes above the route may use its address as their prefix, the
+       other subtree does not hold the route. */
+    if(n->prefix == &route->ipaddr) {
+      n->prefix = n->child[!bit]->prefix;
+    }
+    parent_link = link;
+    link = &n->child[bit];
+  }
+
+  if(n == NULL || n->length != route->length || n->route == NULL ||
+     !trie_prefix_match(&route->ipaddr, n->prefix, n->length)) {
+    return;
+  }
+
+  if(--n->refs > 0) {
+    if(n->route == route) {
+      /* Fall back to another route with the same prefix */
+      for(r = list_head(routelist); r != NULL; r = list_item_next(r)) {
+        if(r != route && r->length == route->length &&
+           trie_prefix_match(&r->ipaddr, &route->ipaddr, route->length)) {
+          n->route = r;
+          n->prefix = &r->ipaddr;
+          break;
+        }
+      }
+    }
+    return;
+  }
+
+  n->route = NULL;
+  if(n->child[0] != NULL && n->child[1] != NULL) {
+    /* Still needed to branch */
+    n->prefix = n->child[0]->prefix;
+    return;
+  }
+
+  child = n->child[0] != NULL ? n->child[0] : n->child[1];
+  *link = child;
+  memb_free(&routetriememb, n);
+
+  /* A branching node left with a single child is not needed anymore */
+  if(child == NULL && parent_link != NULL && (*parent_link)->route == NULL) {
+    n = *parent_link;
+    *parent_link = n->child[0] != NULL ? n->child[0] : n->child[1];
+    memb_free(&routetriememb, n);
+  }
+}
+#endif /* CONFIG_NETWORKING_ROUTE_TRIE */
+/*---------------------------------------------------------------------------*/
 void
 uip_ds6_route_init(void)
 {
@@ -155,6 +361,11 @@ uip_ds6_route_init(void)
   memb_init(&defaultroutermemb);
   list_init(defaultrouterlist);
 
+#ifdef CONFIG_NETWORKING_ROUTE_TRIE
+  memb_init(&routetriememb);
+  trie_root = NULL;
+#endif
+
 #if UIP_DS6_NOTIFICATIONS
   list_init(notificationlist);
 #endif
@@ -206,15 +417,20 @@ uip_ds6_route_num_routes(void)
 uip_ds6_route_t *
 uip_ds6_route_lookup(uip_ipaddr_t *addr)
 {
-  uip_ds6_route_t *r;
   uip_ds6_route_t *found_route;
+#ifndef CONFIG_NETWORKING_ROUTE_TRIE
+  uip_ds6_route_t *r;
   uint8_t longestmatch;
+#endif
 
   PRINTF("uip-ds6-route: Looking up route for ");
   PRINT6ADDR(addr);
   PRINTF("\n");
 
 
+#ifdef CONFIG_NETWORKING_ROUTE_TRIE
+  found_route = trie_lookup(addr);
+#else
   found_route = NULL;
   longestmatch = 0;
   for(r = uip_ds6_route_head();
@@ -230,6 +446,7 @@ uip_ds6_route_lookup(uip_ipaddr_t *addr)
       }
     }
   }
+#endif /* CONFIG_NETWORKING_ROUTE_TRIE */
 
   if(found_route != NULL) {
     PRINTF("uip-ds6-route: Found route: ");
@@ -241,6 +458,7 @@ uip_ds6_route_lookup(uip_ipaddr_t *addr)
     PRINTF("uip-ds6-route: No route found\n");
   }
 
+#ifndef CONFIG_NETWORKING_ROUTE_TRIE
   if(found_route != NULL && found_route != list_head(routelist)) {
     /* If we found a route, we put it at the start of the routeslist
        list. The list is ordered by how recently we looked them up:
@@ -250,6 +468,7 @@ uip_ds6_route_lookup(uip_ipaddr_t *addr)
     list_remove(routelist, found_route);
     list_push(routelist, found_route);
   }
+#endif /* CONFIG_NETWORKING_ROUTE_TRIE */
 
   return found_route;
 }
@@ -373,6 +592,15 @@ uip_ds6_route_add(uip_ipaddr_t *ipaddr, uint8_t length,
   uip_ipaddr_copy(&(r->ipaddr), ipaddr);
   r->length = length;
 
+#ifdef CONFIG_NETWORKING_ROUTE_TRIE
+  if(!trie_add(r)) {
+    /* This should not happen, the trie has room for all the routes. */
+    PRINTF("uip_ds6_route_add: could not allocate route trie node\n");
+    uip_ds6_route_rm(r);
+    return NULL;
+  }
+#endif
+
 #ifdef UIP_DS6_ROUTE_STATE_TYPE
   memset(&r->state, 0, sizeof(UIP_DS6_ROUTE_STATE_TYPE));
 #endif
@@ -410,6 +638,9 @@ uip_ds6_route_rm(uip_ds6_route_t *route)
 
     /* Remove the route from the route list */
     list_remove(routelist, route);
+#ifdef CONFIG_NETWORKING_ROUTE_TRIE
+    trie_rm(route);
+#endif
 
     /* Find the corresponding neighbor_route and remove it. */
     for(neighbor_route = list_head(route->neighbor_routes->route_list);
@@ -73,6 +73,7 @@
 
 #include <net/ip_buf.h>
 #include <net/net_ip.h>
+#include <net/net_chksum.h>
 #include <errno.h>
 
 #include "contiki/ip/uip.h"
@@ -298,6 +299,34 @@ struct uip_udp_conn uip_udp_conns[UIP_UDP_CONNS];
 #endif /* UIP_UDP */
 /** @} */
 
+/*---------------------------------------------------------------------------*/
+/**
+ * \name Connection hash tables
+ * @{
+ */
+/*---------------------------------------------------------------------------*/
+/* The connections are also indexed by port, so that the connection of a
+   received segment or datagram is found without walking the whole
+   connection table. Each bucket is a bitmap of the connections bound to
+   ports hashing to it, TCP connections being hashed by local and remote
+   port and UDP connections by local port only, as their remote end may
+   be a wildcard. A bit is only a hint, the connection found still has to
+   be matched, so a port cleared without updating the table does no harm.
+   Walking a bucket in connection order finds the same connection as
+   walking the whole table did. */
+#define UIP_CONN_HASH_SIZE 16
+#define UIP_CONN_HASH(port) \
+  ((((port) >> 8) ^ (port)) & (UIP_CONN_HASH_SIZE - 1))
+#define UIP_CONN_HASH_WORDS(conns) (((conns) + 31) / 32)
+
+#if UIP_TCP
+static uint32_t uip_conn_hash[UIP_CONN_HASH_SIZE][UIP_CONN_HASH_WORDS(UIP_CONNS)];
+#endif /* UIP_TCP */
+#if UIP_UDP
+static uint32_t uip_udp_conn_hash[UIP_CONN_HASH_SIZE][UIP_CONN_HASH_WORDS(UIP_UDP_CONNS)];
+#endif /* UIP_UDP */
+/** @} */
+
 /*---------------------------------------------------------------------------*/
 /**
  * \name ICMPv6 variables
@@ -343,37 +372,64 @@ uip_add32(uint8_t *op32, uint16_t op16)
 
 #endif /* UIP_ARCH_ADD32 && UIP_TCP */
 
-#if ! UIP_ARCH_CHKSUM
+#if UIP_TCP || UIP_UDP
 /*---------------------------------------------------------------------------*/
-static uint16_t
-chksum(uint16_t sum, const uint8_t *data, uint16_t len)
+/* Returns the first connection of a bucket from index c on, or -1 */
+static int
+conn_hash_next(const uint32_t *bucket, int words, int c)
 {
-  uint16_t t;
-  const uint8_t *dataptr;
-  const uint8_t *last_byte;
+  uint32_t bits;
 
-  dataptr = data;
-  last_byte = data + len - 1;
-  
-  while(dataptr < last_byte) {   /* At least two more bytes */
-    t = (dataptr[0] << 8) + dataptr[1];
-    sum += t;
-    if(sum < t) {
-      sum++;      /* carry */
+  while(c < words * 32) {
+    bits = bucket[c / 32] >> (c % 32);
+    if(bits != 0) {
+      return c + find_lsb_set(bits) - 1;
     }
-    dataptr += 2;
+    c = (c / 32 + 1) * 32;
   }
-  
-  if(dataptr == last_byte) {
-    t = (dataptr[0] << 8) + 0;
-    sum += t;
-    if(sum < t) {
-      sum++;      /* carry */
-    }
+  return -1;
+}
+/*---------------------------------------------------------------------------*/
+static void
+conn_hash_move(uint32_t *from, uint32_t *to, int c)
+{
+  from[c / 32] &= ~(1UL << (c % 32));
+  if(to != NULL) {
+    to[c / 32] |= 1UL << (c % 32);
   }
-
-  /* Return sum in host byte order. */
-  return sum;
+}
+#endif /* UIP_TCP || UIP_UDP */
+/*---------------------------------------------------------------------------*/
+#if UIP_TCP
+static void
+uip_conn_set_ports(struct uip_conn *conn, uint16_t lport, uint16_t rport)
+{
+  conn_hash_move(uip_conn_hash[UIP_CONN_HASH(conn->lport ^ conn->rport)],
+                 uip_conn_hash[UIP_CONN_HASH(lport ^ rport)],
+                 conn - uip_conns);
+  conn->lport = lport;
+  conn->rport = rport;
+}
+#endif /* UIP_TCP */
+/*---------------------------------------------------------------------------*/
+#if UIP_UDP
+void
+uip_udp_set_lport(struct uip_udp_conn *conn, uint16_t lport)
+{
+  conn_hash_move(uip_udp_conn_hash[UIP_CONN_HASH(conn->lport)],
+                 lport != 0 ? uip_udp_conn_hash[UIP_CONN_HASH(lport)] : NULL,
+                 conn - uip_udp_conns);
+  conn->lport = lport;
+}
+#endif /* UIP_UDP */
+/*---------------------------------------------------------------------------*/
+#if ! UIP_ARCH_CHKSUM
+/*---------------------------------------------------------------------------*/
+static uint16_t
+chksum(uint16_t sum, const uint8_t *data, uint16_t len)
+{
+  /* Summed word-wise, returns sum in host byte order. */
+  return net_chksum(sum, data, len);
 }
 /*---------------------------------------------------------------------------*/
 uint16_t
@@ -407,9 +463,11 @@ upper_layer_chksum(struct net_buf *buf, uint8_t proto)
  * See https://sourceforge.net/apps/mantisbt/contiki/view.php?id=3
  */
   volatile uint16_t upper_layer_len;
+  uint16_t frags_len;
   uint16_t sum;
   
   upper_layer_len = (((uint16_t)(UIP_IP_BUF(buf)->len[0]) << 8) + UIP_IP_BUF(buf)->len[1] - uip_ext_len(buf));
+  frags_len = ip_buf_frags_len(buf);
   
   PRINTF("Upper layer checksum len: %d from: %d\n", upper_layer_len,
 	 UIP_IPH_LEN + UIP_LLH_LEN + uip_ext_len(buf));
@@ -420,9 +478,21 @@ upper_layer_chksum(struct net_buf *buf, uint8_t proto)
   /* Sum IP source and destination addresses. */
   sum = chksum(sum, (uint8_t *)&UIP_IP_BUF(buf)->srcipaddr, 2 * sizeof(uip_ipaddr_t));
 
-  /* Sum TCP header and data. */
+  /* Sum TCP header and data, the end of the data can be in fragments. */
   sum = chksum(sum, &uip_buf(buf)[UIP_IPH_LEN + UIP_LLH_LEN + uip_ext_len(buf)],
-               upper_layer_len);
+               upper_layer_len - frags_len);
+  if(frags_len) {
+    uint16_t frags_sum = net_chksum_frags(0, buf->frags);
+
+    /* The fragments start at a low byte after an odd number of bytes */
+    if((upper_layer_len - frags_len) & 1) {
+      frags_sum = (frags_sum << 8) | (frags_sum >> 8);
+    }
+    sum += frags_sum;
+    if(sum < frags_sum) {
+      sum++;
+    }
+  }
     
   return (sum == 0) ? 0xffff : uip_htons(sum);
 }
@@ -470,6 +540,7 @@ uip_init(void)
     uip_conns[c].tcpstateflags = UIP_CLOSED;
     uip_conns[c].len = 0;
   }
+  memset(uip_conn_hash, 0, sizeof(uip_conn_hash));
 
   {
     /* Randomise initial seq number */
@@ -487,6 +558,7 @@ uip_init(void)
 
 #if UIP_UDP
   memset(&uip_udp_conns, 0, sizeof(uip_udp_conns));
+  memset(uip_udp_conn_hash, 0, sizeof(uip_udp_conn_hash));
 #endif /* UIP_UDP */
 
 #if UIP_CONF_IPV6_MULTICAST
@@ -558,8 +630,7 @@ uip_connect(const uip_ipaddr_t *ripaddr, uint16_t rport)
   conn->rto = UIP_RTO;
   conn->sa = 0;
   conn->sv = 16;   /* Initial value of the RTT variance. */
-  conn->lport = uip_htons(lastport);
-  conn->rport = rport;
+  uip_conn_set_ports(conn, uip_htons(lastport), rport);
   uip_ipaddr_copy(&conn->ripaddr, ripaddr);
   
   return conn;
@@ -626,7 +697,7 @@ uip_udp_new(const uip_ipaddr_t *ripaddr, uint16_t rport)
     return 0;
   }
   
-  conn->lport = UIP_HTONS(lastport);
+  uip_udp_set_lport(conn, UIP_HTONS(lastport));
   conn->rport = rport;
   if(ripaddr == NULL) {
     memset(&conn->ripaddr, 0, sizeof(uip_ipaddr_t));
@@ -1014,12 +1085,15 @@ uint8_t
 uip_process(struct net_buf **buf_out, uint8_t flag)
 {
   struct net_buf *buf = *buf_out;
+#if UIP_TCP || UIP_UDP
+  uint32_t *bucket;
+  int i;
+#endif /* UIP_TCP || UIP_UDP */
 #if UIP_TCP
   register struct uip_conn *uip_connr = uip_conn(buf);
   uint8_t c;
 #endif /* UIP_TCP */
 #if UIP_UDP
-  int i;
   if(flag == UIP_UDP_SEND_CONN) {
     goto udp_send;
   }
@@ -1649,7 +1723,10 @@ uip_process(struct net_buf **buf_out, uint8_t flag)
   }
 
   /* Demultiplex this UDP packet between the UDP "connections". */
-  for(i = 0; i < UIP_UDP_CONNS; i++) {
+  bucket = uip_udp_conn_hash[UIP_CONN_HASH(UIP_UDP_BUF(buf)->destport)];
+  for(i = conn_hash_next(bucket, UIP_CONN_HASH_WORDS(UIP_UDP_CONNS), 0);
+      i >= 0;
+      i = conn_hash_next(bucket, UIP_CONN_HASH_WORDS(UIP_UDP_CONNS), i + 1)) {
     /* If the local UDP port is non-zero, the connection is considered
        to be used. If so, the local port number is checked against the
        destination port number in the received packet. If the two port
@@ -1712,12 +1789,13 @@ uip_process(struct net_buf **buf_out, uint8_t flag)
  udp_send:
   PRINTF("In udp_send\n");
 
-  uip_len(buf) = uip_slen(buf) + UIP_IPUDPH_LEN;
+  /* The payload data in fragments is not part of uip_len */
+  uip_len(buf) = uip_slen(buf) - ip_buf_frags_len(buf) + UIP_IPUDPH_LEN;
 
   /* For IPv6, the IP length field does not include the IPv6 IP header
      length. */
-  UIP_IP_BUF(buf)->len[0] = ((uip_len(buf) - UIP_IPH_LEN) >> 8);
-  UIP_IP_BUF(buf)->len[1] = ((uip_len(buf) - UIP_IPH_LEN) & 0xff);
+  UIP_IP_BUF(buf)->len[0] = ((uip_slen(buf) + UIP_UDPH_LEN) >> 8);
+  UIP_IP_BUF(buf)->len[1] = ((uip_slen(buf) + UIP_UDPH_LEN) & 0xff);
 
   UIP_IP_BUF(buf)->ttl = uip_udp_conn(buf)->ttl;
   UIP_IP_BUF(buf)->proto = UIP_PROTO_UDP;
@@ -1776,8 +1854,12 @@ uip_process(struct net_buf **buf_out, uint8_t flag)
 
   /* Demultiplex this segment. */
   /* First check any active connections. */
-  for(uip_connr = &uip_conns[0]; uip_connr <= &uip_conns[UIP_CONNS - 1];
-      ++uip_connr) {
+  bucket = uip_conn_hash[UIP_CONN_HASH(UIP_TCP_BUF(buf)->destport ^
+                                       UIP_TCP_BUF(buf)->srcport)];
+  for(i = conn_hash_next(bucket, UIP_CONN_HASH_WORDS(UIP_CONNS), 0);
+      i >= 0;
+      i = conn_hash_next(bucket, UIP_CONN_HASH_WORDS(UIP_CONNS), i + 1)) {
+    uip_connr = &uip_conns[i];
     if(uip_connr->tcpstateflags != UIP_CLOSED &&
        UIP_TCP_BUF(buf)->destport == uip_connr->lport &&
        UIP_TCP_BUF(buf)->srcport == uip_connr->rport &&
@@ -1897,8 +1979,8 @@ uip_process(struct net_buf **buf_out, uint8_t flag)
   uip_connr->sa = 0;
   uip_connr->sv = 4;
   uip_connr->nrtx = 0;
-  uip_connr->lport = UIP_TCP_BUF(buf)->destport;
-  uip_connr->rport = UIP_TCP_BUF(buf)->srcport;
+  uip_conn_set_ports(uip_connr, UIP_TCP_BUF(buf)->destport,
+                     UIP_TCP_BUF(buf)->srcport);
   uip_ipaddr_copy(&uip_connr->ripaddr, &UIP_IP_BUF(buf)->srcipaddr);
   uip_connr->tcpstateflags = UIP_SYN_RCVD;
 
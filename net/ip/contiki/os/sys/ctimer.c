@@ -43,6 +43,7 @@
  */
 
 #include <net/buf.h>
+#include <misc/util.h>
 
 #include "sys/ctimer.h"
 #include "contiki.h"
@@ -75,19 +76,18 @@ PROCESS_THREAD(ctimer_process, ev, data, buf, user_data)
   }
   initialized = 1;
 
+  /* The list only holds the timers set before the process started */
+  list_init(ctimer_list);
+
   while(1) {
     PROCESS_YIELD_UNTIL(ev == PROCESS_EVENT_TIMER);
-    for(c = list_head(ctimer_list); c != NULL; c = c->next) {
-      if(&c->etimer == data) {
-	list_remove(ctimer_list, c);
-	PROCESS_CONTEXT_BEGIN(c->p);
-	if(c->f != NULL) {
-          c->f(c->buf, c->ptr);
-	}
-	PROCESS_CONTEXT_END(c->p);
-	break;
-      }
+    /* Only the etimers of callback timers post to this process */
+    c = CONTAINER_OF(data, struct ctimer, etimer);
+    PROCESS_CONTEXT_BEGIN(c->p);
+    if(c->f != NULL) {
+      c->f(c->buf, c->ptr);
     }
+    PROCESS_CONTEXT_END(c->p);
   }
   PROCESS_END();
 }
@@ -116,9 +116,8 @@ ctimer_set(struct net_buf *buf, struct ctimer *c, clock_time_t t,
     PROCESS_CONTEXT_END(&ctimer_process);
   } else {
     c->etimer.timer.interval = t;
+    list_add(ctimer_list, c);
   }
-
-  list_add(ctimer_list, c);
 }
 /*---------------------------------------------------------------------------*/
 void
@@ -128,9 +127,9 @@ ctimer_reset(struct ctimer *c)
     PROCESS_CONTEXT_BEGIN(&ctimer_process);
     etimer_reset(&c->etimer);
     PROCESS_CONTEXT_END(&ctimer_process);
+  } else {
+    list_add(ctimer_list, c);
   }
-
-  list_add(ctimer_list, c);
 }
 /*---------------------------------------------------------------------------*/
 void
@@ -140,9 +139,9 @@ ctimer_restart(struct ctimer *c)
     PROCESS_CONTEXT_BEGIN(&ctimer_process);
     etimer_restart(&c->etimer);
     PROCESS_CONTEXT_END(&ctimer_process);
+  } else {
+    list_add(ctimer_list, c);
   }
-
-  list_add(ctimer_list, c);
 }
 /*---------------------------------------------------------------------------*/
 void
@@ -151,10 +150,8 @@ ctimer_stop(struct ctimer *c)
   if(initialized) {
     etimer_stop(&c->etimer);
   } else {
-    c->etimer.next = NULL;
-    //c->etimer.p = PROCESS_NONE;
+    list_remove(ctimer_list, c);
   }
-  list_remove(ctimer_list, c);
 }
 /*---------------------------------------------------------------------------*/
 int
@@ -49,101 +49,61 @@
 #define DEBUG DEBUG_NONE
 #include "contiki/ip/uip-debug.h"
 
+#include <misc/util.h>
+
 #include "sys/etimer.h"
 #include "sys/process.h"
 
-extern void net_timer_check(void);
-
-static struct etimer *timerlist;
-static clock_time_t next_expiration;
+/*
+ * Each event timer is backed by a delayed work item, so the kernel
+ * timeout queue tracks the expirations and submits the work to the
+ * system workqueue, which posts the timer event. There is no list of
+ * timers to scan and no fiber polling for expirations.
+ */
 
-PROCESS(etimer_process, "Event timer");
 /*---------------------------------------------------------------------------*/
 static void
-update_time(void)
+schedule(struct etimer *et)
 {
-  struct etimer *t;
-  clock_time_t remaining;
-
-  if (timerlist == NULL) {
-    next_expiration = 0;
-  } else {
-    clock_time_t shortest = 0;
-    for(t = timerlist; t != NULL; t = t->next) {
-      remaining = timer_remaining(&t->timer);
-      PRINTF("%s():%d etimer %p left %d shortest %d triggered %d\n",
-	     __FUNCTION__, __LINE__,
-	     t, remaining, shortest, etimer_is_triggered(t));
-      if((shortest > remaining || shortest == 0) && remaining != 0) {
-        shortest = remaining;
-      }
-    }
-    next_expiration = shortest;
-    PRINTF("%s():%d next expiration %d\n", __FUNCTION__, __LINE__,
-	   next_expiration);
-  }
-
-  net_timer_check();
+  /* an expired work item that has not run yet cannot be cancelled, it
+     reschedules itself when it runs */
+  nano_delayed_work_submit(&et->work, max(timer_remaining(&et->timer), 1));
 }
 /*---------------------------------------------------------------------------*/
-PROCESS_THREAD(etimer_process, ev, data, buf, user_data)
+static void
+etimer_expire(struct nano_work *work)
 {
-  struct etimer *t;
-
-  PROCESS_BEGIN();
+  struct etimer *et = CONTAINER_OF(work, struct etimer, work.work);
 
-  while(1) {
-    PROCESS_YIELD();
+  if(!et->timer.started) {
+    /* Stopped after it expired */
+    return;
+  }
 
-    PRINTF("%s():%d timerlist %p\n", __FUNCTION__, __LINE__, timerlist);
-    for(t = timerlist; t != NULL; t = t->next) {
-      PRINTF("%s():%d timer %p remaining %d triggered %d\n",
-	     __FUNCTION__, __LINE__,
-	     t, timer_remaining(&t->timer), etimer_is_triggered(t));
-      if(etimer_expired(t) && !etimer_is_triggered(t)) {
-        PRINTF("%s():%d timer %p expired, process %p\n",
-	       __FUNCTION__, __LINE__, t, t->p);
+  if(!etimer_expired(et)) {
+    /* Set again after it expired */
+    schedule(et);
+    return;
+  }
 
-	if (t->p == NULL) {
-          PRINTF("calling tcpip_process\n");
-          process_post_synch(&tcpip_process, PROCESS_EVENT_TIMER, t, NULL);
-	} else {
-          process_post_synch(t->p, PROCESS_EVENT_TIMER, t, NULL);
-	}
-      }
-    }
-    update_time();
+  PRINTF("%s():%d timer %p expired, process %p\n",
+	 __FUNCTION__, __LINE__, et, et->p);
 
+  if(et->p == NULL) {
+    process_post_synch(&tcpip_process, PROCESS_EVENT_TIMER, et, NULL);
+  } else {
+    process_post_synch(et->p, PROCESS_EVENT_TIMER, et, NULL);
   }
-  PROCESS_END();
-}
-/*---------------------------------------------------------------------------*/
-clock_time_t
-etimer_request_poll(void)
-{
-  process_post_synch(&etimer_process, PROCESS_EVENT_POLL,
-		     NULL, NULL);
-  return next_expiration;
 }
 /*---------------------------------------------------------------------------*/
 static void
-add_timer(struct etimer *timer)
+add_timer(struct etimer *et)
 {
-  struct etimer *t;
-
-  for(t = timerlist; t != NULL; t = t->next) {
-    if(t == timer) {
-      /* Timer already on list, bail out. */
-	update_time();
-	return;
-    }
+  if(!et->work.work.handler) {
+    nano_delayed_work_init(&et->work, etimer_expire);
   }
 
-  /* Timer not on list. */
-  timer->next = timerlist;
-  timerlist = timer;
-
-  update_time();
+  schedule(et);
 }
 /*---------------------------------------------------------------------------*/
 void
@@ -168,14 +128,11 @@ etimer_restart(struct etimer *et)
   add_timer(et);
 }
 /*---------------------------------------------------------------------------*/
-#if 1
 void
 etimer_adjust(struct etimer *et, int timediff)
 {
   et->timer.start += timediff;
-  update_time();
 }
-#endif
 /*---------------------------------------------------------------------------*/
 int
 etimer_expired(struct etimer *et)
@@ -195,48 +152,16 @@ etimer_start_time(struct etimer *et)
   return et->timer.start;
 }
 /*---------------------------------------------------------------------------*/
-int
-etimer_pending(void)
-{
-  return timerlist != NULL;
-}
-/*---------------------------------------------------------------------------*/
-clock_time_t
-etimer_next_expiration_time(void)
-{
-  return etimer_pending() ? next_expiration : 0;
-}
-/*---------------------------------------------------------------------------*/
 void
 etimer_stop(struct etimer *et)
 {
-  struct etimer *t;
-
   timer_stop(&et->timer);
 
-  /* First check if et is the first event timer on the list. */
-  if(et == timerlist) {
-    timerlist = timerlist->next;
-    update_time();
-  } else {
-    /* Else walk through the list and try to find the item before the
-       et timer. */
-    for(t = timerlist; t != NULL && t->next != et; t = t->next);
-
-    if(t != NULL) {
-      /* We've found the item before the event timer that we are about
-        to remove. We point the items next pointer to the event after
-        the removed item. */
-      t->next = et->next;
-
-      update_time();
-    }
+  if(et->work.work.handler) {
+    nano_delayed_work_cancel(&et->work);
   }
 
-  /* Remove the next pointer from the item to be removed. */
-  et->next = NULL;
-
-  PRINTF("%s():%d timer %p removed\n", __FUNCTION__, __LINE__);
+  PRINTF("%s():%d timer %p removed\n", __FUNCTION__, __LINE__, et);
 }
 /*---------------------------------------------------------------------------*/
 bool etimer_is_triggered(struct etimer *t)
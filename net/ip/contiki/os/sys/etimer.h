@@ -62,6 +62,8 @@
 #ifndef ETIMER_H_
 #define ETIMER_H_
 
+#include <misc/nano_work.h>
+
 #include "sys/timer.h"
 #include "sys/process.h"
 
@@ -75,7 +77,7 @@
  */
 struct etimer {
   struct timer timer;
-  struct etimer *next;
+  struct nano_delayed_work work;
   struct process *p;
 };
 
@@ -197,49 +199,12 @@ void etimer_stop(struct etimer *et);
 
 /** @} */
 
-/**
- * \name Functions called from timer interrupts, by the system
- * @{
- */
-
-/**
- * \brief      Make the event timer aware that the clock has changed
- *
- *             This function is used to inform the event timer module
- *             that the system clock has been updated. Typically, this
- *             function would be called from the timer interrupt
- *             handler when the clock has ticked.
- */
-clock_time_t etimer_request_poll(void);
-
-/**
- * \brief      Check if there are any non-expired event timers.
- * \return     True if there are active event timers, false if there are
- *             no active timers.
- *
- *             This function checks if there are any active event
- *             timers that have not expired.
- */
-int etimer_pending(void);
-
-/**
- * \brief      Get next event timer expiration time.
- * \return     Next expiration time of all pending event timers.
- *             If there are no pending event timers this function
- *	       returns 0.
- *
- *             This functions returns next expiration time of all
- *             pending event timers.
- */
-clock_time_t etimer_next_expiration_time(void);
-
 bool etimer_is_triggered(struct etimer *t);
 void etimer_set_triggered(struct etimer *t);
 
 
 /** @} */
 
-PROCESS_NAME(etimer_process);
 #endif /* ETIMER_H_ */
 /** @} */
 /** @} */
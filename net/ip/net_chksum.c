@@ -0,0 +1,141 @@
+/** @file
+ @brief Internet checksum
+
+ Word-wise computation of the one's complement sum used by the IP stack.
+ */
+
+/*
+ * Copyright (c) 2016 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <misc/byteorder.h>
+
+#include <net/buf.h>
+#include <net/net_chksum.h>
+
+/*
+ * The one's complement sum does not depend on the byte order the words are
+ * read in, provided the result is byte swapped accordingly (RFC 1071). The
+ * data is therefore summed with native 32-bit loads, 2^16 being congruent
+ * to 1 modulo 0xffff, into a 64-bit accumulator: carries pile up in its
+ * upper bits and are only folded back once, at the end.
+ */
+
+static inline uint16_t fold(uint64_t acc)
+{
+	while (acc >> 16) {
+		acc = (acc & 0xffff) + (acc >> 16);
+	}
+
+	return acc;
+}
+
+/* Sum of the data as native 16-bit words, data must be 2-byte aligned */
+static uint16_t sum_words(const uint8_t *data, size_t len)
+{
+	const uint32_t *p32;
+	uint64_t acc = 0;
+
+	if (((uintptr_t)data & 2) && len >= 2) {
+		acc += *(const uint16_t *)data;
+		data += 2;
+		len -= 2;
+	}
+
+	p32 = (const uint32_t *)data;
+
+	while (len >= 32) {
+		acc += p32[0];
+		acc += p32[1];
+		acc += p32[2];
+		acc += p32[3];
+		acc += p32[4];
+		acc += p32[5];
+		acc += p32[6];
+		acc += p32[7];
+		p32 += 8;
+		len -= 32;
+	}
+
+	while (len >= 4) {
+		acc += *p32++;
+		len -= 4;
+	}
+
+	data = (const uint8_t *)p32;
+
+	if (len >= 2) {
+		acc += *(const uint16_t *)data;
+		data += 2;
+		len -= 2;
+	}
+
+	/* trailing byte, padded with zero */
+	if (len) {
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+		acc += *data;
+#else
+		acc += (uint16_t)*data << 8;
+#endif
+	}
+
+	return fold(acc);
+}
+
+uint16_t net_chksum(uint16_t sum, const uint8_t *data, uint16_t len)
+{
+	uint32_t acc;
+
+	if (!len) {
+		return sum;
+	}
+
+	if ((uintptr_t)data & 1) {
+		/*
+		 * Sum from the next aligned byte: the words are then made of
+		 * the wrong byte pairs, which the opposite byte swap of the
+		 * result makes up for.
+		 */
+		acc = ((uint16_t)data[0] << 8) +
+		      sys_le16_to_cpu(sum_words(data + 1, len - 1));
+	} else {
+		acc = sys_be16_to_cpu(sum_words(data, len));
+	}
+
+	return fold(acc + sum);
+}
+
+uint16_t net_chksum_frags(uint16_t sum, struct net_buf *buf)
+{
+	bool odd = false;
+	uint16_t frag_sum;
+
+	for (; buf; buf = buf->frags) {
+		frag_sum = net_chksum(0, buf->data, buf->len);
+
+		/* data after an odd number of bytes starts at a low byte */
+		if (odd) {
+			frag_sum = __bswap_16(frag_sum);
+		}
+
+		sum = fold((uint32_t)sum + frag_sum);
+		odd ^= buf->len & 1;
+	}
+
+	return sum;
+}
@@ -29,6 +29,8 @@
 #include <string.h>
 #include <errno.h>
 #include <stdbool.h>
+#include <misc/slist.h>
+#include <misc/util.h>
 
 #include <net/net_ip.h>
 #include <net/net_socket.h>
@@ -55,6 +57,9 @@ struct net_context {
 	/* Connection tuple identifies the connection */
 	struct net_tuple tuple;
 
+	/* Node in the hash bucket of the local port */
+	sys_snode_t node;
+
 	/* Application receives data via this fifo */
 	struct nano_fifo rx_queue;
 
@@ -89,6 +94,23 @@ struct net_context {
 static struct net_context contexts[NET_MAX_CONTEXT];
 static struct nano_sem contexts_lock;
 
+/* Contexts in use are hashed by local port, so that checking whether a
+ * port is already bound does not need to walk all the contexts.
+ */
+#define CONTEXT_HASH_SIZE 16
+#define CONTEXT_HASH(port) ((((port) >> 8) ^ (port)) & (CONTEXT_HASH_SIZE - 1))
+
+static sys_slist_t context_hash[CONTEXT_HASH_SIZE];
+
+/* Ephemeral ports are taken from the dynamic port range of RFC 6335. A bit
+ * is set for every port of the range that is bound by a context, whatever
+ * its protocol and local address.
+ */
+#define EPHEMERAL_PORT_MIN 49152
+#define EPHEMERAL_PORT_COUNT (65536 - EPHEMERAL_PORT_MIN)
+
+static uint32_t ephemeral_ports[EPHEMERAL_PORT_COUNT / 32];
+
 static void context_sem_give(struct nano_sem *chan)
 {
 	switch (sys_execution_context_type_get()) {
@@ -109,12 +131,15 @@ static int context_port_used(enum ip_protocol ip_proto, uint16_t local_port,
 			     const struct net_addr *local_addr)
 
 {
-	int i;
+	struct net_context *context;
+	sys_snode_t *node;
 
-	for (i = 0; i < NET_MAX_CONTEXT; i++) {
-		if (contexts[i].tuple.ip_proto == ip_proto &&
-		    contexts[i].tuple.local_port == local_port &&
-		    !memcmp(&contexts[i].tuple.local_addr, local_addr,
+	SYS_SLIST_FOR_EACH_NODE(&context_hash[CONTEXT_HASH(local_port)], node) {
+		context = CONTAINER_OF(node, struct net_context, node);
+
+		if (context->tuple.ip_proto == ip_proto &&
+		    context->tuple.local_port == local_port &&
+		    !memcmp(&context->tuple.local_addr, local_addr,
 			   sizeof(struct net_addr))) {
 			return -EEXIST;
 		}
@@ -123,6 +148,65 @@ static int context_port_used(enum ip_protocol ip_proto, uint16_t local_port,
 	return 0;
 }
 
+static bool context_port_bound(uint16_t local_port)
+{
+	struct net_context *context;
+	sys_snode_t *node;
+
+	SYS_SLIST_FOR_EACH_NODE(&context_hash[CONTEXT_HASH(local_port)], node) {
+		context = CONTAINER_OF(node, struct net_context, node);
+
+		if (context->tuple.local_port == local_port) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+static void context_hash_add(struct net_context *context)
+{
+	uint16_t port = context->tuple.local_port;
+
+	sys_slist_prepend(&context_hash[CONTEXT_HASH(port)], &context->node);
+
+	if (port >= EPHEMERAL_PORT_MIN) {
+		port -= EPHEMERAL_PORT_MIN;
+		ephemeral_ports[port / 32] |= BIT(port % 32);
+	}
+}
+
+static void context_hash_remove(struct net_context *context)
+{
+	uint16_t port = context->tuple.local_port;
+
+	sys_slist_find_and_remove(&context_hash[CONTEXT_HASH(port)],
+				  &context->node);
+
+	if (port >= EPHEMERAL_PORT_MIN && !context_port_bound(port)) {
+		port -= EPHEMERAL_PORT_MIN;
+		ephemeral_ports[port / 32] &= ~BIT(port % 32);
+	}
+}
+
+/* Returns a port of the ephemeral range that no context uses, 0 if none */
+static uint16_t ephemeral_port_get(void)
+{
+	int start = random_rand() % ARRAY_SIZE(ephemeral_ports);
+	int i, n;
+
+	for (n = 0; n < ARRAY_SIZE(ephemeral_ports); n++) {
+		i = (start + n) % ARRAY_SIZE(ephemeral_ports);
+
+		if (ephemeral_ports[i] != 0xffffffff) {
+			return EPHEMERAL_PORT_MIN + i * 32 +
+				find_lsb_set(~ephemeral_ports[i]) - 1;
+		}
+	}
+
+	return 0;
+}
+
 struct net_context *net_context_get(enum ip_protocol ip_proto,
 					const struct net_addr *remote_addr,
 					uint16_t remote_port,
@@ -166,13 +250,15 @@ struct net_context *net_context_get(enum ip_protocol ip_proto,
 
 	if (local_port) {
 		if (context_port_used(ip_proto, local_port, local_addr) < 0) {
+			context_sem_give(&contexts_lock);
 			return NULL;
 		}
 	} else {
-		do {
-			local_port = random_rand() | 0x8000;
-		} while (context_port_used(ip_proto, local_port,
-					   local_addr) == -EEXIST);
+		local_port = ephemeral_port_get();
+		if (!local_port) {
+			context_sem_give(&contexts_lock);
+			return NULL;
+		}
 	}
 
 	for (i = 0; i < NET_MAX_CONTEXT; i++) {
@@ -183,6 +269,7 @@ struct net_context *net_context_get(enum ip_protocol ip_proto,
 			contexts[i].tuple.local_addr = (struct net_addr *)local_addr;
 			contexts[i].tuple.local_port = local_port;
 			context = &contexts[i];
+			context_hash_add(context);
 			break;
 		}
 	}
@@ -225,6 +312,8 @@ void net_context_put(struct net_context *context)
 	}
 #endif
 
+	context_hash_remove(context);
+
 	memset(&context->tuple, 0, sizeof(context->tuple));
 	memset(&context->udp, 0, sizeof(context->udp));
 	context->receiver_registered = false;
@@ -519,6 +608,11 @@ void net_context_init(void)
 	nano_sem_init(&contexts_lock);
 
 	memset(contexts, 0, sizeof(contexts));
+	memset(ephemeral_ports, 0, sizeof(ephemeral_ports));
+
+	for (i = 0; i < CONTEXT_HASH_SIZE; i++) {
+		sys_slist_init(&context_hash[i]);
+	}
 
 	for (i = 0; i < NET_MAX_CONTEXT; i++) {
 		nano_fifo_init(&contexts[i].rx_queue);
@@ -93,13 +93,12 @@ extern uint8_t net_context_tcp_get_retry_count(struct net_context *context);
 #ifndef CONFIG_IP_TX_STACK_SIZE
 #define CONFIG_IP_TX_STACK_SIZE (STACKSIZE_UNIT * 1)
 #endif
-#ifndef CONFIG_IP_TIMER_STACK_SIZE
-#define CONFIG_IP_TIMER_STACK_SIZE (STACKSIZE_UNIT * 3 / 2)
+#ifndef CONFIG_IP_BUF_BATCH_SIZE
+#define CONFIG_IP_BUF_BATCH_SIZE 1
 #endif
 static char __noinit __stack rx_fiber_stack[CONFIG_IP_RX_STACK_SIZE];
 static char __noinit __stack tx_fiber_stack[CONFIG_IP_TX_STACK_SIZE];
-static char __noinit __stack timer_fiber_stack[CONFIG_IP_TIMER_STACK_SIZE];
-static nano_thread_id_t timer_fiber_id, tx_fiber_id;
+static nano_thread_id_t tx_fiber_id;
 
 static uint8_t initialized;
 
@@ -149,6 +148,11 @@ int net_send(struct net_buf *buf)
 		int status;
 		uint8_t retry_count;
 
+		if (buf->frags) {
+			NET_DBG("TCP data must be in the buffer itself\n");
+			return -EINVAL;
+		}
+
 		net_context_tcp_init(ip_buf_context(buf), buf,
 				     NET_TCP_TYPE_CLIENT);
 
@@ -204,7 +208,8 @@ int net_send(struct net_buf *buf)
 	}
 #endif
 
-	nano_fifo_put(&netdev.tx_queue, buf);
+	/* Keep the payload fragments linked to the buffer */
+	net_buf_put(&netdev.tx_queue, buf);
 
 	/* Tell the IP stack it can proceed with the packet */
 	fiber_wakeup(tx_fiber_id);
@@ -411,7 +416,8 @@ static inline int udp_prepare_and_send(struct net_context *context,
 	ret = simple_udp_sendto_port(buf,
 				     net_context_get_udp_connection(context),
 				     ip_buf_appdata(buf),
-				     ip_buf_appdatalen(buf),
+				     ip_buf_appdatalen(buf) +
+				     ip_buf_frags_len(buf),
 				     &NET_BUF_IP(buf)->destipaddr,
 				     uip_ntohs(NET_BUF_UDP(buf)->destport));
 	if (ret <= 0) {
@@ -580,6 +586,34 @@ int net_recv(struct net_buf *buf)
 	return 0;
 }
 
+/* Called by driver when several IP packets have been received */
+int net_recv_list(sys_slist_t *list)
+{
+	sys_snode_t *node, *prev = NULL;
+
+	for (node = sys_slist_peek_head(list); node; ) {
+		struct net_buf *buf = (struct net_buf *)node;
+
+		node = sys_slist_peek_next(node);
+
+		if (ip_buf_len(buf) == 0) {
+			sys_slist_remove(list, prev, (sys_snode_t *)buf);
+			ip_buf_unref(buf);
+			continue;
+		}
+
+		prev = (sys_snode_t *)buf;
+	}
+
+	if (sys_slist_is_empty(list)) {
+		return -ENODATA;
+	}
+
+	nano_fifo_put_slist(&netdev.rx_queue, list);
+
+	return 0;
+}
+
 static void udp_packet_receive(struct simple_udp_connection *c,
 			       const uip_ipaddr_t *source_addr,
 			       uint16_t source_port,
@@ -810,7 +844,8 @@ static int check_and_send_packet(struct net_buf *buf)
 		}
 
 		ret = simple_udp_send(buf, udp, uip_appdata(buf),
-				      uip_appdatalen(buf));
+				      uip_appdatalen(buf) +
+				      ip_buf_frags_len(buf));
 		break;
 	case IPPROTO_TCP:
 #ifdef CONFIG_NETWORKING_WITH_TCP
@@ -856,6 +891,40 @@ static int check_and_send_packet(struct net_buf *buf)
 	return ret;
 }
 
+/* Send one packet, returns once uIP is done with the buffer */
+static void net_tx_packet(struct net_buf *buf)
+{
+	int ret;
+
+	NET_DBG("Sending (buf %p, len %u) to IP stack\n",
+		buf, buf->len);
+
+	/* What to do with the buffer:
+	 *  <0: error, release the buffer
+	 *   0: message was discarded by uIP, release the buffer here
+	 *  >0: message was sent ok, buffer released already
+	 */
+	ret = check_and_send_packet(buf);
+	if (ret < 0) {
+		ip_buf_unref(buf);
+		return;
+	} else if (ret > 0) {
+		return;
+	}
+
+	NET_BUF_CHECK_IF_NOT_IN_USE(buf);
+
+	/* Check for any events that we might need to process. The events
+	 * are delivered along with the buffer, so this cannot be deferred
+	 * to the end of the batch.
+	 */
+	do {
+		ret = process_run(buf);
+	} while (ret > 0);
+
+	ip_buf_unref(buf);
+}
+
 static void net_tx_fiber(void)
 {
 	NET_DBG("Starting TX fiber (stack %d bytes)\n",
@@ -863,37 +932,18 @@ static void net_tx_fiber(void)
 
 	while (1) {
 		struct net_buf *buf;
-		int ret;
+		int count = 0;
 
 		/* Get next packet from application - wait if necessary */
 		buf = net_buf_get_timeout(&netdev.tx_queue, 0, TICKS_UNLIMITED);
 
-		NET_DBG("Sending (buf %p, len %u) to IP stack\n",
-			buf, buf->len);
-
-		/* What to do with the buffer:
-		 *  <0: error, release the buffer
-		 *   0: message was discarded by uIP, release the buffer here
-		 *  >0: message was sent ok, buffer released already
-		 */
-		ret = check_and_send_packet(buf);
-		if (ret < 0) {
-			ip_buf_unref(buf);
-			goto wait_next;
-		} else if (ret > 0) {
-			goto wait_next;
-		}
-
-		NET_BUF_CHECK_IF_NOT_IN_USE(buf);
-
-		/* Check for any events that we might need to process */
+		/* Then send the packets already queued, up to the batch size */
 		do {
-			ret = process_run(buf);
-		} while (ret > 0);
-
-		ip_buf_unref(buf);
+			net_tx_packet(buf);
+		} while (++count < CONFIG_IP_BUF_BATCH_SIZE &&
+			 (buf = net_buf_get_timeout(&netdev.tx_queue, 0,
+						    TICKS_NONE)));
 
-	wait_next:
 		/* Check stack usage (no-op if not enabled) */
 		net_analyze_stack("TX fiber", tx_fiber_stack,
 				  sizeof(tx_fiber_stack));
@@ -905,84 +955,33 @@ static void net_tx_fiber(void)
 static void net_rx_fiber(void)
 {
 	struct net_buf *buf;
+	int count;
 
 	NET_DBG("Starting RX fiber (stack %d bytes)\n",
 		sizeof(rx_fiber_stack));
 
 	while (1) {
 		buf = net_buf_get_timeout(&netdev.rx_queue, 0, TICKS_UNLIMITED);
+		count = 0;
 
 		/* Check stack usage (no-op if not enabled) */
 		net_analyze_stack("RX fiber", rx_fiber_stack,
 				  sizeof(rx_fiber_stack));
 
-		NET_DBG("Received buf %p\n", buf);
-
-		if (!tcpip_input(buf)) {
-			ip_buf_unref(buf);
-		}
-		/* The buffer is on to its way to receiver at this
-		 * point. We must not remove it here.
-		 */
-
-		net_print_statistics();
-	}
-}
-
-/*
- * Run various Contiki timers.
- */
-#define MAX_TIMER_WAKEUP 0x7ffffff
-
-static void net_timer_fiber(void)
-{
-	clock_time_t next_wakeup;
-
-	NET_DBG("Starting net timer fiber (stack %d bytes)\n",
-		sizeof(timer_fiber_stack));
-
-	while (1) {
-		/* Run various timers */
-		next_wakeup = etimer_request_poll();
-
-		if (next_wakeup == 0) {
-			/* There was no timers, wait again */
-			next_wakeup = MAX_TIMER_WAKEUP;
-		} else {
-			if (next_wakeup > MAX_TIMER_WAKEUP) {
-				next_wakeup = MAX_TIMER_WAKEUP;
-			}
+		do {
+			NET_DBG("Received buf %p\n", buf);
 
-#ifdef CONFIG_INIT_STACKS
-			{
-#define PRINT_CYCLE (60 * sys_clock_ticks_per_sec)
-
-				static uint32_t next_print;
-				uint32_t curr = sys_tick_get_32();
-
-				/* Print stack usage every n. sec */
-				if (!next_print ||
-				    (next_print < curr &&
-				     (!((curr - next_print) > PRINT_CYCLE)))) {
-					uint32_t new_print;
-
-					net_analyze_stack("timer fiber",
-							  timer_fiber_stack,
-						  sizeof(timer_fiber_stack));
-					new_print = curr + PRINT_CYCLE;
-					if (new_print > curr) {
-						next_print = new_print;
-					} else {
-						/* Overflow */
-						next_print = PRINT_CYCLE -
-							(0xffffffff - curr);
-					}
-				}
+			if (!tcpip_input(buf)) {
+				ip_buf_unref(buf);
 			}
-#endif
-		}
+			/* The buffer is on to its way to receiver at this
+			 * point. We must not remove it here.
+			 */
+		} while (++count < CONFIG_IP_BUF_BATCH_SIZE &&
+			 (buf = net_buf_get_timeout(&netdev.rx_queue, 0,
+						    TICKS_NONE)));
 
-		fiber_sleep(next_wakeup);
+		net_print_statistics();
 	}
 }
 
@@ -1003,19 +1002,6 @@ static void init_tx_queue(void)
 				  0, 0, 7, 0);
 }
 
-static void init_timer_fiber(void)
-{
-	timer_fiber_id = fiber_start(timer_fiber_stack,
-				     sizeof(timer_fiber_stack),
-				     (nano_fiber_entry_t)net_timer_fiber,
-				     0, 0, 7, 0);
-}
-
-void net_timer_check(void)
-{
-	fiber_wakeup(timer_fiber_id);
-}
-
 int net_set_mac(uint8_t *mac, uint8_t len)
 {
 	if (!mac) {
@@ -1056,6 +1042,35 @@ int net_set_mac(uint8_t *mac, uint8_t len)
 	return 0;
 }
 
+/* Copy the payload fragments after the packet built by uIP, for the
+ * drivers that need the whole packet in the buffer.
+ */
+static int net_linearize(struct net_buf *buf)
+{
+	uint16_t offset = UIP_LLH_LEN + uip_len(buf);
+	uint16_t len = ip_buf_frags_len(buf);
+	struct net_buf *frag;
+
+	if (offset + len > buf->size - net_buf_headroom(buf)) {
+		NET_DBG("buf %p cannot hold %u bytes of fragments\n",
+			buf, len);
+		return -EMSGSIZE;
+	}
+
+	for (frag = buf->frags; frag; frag = frag->frags) {
+		memcpy(&uip_buf(buf)[offset], frag->data, frag->len);
+		offset += frag->len;
+	}
+
+	uip_len(buf) += len;
+	buf->len += len;
+
+	net_buf_unref(buf->frags);
+	buf->frags = NULL;
+
+	return 0;
+}
+
 static uint8_t net_tcpip_output(struct net_buf *buf, const uip_lladdr_t *lladdr)
 {
 	int res;
@@ -1075,6 +1090,10 @@ static uint8_t net_tcpip_output(struct net_buf *buf, const uip_lladdr_t *lladdr)
 		return 0;
 	}
 
+	if (buf->frags && !netdev.drv->frags && net_linearize(buf) < 0) {
+		return 0;
+	}
+
 	res = netdev.drv->send(buf);
 	if (res < 0) {
 		res = 0;
@@ -1095,7 +1114,6 @@ static int network_initialization(void)
 
 	process_start(&tcpip_process, NULL, NULL);
 	process_start(&simple_udp_process, NULL, NULL);
-	process_start(&etimer_process, NULL, NULL);
 	process_start(&ctimer_process, NULL, NULL);
 
 	slip_start();
@@ -1159,7 +1177,6 @@ int net_init(void)
 
 	init_tx_queue();
 	init_rx_queue();
-	init_timer_fiber();
 
 #if defined(CONFIG_NETWORKING_WITH_15_4)
 	net_driver_15_4_init();
@@ -58,6 +58,17 @@ bool net_driver_ethernet_is_opened(void)
 	return opened;
 }
 
+#ifdef CONFIG_NETWORKING_WITH_IPV4
+static inline bool ethernet_is_arp(struct net_buf *buf)
+{
+	struct uip_eth_hdr *eth_hdr = (struct uip_eth_hdr *)uip_buf(buf);
+
+	return eth_hdr->type == uip_htons(UIP_ETHTYPE_ARP);
+}
+#else
+#define ethernet_is_arp(buf) false
+#endif
+
 static int net_driver_ethernet_send(struct net_buf *buf)
 {
 #ifdef CONFIG_NETWORKING_WITH_IPV6
@@ -78,6 +89,12 @@ static int net_driver_ethernet_send(struct net_buf *buf)
 	 * original packet if necessary.
 	 */
 	uip_arp_out(buf);
+
+	if (buf->frags && ethernet_is_arp(buf)) {
+		/* The packet was replaced by an ARP request */
+		net_buf_unref(buf->frags);
+		buf->frags = NULL;
+	}
 #else
 	memcpy(eth_hdr->dest.addr, ip_buf_ll_dest(buf).u8, UIP_LLADDR_LEN);
 	memcpy(eth_hdr->src.addr, uip_lladdr.addr, UIP_LLADDR_LEN);
@@ -96,48 +113,78 @@ static int net_driver_ethernet_send(struct net_buf *buf)
 	return res;
 }
 
-void net_driver_ethernet_recv(struct net_buf *buf)
-{
 #ifdef CONFIG_NETWORKING_WITH_IPV4
-	struct uip_eth_hdr *eth_hdr = (struct uip_eth_hdr *)uip_buf(buf);
-
-	if (eth_hdr->type == uip_htons(UIP_ETHTYPE_ARP)) {
-		uip_arp_arpin(buf);
+static void ethernet_arp_input(struct net_buf *buf)
+{
+	uip_arp_arpin(buf);
 
-		/* If uip_arp_arpin needs to send an ARP response, it
-		 * overwrites the contents of buf and updates its
-		 * length variable.  Otherwise, it zeroes out the
-		 * length variable.
-		 */
-		if (uip_len(buf) == 0) {
-			ip_buf_unref(buf);
-			return;
-		}
+	/* If uip_arp_arpin needs to send an ARP response, it
+	 * overwrites the contents of buf and updates its
+	 * length variable.  Otherwise, it zeroes out the
+	 * length variable.
+	 */
+	if (uip_len(buf) == 0) {
+		ip_buf_unref(buf);
+		return;
+	}
 
-		if (!tx_cb) {
-			NET_ERR("Ethernet transmit callback is uninitialized.\n");
-			ip_buf_unref(buf);
-			return;
-		}
+	if (!tx_cb) {
+		NET_ERR("Ethernet transmit callback is uninitialized.\n");
+		ip_buf_unref(buf);
+		return;
+	}
 
-		if (tx_cb(buf) != 1) {
-			NET_ERR("Failed to send ARP response.\n");
-		}
+	if (tx_cb(buf) != 1) {
+		NET_ERR("Failed to send ARP response.\n");
+	}
 
-		ip_buf_unref(buf);
-	} else
+	ip_buf_unref(buf);
+}
+#else
+#define ethernet_arp_input(buf)
 #endif
 
+void net_driver_ethernet_recv(struct net_buf *buf)
+{
+	if (ethernet_is_arp(buf)) {
+		ethernet_arp_input(buf);
+		return;
+	}
+
 	if (net_recv(buf) != 0) {
 		NET_ERR("Unexpected return value from net_recv.\n");
 		ip_buf_unref(buf);
 	}
 }
 
+void net_driver_ethernet_recv_list(sys_slist_t *list)
+{
+	sys_snode_t *node, *prev = NULL;
+
+	for (node = sys_slist_peek_head(list); node; ) {
+		struct net_buf *buf = (struct net_buf *)node;
+
+		node = sys_slist_peek_next(node);
+
+		if (ethernet_is_arp(buf)) {
+			sys_slist_remove(list, prev, (sys_snode_t *)buf);
+			ethernet_arp_input(buf);
+			continue;
+		}
+
+		prev = (sys_snode_t *)buf;
+	}
+
+	if (!sys_slist_is_empty(list) && net_recv_list(list) != 0) {
+		NET_ERR("Unexpected return value from net_recv_list.\n");
+	}
+}
+
 static struct net_driver net_driver_ethernet = {
 	.head_reserve = 0,
 	.open = net_driver_ethernet_open,
 	.send = net_driver_ethernet_send,
+	.frags = true,
 };
 
 int net_driver_ethernet_init(void)
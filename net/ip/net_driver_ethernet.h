@@ -6,6 +6,7 @@ typedef int (*ethernet_tx_callback)(struct net_buf *buf);
 void net_driver_ethernet_register_tx(ethernet_tx_callback cb);
 bool net_driver_ethernet_is_opened(void);
 void net_driver_ethernet_recv(struct net_buf *buf);
+void net_driver_ethernet_recv_list(sys_slist_t *list);
 
 int net_driver_ethernet_init(void);
 
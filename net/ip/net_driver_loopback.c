@@ -33,6 +33,7 @@
 
 #include <net/net_core.h>
 #include <net/buf.h>
+#include <net/ip_buf.h>
 #include <net/net_ip.h>
 #include <net/net_socket.h>
 
@@ -70,6 +71,37 @@ static int net_driver_loopback_open(void)
 	return 0;
 }
 
+#ifdef CONFIG_NETWORKING_WITH_LOOPBACK_FRAGS
+/* Receive the packet and its fragments in a new buffer, like a driver
+ * gathering them in its DMA buffer would.
+ */
+static int net_driver_loopback_send(struct net_buf *buf)
+{
+	struct net_buf *rx, *frag;
+
+	NET_DBG("received %d bytes and %d bytes in fragments\n",
+		uip_len(buf), ip_buf_frags_len(buf));
+
+	rx = ip_buf_get_reserve_rx(0);
+	if (!rx) {
+		return 0;
+	}
+
+	memcpy(net_buf_add(rx, uip_len(buf)), uip_buf(buf), uip_len(buf));
+
+	for (frag = buf->frags; frag; frag = frag->frags) {
+		memcpy(net_buf_add(rx, frag->len), frag->data, frag->len);
+	}
+
+	uip_len(rx) = rx->len;
+
+	ip_buf_unref(buf);
+
+	net_recv(rx);
+
+	return 1;
+}
+#else
 static int net_driver_loopback_send(struct net_buf *buf)
 {
 	NET_DBG("received %d bytes\n", buf->len);
@@ -78,11 +110,15 @@ static int net_driver_loopback_send(struct net_buf *buf)
 
 	return 1;
 }
+#endif
 
 static struct net_driver net_driver_loopback = {
 	.head_reserve = 0,
 	.open = net_driver_loopback_open,
 	.send = net_driver_loopback_send,
+#ifdef CONFIG_NETWORKING_WITH_LOOPBACK_FRAGS
+	.frags = true,
+#endif
 };
 
 int net_driver_loopback_init(void)
@@ -0,0 +1,184 @@
+/*
+ * Copyright (c) 2016 Intel Corporation.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <zephyr.h>
+#include <string.h>
+#include <misc/printk.h>
+#include <fs.h>
+#include <fs/fat_diskio.h>
+
+/*
+ * @file
+ * @brief File system throughput test
+ * Measures write and read throughput of the FAT file system on flash
+ * for small log-style appends and for large sequential writes, along
+ * with the number of flash erase and write operations they cost.
+ */
+
+#define TEST_FILE "perf.dat"
+#define TEST_SIZE (16 * 1024)
+#define LOG_RECORD_SIZE 32
+#define BULK_SIZE 1024
+
+static uint8_t buf[BULK_SIZE];
+
+static uint32_t ticks_to_ms(uint32_t ticks)
+{
+	return (ticks * 1000) / sys_clock_ticks_per_sec;
+}
+
+static void fill_pattern(uint8_t *data, size_t len, uint32_t ofs)
+{
+	for (size_t i = 0; i < len; i++) {
+		data[i] = (uint8_t)(ofs + i);
+	}
+}
+
+static void print_result(const char *name, uint32_t ticks,
+			 const struct fat_disk_stats *before)
+{
+	struct fat_disk_stats after;
+	uint32_t ms = ticks_to_ms(ticks);
+
+	fat_disk_stats_get(&after);
+
+	printk("%s: %u bytes in %u ms", name, TEST_SIZE, ms);
+	if (ms) {
+		printk(" (%u bytes/s)", (uint32_t)(TEST_SIZE * 1000ULL / ms));
+	}
+	printk("\n");
+
+	printk("  sectors written %u, blocks erased %u, flash writes %u\n",
+	       after.sector_writes - before->sector_writes,
+	       after.block_erases - before->block_erases,
+	       after.flash_writes - before->flash_writes);
+	printk("  cache hits %u, cache evictions %u\n",
+	       after.cache_hits - before->cache_hits,
+	       after.cache_evictions - before->cache_evictions);
+}
+
+static int write_test(const char *name, size_t chunk)
+{
+	struct fat_disk_stats stats;
+	uint32_t start;
+	ZFILE fp;
+	ssize_t brw;
+	int res;
+
+	fat_disk_stats_get(&stats);
+	start = sys_tick_get_32();
+
+	res = fs_open(&fp, TEST_FILE);
+	if (res) {
+		printk("Failed opening file [%d]\n", res);
+		return res;
+	}
+
+	for (uint32_t ofs = 0; ofs < TEST_SIZE; ofs += chunk) {
+		fill_pattern(buf, chunk, ofs);
+
+		brw = fs_write(&fp, buf, chunk);
+		if (brw != chunk) {
+			printk("Failed writing to file [%d]\n", brw);
+			fs_close(&fp);
+			return -1;
+		}
+	}
+
+	/* closing the file flushes the write-back cache */
+	res = fs_close(&fp);
+	if (res) {
+		printk("Error closing file [%d]\n", res);
+		return res;
+	}
+
+	print_result(name, sys_tick_get_32() - start, &stats);
+
+	return 0;
+}
+
+static int read_test(void)
+{
+	struct fat_disk_stats stats;
+	uint32_t start;
+	ZFILE fp;
+	ssize_t brw;
+	int res;
+
+	fat_disk_stats_get(&stats);
+	start = sys_tick_get_32();
+
+	res = fs_open(&fp, TEST_FILE);
+	if (res) {
+		printk("Failed opening file [%d]\n", res);
+		return res;
+	}
+
+	for (uint32_t ofs = 0; ofs < TEST_SIZE; ofs += BULK_SIZE) {
+		brw = fs_read(&fp, buf, BULK_SIZE);
+		if (brw != BULK_SIZE) {
+			printk("Failed reading file [%d]\n", brw);
+			fs_close(&fp);
+			return -1;
+		}
+
+		for (uint32_t i = 0; i < BULK_SIZE; i++) {
+			if (buf[i] != (uint8_t)(ofs + i)) {
+				printk("Data mismatch at offset %u\n", ofs + i);
+				fs_close(&fp);
+				return -1;
+			}
+		}
+	}
+
+	res = fs_close(&fp);
+	if (res) {
+		printk("Error closing file [%d]\n", res);
+		return res;
+	}
+
+	print_result("Read", sys_tick_get_32() - start, &stats);
+
+	return 0;
+}
+
+void main(void)
+{
+	printk("File System Throughput Test\n\n");
+
+	/* start from an empty file so both passes allocate the same way */
+	fs_unlink(TEST_FILE);
+	if (write_test("Log append", LOG_RECORD_SIZE)) {
+		return;
+	}
+
+	if (read_test()) {
+		return;
+	}
+
+	fs_unlink(TEST_FILE);
+	if (write_test("Bulk write", BULK_SIZE)) {
+		return;
+	}
+
+	if (read_test()) {
+		return;
+	}
+
+	fs_unlink(TEST_FILE);
+
+	printk("\nDone\n");
+}
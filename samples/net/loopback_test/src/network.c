@@ -87,6 +87,36 @@ static int data_len;
 #endif
 static unsigned long count = TEST_COUNT;
 
+#if defined(CONFIG_NETWORKING_WITH_LOOPBACK_FRAGS)
+/* Only the start of the text is written in the buffer itself, the rest
+ * of it is linked to the buffer in fragments and sent from there.
+ */
+#define HEAD_LEN 13
+#define FRAG_SIZE 128
+#define FRAG_COUNT 10
+
+static struct nano_fifo frags_fifo;
+static NET_BUF_POOL(frags_pool, FRAG_COUNT, FRAG_SIZE, &frags_fifo, NULL, 0);
+
+static void add_to_frags(struct net_buf *buf, const char *data, size_t len)
+{
+	struct net_buf *frag = net_buf_frag_last(buf);
+	size_t n;
+
+	while (len) {
+		if (frag == buf || !net_buf_tailroom(frag)) {
+			frag = net_buf_get(&frags_fifo, 0);
+			net_buf_frag_add(buf, frag);
+		}
+
+		n = min(len, net_buf_tailroom(frag));
+		memcpy(net_buf_add(frag, n), data, n);
+		data += n;
+		len -= n;
+	}
+}
+#endif
+
 int eval_rcvd_data(char *rcvd_buf, int rcvd_len)
 {
 	int rc = 0;
@@ -158,6 +188,15 @@ void prepare_to_send(struct net_buf *buf, size_t *len)
 	text_len = strlen(text);
 	*len = sys_rand32_get() % text_len;
 
+#if defined(CONFIG_NETWORKING_WITH_LOOPBACK_FRAGS)
+	text_len = min(*len, HEAD_LEN);
+	memcpy(net_buf_add(buf, text_len), text, text_len);
+
+	add_to_frags(buf, text + text_len, *len - text_len);
+	add_to_frags(buf, "", 1);
+
+	ARG_UNUSED(ptr);
+#else
 	/* net_buf_add: returns a pointer to the current tail of
 	 * buf->data before adding n bytes.
 	 * Adding 0 bytes just allows us to get a pointer to the
@@ -171,6 +210,7 @@ void prepare_to_send(struct net_buf *buf, size_t *len)
 	 */
 	ptr = net_buf_add(buf, 1);
 	*ptr = '\0';
+#endif
 
 	*len += 1;
 }
@@ -197,19 +237,22 @@ void fiber_sender(void)
 			prepare_to_send(buf, &len);
 			sent_len = buf->len;
 			header_size = ip_buf_reserve(buf);
-			data_len = sent_len - header_size;
-			ip_buf_appdatalen(buf) = data_len;
+			ip_buf_appdatalen(buf) = sent_len - header_size;
+			data_len = ip_buf_appdatalen(buf) +
+				   ip_buf_frags_len(buf);
+			sent_len += ip_buf_frags_len(buf);
 
 			SYS_LOG_INF("[%d] %s: App data: %d bytes, IPv6+UDP:"
 				   " %d bytes, Total packet size: %d bytes",
 				   sent, __func__, len, header_size, sent_len);
 
+			/* The IP stack releases the buffer once it is sent */
 			if (net_send(buf) < 0) {
 				SYS_LOG_INF("[%d] %s: net_send failed!",
 				      sent, __func__);
 				failure = 1;
+				ip_buf_unref(buf);
 			}
-			ip_buf_unref(buf);
 			sent++;
 		}
 		fiber_wakeup(receiver_id);
@@ -242,6 +285,10 @@ void main(void)
 	net_init();
 	net_driver_loopback_init();
 
+#if defined(CONFIG_NETWORKING_WITH_LOOPBACK_FRAGS)
+	net_buf_pool_init(frags_pool);
+#endif
+
 	any_addr.in6_addr = in6addr_any;
 	any_addr.family = AF_INET6;
 
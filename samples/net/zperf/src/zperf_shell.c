@@ -216,6 +216,7 @@ static void shell_tcp_upload_usage(void)
 static void shell_udp_upload_print_stats(zperf_results *results)
 {
 	unsigned int rate_in_kbps, client_rate_in_kbps;
+	unsigned int rate_in_pps, client_rate_in_pps;
 
 	printk("[%s] Upload completed!\n", CMD_STR_UDP_UPLOAD);
 
@@ -234,6 +235,20 @@ static void shell_udp_upload_print_stats(zperf_results *results)
 	else
 		client_rate_in_kbps = 0;
 
+	if (results->time_in_us != 0)
+		rate_in_pps = (uint32_t) (((uint64_t) results->nb_packets_rcvd
+				* (uint64_t) USEC_PER_SEC)
+				/ (uint64_t) results->time_in_us);
+	else
+		rate_in_pps = 0;
+
+	if (results->client_time_in_us != 0)
+		client_rate_in_pps = (uint32_t) (((uint64_t) results->nb_packets_sent
+				* (uint64_t) USEC_PER_SEC)
+				/ (uint64_t) results->client_time_in_us);
+	else
+		client_rate_in_pps = 0;
+
 	if (!rate_in_kbps)
 		printk("[%s] LAST PACKET NOT RECEIVED!!!\n", CMD_STR_UDP_UPLOAD);
 
@@ -262,6 +277,9 @@ static void shell_udp_upload_print_stats(zperf_results *results)
 	printk("\t(");
 	print_number(client_rate_in_kbps, KBPS, KBPS_UNIT);
 	printk(")\n");
+
+	printk("[%s] packet rate:\t\t%u pps\t(%u pps)\n", CMD_STR_UDP_UPLOAD,
+			rate_in_pps, client_rate_in_pps);
 }
 
 static void shell_tcp_upload_print_stats(zperf_results *results)
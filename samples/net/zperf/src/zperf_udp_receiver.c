@@ -157,7 +157,7 @@ static void zperf_rx_fiber(int port)
 
 			/* If necessary send statistic */
 			if (session->state == STATE_LAST_PACKET_RECEIVED) {
-				uint32_t rate_in_kbps;
+				uint32_t rate_in_kbps, rate_in_pps;
 				uint32_t duration = HW_CYCLES_TO_USEC(
 						time_delta(session->start_time, time));
 
@@ -172,6 +172,14 @@ static void zperf_rx_fiber(int port)
 				else
 					rate_in_kbps = 0;
 
+				/* Compute packet rate */
+				if (duration != 0)
+					rate_in_pps = (uint32_t) (((uint64_t) session->counter
+							* (uint64_t) USEC_PER_SEC)
+							/ (uint64_t) duration);
+				else
+					rate_in_pps = 0;
+
 				/* Fill static */
 				session->stat.flags = z_htonl(0x80000000);
 				session->stat.total_len1 = z_htonl(session->length >> 32);
@@ -208,6 +216,8 @@ static void zperf_rx_fiber(int port)
 				printk(TAG " rate:\t\t\t");
 				print_number(rate_in_kbps, KBPS, KBPS_UNIT);
 				printk("\n");
+
+				printk(TAG " packet rate:\t\t%u pps\n", rate_in_pps);
 			} else {
 				/* Free the buffer */
 				ip_buf_unref(buf);
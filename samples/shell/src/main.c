@@ -15,8 +15,11 @@
  */
 
 #include <zephyr.h>
+#include <stdlib.h>
 #include <misc/printk.h>
+#include <misc/util.h>
 #include <misc/shell.h>
+#include <misc/thread_runtime.h>
 #define DEVICE_NAME "test shell"
 
 static int shell_cmd_ping(int argc, char *argv[])
@@ -40,11 +43,67 @@ static int shell_cmd_highticks(int argc, char *argv[])
 	return 0;
 }
 
+#ifdef CONFIG_THREAD_RUNTIME_STATS
+#define TOP_MAX_THREADS 16
+
+static struct sys_thread_runtime top_threads[TOP_MAX_THREADS];
+
+/* share of the window in tenths of a percent */
+static uint32_t top_permille(uint32_t cycles, uint32_t window)
+{
+	return cycles / max(window / 1000, 1);
+}
+
+static void top_print(void)
+{
+	struct sys_runtime_snapshot snap;
+	uint32_t share;
+	int i;
+
+	sys_runtime_snapshot(&snap, top_threads, TOP_MAX_THREADS);
+
+	printk("\nthread\t\ttype\tprio\tcpu\n");
+
+	for (i = 0; i < snap.num_threads; i++) {
+		share = top_permille(top_threads[i].cycles, snap.window);
+
+		printk("%p\t%s\t%d\t%u.%u%%\n", top_threads[i].thread,
+		       top_threads[i].prio < 0 ? "task" : "fiber",
+		       top_threads[i].prio, share / 10, share % 10);
+	}
+
+	share = top_permille(snap.isr, snap.window);
+	printk("ISRs\t\t\t\t%u.%u%%\n", share / 10, share % 10);
+}
+
+static int shell_cmd_top(int argc, char *argv[])
+{
+	struct sys_runtime_snapshot snap;
+	int count = 5;
+
+	if (argc > 1) {
+		count = atoi(argv[1]);
+	}
+
+	/* start a fresh window */
+	sys_runtime_snapshot(&snap, NULL, 0);
+
+	while (count-- > 0) {
+		fiber_sleep(SECONDS(1));
+		top_print();
+	}
+
+	return 0;
+}
+#endif /* CONFIG_THREAD_RUNTIME_STATS */
 
 const struct shell_cmd commands[] = {
 	{ "ping", shell_cmd_ping },
 	{ "ticks", shell_cmd_ticks },
 	{ "highticks", shell_cmd_highticks },
+#ifdef CONFIG_THREAD_RUNTIME_STATS
+	{ "top", shell_cmd_top, "[refreshes]" },
+#endif
 	{ NULL, NULL }
 };
 
@@ -0,0 +1,234 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2016 Intel Corporation.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""Decode a kernel event stream into a timeline.
+
+The input is either the raw bytes captured from the stream UART
+(CONFIG_KERNEL_EVENT_LOGGER_STREAM_UART), or a dump of the _sys_k_event_stream
+RAM buffer (CONFIG_KERNEL_EVENT_LOGGER_STREAM_RAM), taken for instance from
+gdb attached to QEMU:
+
+    (gdb) dump binary value events.bin _sys_k_event_stream
+
+or from the QEMU monitor, using the address and size of the symbol as given
+by nm -S:
+
+    (qemu) pmemsave <address> <size> events.bin
+
+The stream format is described in kernel/nanokernel/kernel_event_stream.c.
+"""
+
+import argparse
+import struct
+import subprocess
+import sys
+
+STREAM_MAGIC = 0xc1fc1fc1
+STREAM_VERSION = 1
+STREAM_BACKEND_RAM = 1
+STREAM_PAD = 0xff
+
+HEADER = struct.Struct("<IBBHI")
+RAM_STATE = struct.Struct("<IIII")
+
+EVENT_CONTEXT_SWITCH = 1
+EVENT_INTERRUPT = 2
+EVENT_SLEEP = 3
+EVENT_TASK_STATE_CHANGE = 4
+EVENT_CMD_PACKET = 5
+EVENT_KEVENT = 6
+EVENT_OBJECT = 7
+
+OBJECT_OPS = {
+    1: "sem give",
+    2: "sem take",
+    3: "fifo put",
+    4: "fifo get",
+    5: "mutex lock",
+    6: "mutex unlock",
+    7: "timer expiry",
+}
+
+
+class Symbols:
+    """Map addresses to the symbols containing them."""
+
+    def __init__(self, elf=None, nm="nm"):
+        self.symbols = []
+        if elf:
+            self.load(elf, nm)
+
+    def load(self, elf, nm):
+        out = subprocess.check_output([nm, "-S", "-n", elf])
+        for line in out.decode().splitlines():
+            fields = line.split()
+            if len(fields) != 4 or fields[2] not in "bBdDtT":
+                continue
+            self.symbols.append((int(fields[0], 16), int(fields[1], 16),
+                                 fields[3]))
+
+    def name(self, addr):
+        for start, size, name in self.symbols:
+            if start <= addr < start + size:
+                if addr == start:
+                    return name
+                return "%s+0x%x" % (name, addr - start)
+        return "0x%08x" % addr
+
+
+def parse_records(data, offset, end):
+    """Yield (event_id, words) for the records in data[offset:end]."""
+    while offset < end:
+        event_id = data[offset]
+        if event_id == STREAM_PAD:
+            return
+        if offset + 2 > end:
+            raise ValueError("truncated record at offset %d" % offset)
+        size = data[offset + 1]
+        offset += 2
+        if offset + 4 * size > end:
+            raise ValueError("truncated record at offset %d" % offset)
+        words = struct.unpack_from("<%dI" % size, data, offset)
+        offset += 4 * size
+        yield event_id, words
+
+
+def read_stream(data):
+    """Return the stream frequency, dropped record count and records."""
+    start = data.find(struct.pack("<I", STREAM_MAGIC))
+    if start < 0:
+        raise ValueError("no kernel event stream header found")
+    if start > 0:
+        sys.stderr.write("skipping %d bytes before the stream header\n"
+                         % start)
+
+    magic, version, backend, _, freq = HEADER.unpack_from(data, start)
+    if version != STREAM_VERSION:
+        raise ValueError("unsupported stream version %d" % version)
+    offset = start + HEADER.size
+
+    if backend != STREAM_BACKEND_RAM:
+        return freq, 0, list(parse_records(data, offset, len(data)))
+
+    size, head, tail, dropped = RAM_STATE.unpack_from(data, offset)
+    ring = data[offset + RAM_STATE.size:offset + RAM_STATE.size + size]
+    if len(ring) != size:
+        raise ValueError("RAM dump is %d bytes short" % (size - len(ring)))
+
+    if tail <= head:
+        records = list(parse_records(ring, tail, head))
+    else:
+        # from the oldest record to the padding byte, then from the start
+        records = list(parse_records(ring, tail, size))
+        records += list(parse_records(ring, 0, head))
+
+    return freq, dropped, records
+
+
+def describe(event_id, words, symbols):
+    """Return the thread or context and the description of an event."""
+    if event_id == EVENT_CONTEXT_SWITCH:
+        return None, "switched out %s" % symbols.name(words[1])
+    if event_id == EVENT_INTERRUPT:
+        return "ISR", "interrupt %d" % words[1]
+    if event_id == EVENT_SLEEP:
+        return "ISR", "woken up by interrupt %d after %d ticks" % (
+            words[2], words[1])
+    if event_id == EVENT_TASK_STATE_CHANGE:
+        return None, "task %d state 0x%08x" % (words[1], words[2])
+    if event_id == EVENT_CMD_PACKET:
+        return None, "task %d command %s" % (words[1],
+                                             symbols.name(words[2]))
+    if event_id == EVENT_KEVENT:
+        return None, "kernel event 0x%08x" % words[1]
+    if event_id == EVENT_OBJECT:
+        op = OBJECT_OPS.get(words[1], "operation %d" % words[1])
+        return symbols.name(words[3]), "%s %s" % (op,
+                                                   symbols.name(words[2]))
+    return None, "event %d: %s" % (event_id,
+                                   " ".join("0x%08x" % w for w in words[1:]))
+
+
+def timeline(records, freq, symbols):
+    """Yield (time, thread, description) for every event."""
+    # context switch events report the thread that was running until then
+    running = [None] * len(records)
+    current = None
+    for i in reversed(range(len(records))):
+        event_id, words = records[i]
+        if event_id == EVENT_CONTEXT_SWITCH and words:
+            current = symbols.name(words[1])
+        running[i] = current
+
+    elapsed = 0
+    last = None
+    for (event_id, words), thread in zip(records, running):
+        if not words:
+            continue
+
+        # unwrap the 32-bit timestamps, tolerating small backward steps
+        if last is not None:
+            delta = (words[0] - last) & 0xffffffff
+            if delta >= 0x80000000:
+                delta -= 0x100000000
+            elapsed += delta
+        last = words[0]
+
+        context, text = describe(event_id, words, symbols)
+        time = elapsed * 1000000.0 / freq if freq else elapsed
+        yield time, context or thread or "?", text
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Decode a kernel event stream into a timeline.")
+    parser.add_argument("stream", help="UART capture or RAM buffer dump")
+    parser.add_argument("-e", "--elf",
+                        help="ELF image to resolve thread and object names")
+    parser.add_argument("--nm", default="nm",
+                        help="nm program of the target toolchain")
+    parser.add_argument("-f", "--freq", type=int,
+                        help="timestamp frequency in Hz, overriding the "
+                             "one in the stream")
+    args = parser.parse_args()
+
+    with open(args.stream, "rb") as f:
+        data = bytearray(f.read())
+
+    try:
+        freq, dropped, records = read_stream(data)
+    except (ValueError, struct.error) as e:
+        sys.exit("%s: %s" % (args.stream, e))
+
+    if args.freq:
+        freq = args.freq
+
+    symbols = Symbols(args.elf, args.nm)
+
+    if dropped:
+        print("# %d older events were overwritten" % dropped)
+    print("# %s  %-24s %s" % ("time (us)" if freq else "time (cycles)",
+                              "thread", "event"))
+
+    for time, thread, text in timeline(records, freq, symbols):
+        if freq:
+            print("%13.3f  %-24s %s" % (time, thread, text))
+        else:
+            print("%13d  %-24s %s" % (time, thread, text))
+
+
+if __name__ == "__main__":
+    main()
@@ -20,6 +20,33 @@
 
 #ifdef SEMA_BENCH
 
+/* number of semaphore signals issued in a row by the burst fiber */
+#define SEMA_BURST_SIZE 16
+#define NR_OF_SEMA_BURSTS (NR_OF_SEMA_RUNS / SEMA_BURST_SIZE)
+
+#define SEMA_FIBER_STACK_SIZE 512
+
+static char __stack sema_fiber_stack[SEMA_FIBER_STACK_SIZE];
+
+/**
+ *
+ * @brief Fiber signaling a semaphore several times in a row
+ *
+ * Fibers do not preempt each other, so all the signals are queued on the
+ * microkernel server's command stack before the server gets to run.
+ *
+ * @return N/A
+ */
+static void sema_burst_fiber(int sema, int unused)
+{
+	int i;
+
+	ARG_UNUSED(unused);
+
+	for (i = 0; i < SEMA_BURST_SIZE; i++) {
+		fiber_sem_give((ksem_t)sema);
+	}
+}
 
 /**
  *
@@ -43,6 +70,20 @@ void sema_test(void)
 	PRINT_F(output_file, FORMAT, "signal semaphore",
 			SYS_CLOCK_HW_CYCLES_TO_NS_AVG(et, NR_OF_SEMA_RUNS));
 
+	task_sem_reset(SEM0);
+
+	et = BENCH_START();
+	for (i = 0; i < NR_OF_SEMA_BURSTS; i++) {
+		task_fiber_start(sema_fiber_stack, SEMA_FIBER_STACK_SIZE,
+				 sema_burst_fiber, (int)SEM0, 0, 5, 0);
+	}
+	et = TIME_STAMP_DELTA_GET(et);
+	check_result();
+
+	PRINT_F(output_file, FORMAT, "signal semaphore from fiber, bursts of 16",
+			SYS_CLOCK_HW_CYCLES_TO_NS_AVG(et,
+				(NR_OF_SEMA_BURSTS * SEMA_BURST_SIZE)));
+
 	task_sem_reset(SEM1);
 	task_sem_give(STARTRCV);
 
@@ -0,0 +1,180 @@
+/*
+ * Copyright (c) 2016 Intel Corporation.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * DESCRIPTION
+ * This file writes a test file to the FAT RAM disk and measures the time
+ * needed for seeks followed by reads at random offsets in it: small reads
+ * within a sector and large sector aligned reads. The same source is built
+ * once with the default FatFs configuration (prj.conf) and once with fast
+ * seek and per file sector buffers (prj_fastseek.conf), so that both can be
+ * compared. All data read back is checked.
+ */
+
+#include <zephyr.h>
+#include <errno.h>
+#include <string.h>
+#include <tc_util.h>
+#include <misc/util.h>
+#include <fs.h>
+
+#define TEST_FILE "random.dat"
+#define FILE_SIZE (48 * 1024)
+#define SECTOR_SIZE 512
+
+/* number of reads measured for each read size */
+#define NUM_READS 500
+
+static const size_t read_sizes[] = { 16, 64, SECTOR_SIZE, 8 * SECTOR_SIZE };
+
+static uint8_t buf[8 * SECTOR_SIZE];
+
+static uint32_t seed = 12345;
+
+/* simple LCG so that every run uses the same offsets */
+static uint32_t random_u32(void)
+{
+	seed = seed * 1103515245 + 12345;
+	return seed >> 8;
+}
+
+static uint8_t pattern(uint32_t ofs)
+{
+	return (uint8_t)(ofs ^ (ofs >> 8));
+}
+
+static int create_file(void)
+{
+	ZFILE fp;
+	ssize_t brw;
+	int res;
+
+	fs_unlink(TEST_FILE);
+
+	res = fs_open(&fp, TEST_FILE);
+	if (res) {
+		TC_ERROR("Failed opening file [%d]\n", res);
+		return res;
+	}
+
+	for (uint32_t ofs = 0; ofs < FILE_SIZE; ofs += sizeof(buf)) {
+		for (uint32_t i = 0; i < sizeof(buf); i++) {
+			buf[i] = pattern(ofs + i);
+		}
+
+		brw = fs_write(&fp, buf, sizeof(buf));
+		if (brw != sizeof(buf)) {
+			TC_ERROR("Failed writing file [%d]\n", brw);
+			fs_close(&fp);
+			return -1;
+		}
+	}
+
+	return fs_close(&fp);
+}
+
+static int random_reads(ZFILE *fp, size_t size)
+{
+	uint32_t start, cycles, ofs;
+	ssize_t brw;
+	int res;
+
+	cycles = 0;
+
+	for (int i = 0; i < NUM_READS; i++) {
+		ofs = random_u32() % (FILE_SIZE - size + 1);
+
+		/* large reads are sector aligned so they skip the buffers */
+		if (size >= SECTOR_SIZE) {
+			ofs = ROUND_DOWN(ofs, SECTOR_SIZE);
+		}
+
+		start = sys_cycle_get_32();
+
+		res = fs_seek(fp, ofs, SEEK_SET);
+		if (res) {
+			TC_ERROR("fs_seek failed [%d]\n", res);
+			return res;
+		}
+
+		brw = fs_read(fp, buf, size);
+
+		cycles += sys_cycle_get_32() - start;
+
+		if (brw != size) {
+			TC_ERROR("Failed reading file [%d]\n", brw);
+			return -1;
+		}
+
+		for (uint32_t j = 0; j < size; j++) {
+			if (buf[j] != pattern(ofs + j)) {
+				TC_ERROR("Data mismatch at offset %u\n", ofs + j);
+				return -1;
+			}
+		}
+	}
+
+	TC_PRINT("| %4u bytes | seek+read: %8u cycles | %6u ns |\n",
+		 size, cycles / NUM_READS,
+		 SYS_CLOCK_HW_CYCLES_TO_NS_AVG(cycles, NUM_READS));
+
+	return 0;
+}
+
+void main(void)
+{
+	int status = TC_FAIL;
+	ZFILE fp;
+	int res;
+
+	TC_START("FAT random read");
+
+	if (create_file()) {
+		goto out;
+	}
+
+	res = fs_open(&fp, TEST_FILE);
+	if (res) {
+		TC_ERROR("Failed opening file [%d]\n", res);
+		goto out;
+	}
+
+	res = fs_file_fastseek_enable(&fp);
+	if (res == -ENOTSUP) {
+		TC_PRINT("Fast seek: disabled\n");
+	} else if (res) {
+		TC_ERROR("Failed enabling fast seek [%d]\n", res);
+		fs_close(&fp);
+		goto out;
+	} else {
+		TC_PRINT("Fast seek: enabled\n");
+	}
+
+	for (int i = 0; i < ARRAY_SIZE(read_sizes); i++) {
+		if (random_reads(&fp, read_sizes[i])) {
+			fs_close(&fp);
+			goto out;
+		}
+	}
+
+	if (fs_close(&fp) == 0) {
+		status = TC_PASS;
+	}
+
+out:
+	TC_END_RESULT(status);
+	TC_END_REPORT(status);
+}
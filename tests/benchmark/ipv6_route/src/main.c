@@ -0,0 +1,175 @@
+/* main.c - IPv6 route lookup benchmark */
+
+/*
+ * Copyright (c) 2016 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * DESCRIPTION
+ * This file fills the IPv6 routing table with an increasing number of
+ * routes, as an RPL border router would, and measures how many route
+ * lookups per second can be done for destinations spread over the whole
+ * table. Most routes are host routes, one in every PREFIX_RATIO routes is
+ * a /64 prefix covering other destinations. The same source is built once
+ * with the route list (prj.conf) and once with the prefix trie
+ * (prj_trie.conf), so that both can be compared.
+ */
+
+#include <zephyr.h>
+#include <tc_util.h>
+#include <misc/util.h>
+
+#include <net/net_core.h>
+
+#include "contiki/ip/uip.h"
+#include "contiki/ipv6/uip-ds6.h"
+
+#define MAX_ROUTES CONFIG_NETWORKING_MAX_ROUTES
+
+#define NUM_NEIGHBORS 4
+
+/* one route in PREFIX_RATIO is a /64 prefix instead of a host route */
+#define PREFIX_RATIO 16
+
+/* number of lookups measured for each table size */
+#define NUM_LOOKUPS 1000
+
+static const int table_sizes[] = { 16, 64, 256, MAX_ROUTES };
+
+/* destinations covered by the routes, host routes or addresses in prefix */
+static uip_ipaddr_t dests[MAX_ROUTES];
+static uip_ipaddr_t nexthops[NUM_NEIGHBORS];
+static int num_dests;
+
+static uint32_t seed = 12345;
+
+/* simple LCG so that every run uses the same addresses */
+static uint16_t random_u16(void)
+{
+	seed = seed * 1103515245 + 12345;
+	return seed >> 16;
+}
+
+static int add_neighbors(void)
+{
+	uip_lladdr_t lladdr;
+	int i;
+
+	for (i = 0; i < NUM_NEIGHBORS; i++) {
+		uip_ip6addr(&nexthops[i], 0xfe80, 0, 0, 0, 0x0200, 0, 0, i + 1);
+
+		memset(&lladdr, 0, sizeof(lladdr));
+		lladdr.addr[sizeof(lladdr) - 1] = i + 1;
+
+		if (!uip_ds6_nbr_add(&nexthops[i], &lladdr, 1,
+				     NBR_REACHABLE)) {
+			TC_ERROR("Cannot add neighbor %d\n", i);
+			return -1;
+		}
+	}
+
+	return 0;
+}
+
+static int add_route(void)
+{
+	uip_ipaddr_t *dest = &dests[num_dests];
+	uint8_t length = 128;
+
+	uip_ip6addr(dest, 0xfd00, 0, 0, num_dests / PREFIX_RATIO,
+		    random_u16(), random_u16(), random_u16(), random_u16());
+
+	if (num_dests % PREFIX_RATIO == PREFIX_RATIO - 1) {
+		length = 64;
+	}
+
+	if (!uip_ds6_route_add(dest, length,
+			       &nexthops[num_dests % NUM_NEIGHBORS])) {
+		TC_ERROR("Cannot add route %d\n", num_dests);
+		return -1;
+	}
+
+	num_dests++;
+
+	return 0;
+}
+
+/**
+ *
+ * @brief Measure the lookup rate with a given number of routes
+ *
+ * @param size Number of routes in the routing table
+ *
+ * @return 0 on success, -1 if a route could not be added or found
+ */
+static int measure(int size)
+{
+	uint32_t start, cycles;
+	int i;
+
+	while (num_dests < size) {
+		if (add_route() != 0) {
+			return -1;
+		}
+	}
+
+	start = sys_cycle_get_32();
+	for (i = 0; i < NUM_LOOKUPS; i++) {
+		if (!uip_ds6_route_lookup(&dests[random_u16() % num_dests])) {
+			TC_ERROR("No route found with %d routes\n", size);
+			return -1;
+		}
+	}
+	cycles = (sys_cycle_get_32() - start) / NUM_LOOKUPS;
+	if (cycles == 0) {
+		cycles = 1;
+	}
+
+	TC_PRINT("| %4d routes | lookup: %7u cycles | %8u lookups/s |\n",
+		 uip_ds6_route_num_routes(), cycles,
+		 sys_clock_hw_cycles_per_sec / cycles);
+
+	return 0;
+}
+
+void main(void)
+{
+	int i, rv = TC_PASS;
+
+	net_init();
+
+	TC_START("IPv6 route lookup rate");
+#ifdef CONFIG_NETWORKING_ROUTE_TRIE
+	TC_PRINT("Backend: prefix trie\n");
+#else
+	TC_PRINT("Backend: route list\n");
+#endif
+
+	if (add_neighbors() != 0) {
+		rv = TC_FAIL;
+		goto done;
+	}
+
+	for (i = 0; i < ARRAY_SIZE(table_sizes); i++) {
+		if (measure(table_sizes[i]) != 0) {
+			rv = TC_FAIL;
+			break;
+		}
+	}
+
+done:
+	TC_END_RESULT(rv);
+	TC_END_REPORT(rv);
+}
@@ -55,6 +55,12 @@ void nanoTest(void)
 
 	nanoIntLockUnlock();
 	printDashLine();
+
+	nanoTimeoutWaiters();
+	printDashLine();
+
+	nanoFiberReady();
+	printDashLine();
 }
 
 #ifdef CONFIG_NANOKERNEL
@@ -0,0 +1,187 @@
+/* nano_fiber_ready.c - measure making a fiber ready with many ready fibers */
+
+/*
+ * Copyright (c) 2016 Wind River Systems, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * DESCRIPTION
+ * This file contains a test which measures how long an interrupt handler
+ * takes to give a semaphore that a low priority fiber waits on, when N
+ * higher priority fibers are already runnable.
+ * A high priority fiber starts N fibers, which are runnable but do not run
+ * since fibers are not preempted, then raises an interrupt whose handler
+ * gives the semaphore. The waiting fiber is made runnable behind the N
+ * fibers. The time spent giving the semaphore is measured for an increasing
+ * number of runnable fibers: with CONFIG_NANO_FIBER_READY_BITMAP it should
+ * not grow with N.
+ */
+
+#include "timestamp.h"
+#include "utils.h"
+
+#include <arch/cpu.h>
+#include <irq_offload.h>
+
+#ifndef STACKSIZE
+#define STACKSIZE 512
+#endif
+
+/* maximum number of runnable fibers */
+#define MAX_READY 32
+
+#ifdef CONFIG_NANO_FIBER_READY_BITMAP
+#define READY_QUEUE "per priority bitmap"
+#else
+#define READY_QUEUE "sorted list"
+#endif
+
+/* priorities of the fibers */
+#define CONTROLLER_PRIO 1
+#define READY_PRIO 10
+#define WAITER_PRIO 20
+
+/* stacks used by the fibers */
+static char __stack readyStacks[MAX_READY][STACKSIZE];
+static char __stack controllerStack[STACKSIZE];
+static char __stack waiterStack[STACKSIZE];
+
+/* semaphore the waiting fiber waits on */
+static struct nano_sem testSema;
+
+/* semaphore given by the waiting fiber once every fiber has run */
+static struct nano_sem doneSema;
+
+/* time spent giving the semaphore */
+static uint32_t timestamp;
+
+/**
+ *
+ * @brief Test ISR giving the semaphore
+ *
+ * @return N/A
+ */
+static void giveIsr(void *unused)
+{
+	ARG_UNUSED(unused);
+
+	timestamp = TIME_STAMP_DELTA_GET(0);
+	nano_isr_sem_give(&testSema);
+	timestamp = TIME_STAMP_DELTA_GET(timestamp);
+}
+
+/**
+ *
+ * @brief Runnable fiber, does nothing when it finally runs
+ *
+ * @return N/A
+ */
+static void fiberReady(void)
+{
+}
+
+/**
+ *
+ * @brief Fiber waiting on the semaphore
+ *
+ * It has the lowest priority, so it runs after all the other fibers.
+ *
+ * @return N/A
+ */
+static void fiberWaiter(void)
+{
+	nano_fiber_sem_take(&testSema, TICKS_UNLIMITED);
+	nano_fiber_sem_give(&doneSema);
+}
+
+/**
+ *
+ * @brief Fiber making N fibers runnable, then raising the interrupt
+ *
+ * @param ready Number of fibers to make runnable
+ *
+ * @return N/A
+ */
+static void fiberController(int ready, int unused)
+{
+	int i;
+
+	ARG_UNUSED(unused);
+
+	for (i = 0; i < ready; i++) {
+		fiber_fiber_start(&readyStacks[i][0], STACKSIZE,
+						  (nano_fiber_entry_t) fiberReady, 0, 0,
+						  READY_PRIO, 0);
+	}
+
+	irq_offload(giveIsr, NULL);
+}
+
+/**
+ *
+ * @brief Measure the time to give the semaphore with N runnable fibers
+ *
+ * @param ready Number of runnable fibers
+ *
+ * @return 0 on success, -1 if a system clock tick disturbed the measurement
+ */
+static int measure(int ready)
+{
+	nano_sem_init(&testSema);
+	nano_sem_init(&doneSema);
+
+	/* the waiter runs right away and blocks on the semaphore */
+	task_fiber_start(&waiterStack[0], STACKSIZE,
+					 (nano_fiber_entry_t) fiberWaiter, 0, 0, WAITER_PRIO, 0);
+
+	bench_test_start();
+
+	task_fiber_start(&controllerStack[0], STACKSIZE,
+					 (nano_fiber_entry_t) fiberController, ready, 0,
+					 CONTROLLER_PRIO, 0);
+
+	nano_task_sem_take(&doneSema, TICKS_UNLIMITED);
+
+	if (bench_test_end() != 0) {
+		errorCount++;
+		PRINT_OVERFLOW_ERROR();
+		return -1;
+	}
+
+	PRINT_FORMAT(" %2d ready fibers: semaphore give time is %lu tcs = %lu nsec",
+				 ready, timestamp, SYS_CLOCK_HW_CYCLES_TO_NS(timestamp));
+	return 0;
+}
+
+/**
+ *
+ * @brief The test main function
+ *
+ * @return 0 on success
+ */
+int nanoFiberReady(void)
+{
+	int ready;
+
+	PRINT_FORMAT(" 7- Measure ISR making a fiber ready behind N ready fibers");
+	PRINT_FORMAT(" ready queue: %s", READY_QUEUE);
+
+	for (ready = 1; ready <= MAX_READY; ready *= 2) {
+		if (measure(ready) != 0) {
+			break;
+		}
+	}
+	return 0;
+}
@@ -0,0 +1,164 @@
+/* nano_timeout_waiters.c - measure timeout handling with many waiters */
+
+/*
+ * Copyright (c) 2016 Wind River Systems, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * DESCRIPTION
+ * This file contains a test which measures how long the system clock tick
+ * handler runs, with interrupts locked, when one of N fibers waiting on the
+ * same semaphore times out.
+ * N - 1 fibers block forever on a semaphore, then one more fiber blocks on
+ * it with a timeout of one tick, so it ends up last in the wait queue. A
+ * tick is then announced from an interrupt handler, which times the fiber
+ * out and removes it from the wait queue. The time spent announcing the
+ * tick is measured for an increasing number of waiters: it should not grow
+ * with N.
+ */
+
+#include "timestamp.h"
+#include "utils.h"
+
+#include <arch/cpu.h>
+#include <irq_offload.h>
+#include <drivers/system_timer.h>
+
+#ifndef STACKSIZE
+#define STACKSIZE 512
+#endif
+
+/* maximum number of fibers waiting on the semaphore */
+#define MAX_WAITERS 16
+
+/* stacks used by the fibers */
+static char __stack blockerStacks[MAX_WAITERS - 1][STACKSIZE];
+static char __stack timedStack[STACKSIZE];
+
+/* semaphore the fibers are waiting on, never given during the measurement */
+static struct nano_sem testSema;
+
+/* time spent announcing the tick */
+static uint32_t timestamp;
+
+/* set by the timed fiber when its wait timed out */
+static volatile int timedOut;
+
+/**
+ *
+ * @brief Test ISR announcing a tick to the nanokernel
+ *
+ * This also advances the system clock by one tick, which does not matter
+ * for this benchmark.
+ *
+ * @return N/A
+ */
+static void announceIsr(void *unused)
+{
+	ARG_UNUSED(unused);
+
+	timestamp = TIME_STAMP_DELTA_GET(0);
+	_nano_sys_clock_tick_announce(1);
+	timestamp = TIME_STAMP_DELTA_GET(timestamp);
+}
+
+/**
+ *
+ * @brief Fiber waiting on the semaphore forever
+ *
+ * @return N/A
+ */
+static void fiberBlocker(void)
+{
+	nano_fiber_sem_take(&testSema, TICKS_UNLIMITED);
+}
+
+/**
+ *
+ * @brief Fiber waiting on the semaphore with a timeout
+ *
+ * @return N/A
+ */
+static void fiberTimed(void)
+{
+	timedOut = !nano_fiber_sem_take(&testSema, 1);
+}
+
+/**
+ *
+ * @brief Measure tick handling time with a given number of waiters
+ *
+ * @param waiters Total number of fibers waiting on the semaphore
+ *
+ * @return 0 on success, -1 if a system clock tick disturbed the measurement
+ */
+static int measure(int waiters)
+{
+	int ret = 0;
+	int i;
+
+	nano_sem_init(&testSema);
+	timedOut = 0;
+
+	bench_test_start();
+
+	for (i = 0; i < waiters - 1; i++) {
+		task_fiber_start(&blockerStacks[i][0], STACKSIZE,
+						 (nano_fiber_entry_t) fiberBlocker, 0, 0, 6, 0);
+	}
+	task_fiber_start(&timedStack[0], STACKSIZE,
+					 (nano_fiber_entry_t) fiberTimed, 0, 0, 6, 0);
+
+	irq_offload(announceIsr, NULL);
+
+	if (bench_test_end() != 0 || !timedOut) {
+		errorCount++;
+		PRINT_OVERFLOW_ERROR();
+		ret = -1;
+	}
+
+	/* let the blocked fibers run to completion */
+	for (i = 0; i < waiters - 1; i++) {
+		nano_task_sem_give(&testSema);
+	}
+
+	if (ret == 0) {
+		PRINT_FORMAT(" %2d waiters: tick handling time is %lu tcs = %lu nsec",
+					 waiters, timestamp,
+					 SYS_CLOCK_HW_CYCLES_TO_NS(timestamp));
+	}
+	return ret;
+}
+
+/**
+ *
+ * @brief The test main function
+ *
+ * @return 0 on success
+ */
+int nanoTimeoutWaiters(void)
+{
+	int waiters;
+
+	PRINT_FORMAT(" 6- Measure tick handling time when 1 of N waiting fibers"
+				 " times out");
+
+	for (waiters = 1; waiters <= MAX_WAITERS; waiters *= 2) {
+		if (measure(waiters) != 0) {
+			break;
+		}
+	}
+	return 0;
+}
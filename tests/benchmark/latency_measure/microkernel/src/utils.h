@@ -93,6 +93,8 @@ int nanoIntToFiber(void);
 int nanoIntToFiberSem(void);
 int nanoCtxSwitch(void);
 int nanoIntLockUnlock(void);
+int nanoTimeoutWaiters(void);
+int nanoFiberReady(void);
 
 /* pointer to the ISR */
 typedef void (*ptestIsr) (void *unused);
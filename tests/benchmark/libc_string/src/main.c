@@ -0,0 +1,135 @@
+/*
+ * Copyright (c) 2016 Intel Corporation.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * DESCRIPTION
+ * This file measures the cycles per byte spent in memcpy(), memset(),
+ * memcmp() and strlen() of the C library for several sizes, with word
+ * aligned buffers and with source and destination misaligned relative to
+ * each other. The results of every call are checked.
+ */
+
+#include <zephyr.h>
+#include <string.h>
+#include <tc_util.h>
+#include <misc/util.h>
+
+#define MAX_SIZE 4096
+
+/* number of calls measured for each size */
+#define NUM_CALLS 50
+
+static const size_t sizes[] = { 16, 64, 256, 1024, MAX_SIZE };
+
+static uint32_t src_words[(MAX_SIZE + 8) / 4];
+static uint32_t dst_words[(MAX_SIZE + 8) / 4];
+
+static unsigned char *src = (unsigned char *)src_words;
+static unsigned char *dst = (unsigned char *)dst_words;
+
+enum {
+	OP_MEMCPY,
+	OP_MEMSET,
+	OP_MEMCMP,
+	OP_STRLEN,
+};
+
+static const char * const op_names[] = {
+	"memcpy", "memset", "memcmp", "strlen",
+};
+
+static int run(int op, size_t size, int src_ofs, int dst_ofs,
+	       uint32_t *cycles)
+{
+	unsigned char *s = src + src_ofs;
+	unsigned char *d = dst + dst_ofs;
+	uint32_t start;
+	int ret = 0;
+
+	memset(s, 'a', size);
+	s[size] = '\0';
+	memcpy(d, s, size);
+
+	start = sys_cycle_get_32();
+
+	for (int i = 0; i < NUM_CALLS; i++) {
+		switch (op) {
+		case OP_MEMCPY:
+			memcpy(d, s, size);
+			break;
+		case OP_MEMSET:
+			memset(d, 'a', size);
+			break;
+		case OP_MEMCMP:
+			ret |= memcmp(d, s, size);
+			break;
+		case OP_STRLEN:
+			ret |= (strlen((char *)s) != size);
+			break;
+		}
+	}
+
+	*cycles = sys_cycle_get_32() - start;
+
+	if (ret || memcmp(d, s, size)) {
+		TC_ERROR("%s returned wrong result for %u bytes\n",
+			 op_names[op], size);
+		return TC_FAIL;
+	}
+
+	return TC_PASS;
+}
+
+static int measure(int op, int src_ofs, int dst_ofs)
+{
+	uint32_t cycles, per_kb;
+
+	for (int i = 0; i < ARRAY_SIZE(sizes); i++) {
+		if (run(op, sizes[i], src_ofs, dst_ofs, &cycles) != TC_PASS) {
+			return TC_FAIL;
+		}
+
+		/* cycles per byte, in 1/1000 */
+		per_kb = (uint64_t)cycles * 1000 / (NUM_CALLS * sizes[i]);
+
+		TC_PRINT("| %s | src+%d dst+%d | %4u bytes | "
+			 "%4u.%03u cycles/byte |\n", op_names[op], src_ofs,
+			 dst_ofs, sizes[i], per_kb / 1000, per_kb % 1000);
+	}
+
+	return TC_PASS;
+}
+
+void main(void)
+{
+	int status = TC_FAIL;
+
+	TC_START("C library string functions");
+
+	if (measure(OP_MEMCPY, 0, 0) || measure(OP_MEMCPY, 1, 0) ||
+	    measure(OP_MEMCPY, 0, 3) || measure(OP_MEMSET, 0, 0) ||
+	    measure(OP_MEMSET, 0, 1) || measure(OP_MEMCMP, 0, 0) ||
+	    measure(OP_MEMCMP, 2, 2) || measure(OP_MEMCMP, 1, 0) ||
+	    measure(OP_STRLEN, 0, 0) || measure(OP_STRLEN, 3, 0)) {
+		goto out;
+	}
+
+	status = TC_PASS;
+
+out:
+	TC_END_RESULT(status);
+	TC_END_REPORT(status);
+}
@@ -0,0 +1,159 @@
+/*
+ * Copyright (c) 2016 Intel Corporation.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * DESCRIPTION
+ * This file measures the time spent in printk() calls made from a fiber
+ * and from an ISR, for messages of different lengths with and without
+ * arguments. The same source is built once with synchronous printk()
+ * (prj.conf) and once with deferred printk() (prj_deferred.conf), so that
+ * the latency added to the caller can be compared.
+ */
+
+#include <zephyr.h>
+#include <tc_util.h>
+#include <misc/util.h>
+#include <misc/printk.h>
+#include <irq_offload.h>
+
+/* number of calls measured for each message */
+#define NUM_CALLS 8
+
+#define STACK_SIZE 1024
+
+static char __stack fiber_stack[STACK_SIZE];
+
+static struct nano_sem done_sem;
+
+static const char text[] = "0123456789abcdefghijklmnopqrstu";
+
+static void msg_short(int i)
+{
+	printk("s%d\n", i);
+}
+
+static void msg_args(int i)
+{
+	printk("a %d %u %x %c\n", -i, i, i, 'z');
+}
+
+static void msg_strings(int i)
+{
+	printk("t%d %s %s\n", i, text, text);
+}
+
+static void msg_long(int i)
+{
+	printk("l%d ----------------------------------------"
+	       "----------------------------------------\n", i);
+}
+
+static const struct {
+	const char *name;
+	void (*fn)(int i);
+} msgs[] = {
+	{ "short", msg_short },
+	{ "args", msg_args },
+	{ "strings", msg_strings },
+	{ "long", msg_long },
+};
+
+struct measure {
+	void (*fn)(int i);
+	int i;
+	uint32_t cycles;
+};
+
+static void timed_call(void *arg)
+{
+	struct measure *m = arg;
+	uint32_t start;
+
+	start = sys_cycle_get_32();
+	m->fn(m->i);
+	m->cycles = sys_cycle_get_32() - start;
+}
+
+static void measure(const char *ctx, int msg, int isr)
+{
+	uint32_t min = UINT32_MAX, max = 0;
+	struct measure m = { .fn = msgs[msg].fn };
+
+	for (m.i = 0; m.i < NUM_CALLS; m.i++) {
+		if (isr) {
+			irq_offload(timed_call, &m);
+		} else {
+			timed_call(&m);
+		}
+
+		min = min(min, m.cycles);
+		max = max(max, m.cycles);
+	}
+
+	/* let the deferred output drain before the results are printed */
+	fiber_sleep(10);
+
+	TC_PRINT("| %s | %s | min %6u | max %6u cycles |\n", ctx,
+		 msgs[msg].name, min, max);
+
+	fiber_sleep(10);
+}
+
+static void bench_fiber(int arg1, int arg2)
+{
+	ARG_UNUSED(arg1);
+	ARG_UNUSED(arg2);
+
+	for (int i = 0; i < ARRAY_SIZE(msgs); i++) {
+		measure("fiber", i, 0);
+	}
+
+	for (int i = 0; i < ARRAY_SIZE(msgs); i++) {
+		measure("isr", i, 1);
+	}
+
+	nano_fiber_sem_give(&done_sem);
+}
+
+void main(void)
+{
+	struct printk_stats stats;
+	int status = TC_FAIL;
+
+	TC_START("printk latency");
+
+	nano_sem_init(&done_sem);
+
+	/* a high priority fiber, the deferred output runs below it */
+	task_fiber_start(fiber_stack, STACK_SIZE, bench_fiber, 0, 0, 5, 0);
+
+	nano_task_sem_take(&done_sem, TICKS_UNLIMITED);
+
+	printk_stats_get(&stats);
+	TC_PRINT("deferred %u, dropped %u, buffer max used %u bytes\n",
+		 stats.deferred, stats.dropped, stats.max_used);
+
+	if (stats.dropped) {
+		TC_ERROR("Messages were dropped\n");
+		goto out;
+	}
+
+	status = TC_PASS;
+
+out:
+	TC_END_RESULT(status);
+	TC_END_REPORT(status);
+}
@@ -0,0 +1,138 @@
+/* main.c - nanokernel timeout queue insertion benchmark */
+
+/*
+ * Copyright (c) 2016 Wind River Systems, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * DESCRIPTION
+ * This file measures the time needed to add a timeout to, and abort it from,
+ * the nanokernel timeout queue while an increasing number of other timeouts
+ * is already pending. The same source is built once with the sorted delta
+ * list (prj.conf) and once with the hierarchical timing wheel
+ * (prj_wheel.conf), so that the two backends can be compared.
+ */
+
+#include <zephyr.h>
+#include <tc_util.h>
+#include <misc/util.h>
+
+#include "timestamp.h"
+
+/* maximum number of pending background timers */
+#define MAX_TIMERS 512
+
+/* number of add/abort pairs measured for each queue depth */
+#define NUM_SAMPLES 200
+
+/* pending timeouts are spread between these bounds, in ticks */
+#define MIN_TIMEOUT 100
+#define MAX_TIMEOUT 100000
+
+static const int queue_depths[] = { 0, 16, 64, 256, MAX_TIMERS };
+
+static struct nano_timer timers[MAX_TIMERS];
+static struct nano_timer probe;
+
+uint32_t tm_off; /* time necessary to read the time */
+
+static uint32_t seed = 12345;
+
+/* simple LCG so that every run uses the same timeout distribution */
+static int random_timeout(void)
+{
+	seed = seed * 1103515245 + 12345;
+	return MIN_TIMEOUT + (seed >> 8) % (MAX_TIMEOUT - MIN_TIMEOUT);
+}
+
+/**
+ *
+ * @brief Measure add and abort latencies with a given number of pending timers
+ *
+ * @param depth Number of timers pending while the probe timer is measured
+ *
+ * @return N/A
+ */
+static void measure(int depth)
+{
+	uint32_t add_time = 0;
+	uint32_t abort_time = 0;
+	uint32_t add_max = 0;
+	uint32_t timestamp;
+	uint32_t delta;
+	int key;
+	int i;
+
+	for (i = 0; i < depth; i++) {
+		nano_timer_start(&timers[i], random_timeout());
+	}
+
+	for (i = 0; i < NUM_SAMPLES; i++) {
+		int ticks = random_timeout();
+
+		/* keep the tick handler from modifying the queue */
+		key = irq_lock();
+
+		timestamp = TIME_STAMP_DELTA_GET(0);
+		nano_timer_start(&probe, ticks);
+		delta = TIME_STAMP_DELTA_GET(timestamp);
+		add_time += delta;
+		if (delta > add_max) {
+			add_max = delta;
+		}
+
+		timestamp = TIME_STAMP_DELTA_GET(0);
+		nano_timer_stop(&probe);
+		abort_time += TIME_STAMP_DELTA_GET(timestamp);
+
+		irq_unlock(key);
+	}
+
+	for (i = 0; i < depth; i++) {
+		nano_timer_stop(&timers[i]);
+	}
+
+	TC_PRINT("| %4d pending | add: avg %6u max %6u tcs"
+		 " | abort: avg %6u tcs |\n", depth,
+		 add_time / NUM_SAMPLES, add_max, abort_time / NUM_SAMPLES);
+}
+
+void main(void)
+{
+	int i;
+
+	bench_test_init();
+
+	TC_START("Nanokernel timeout queue insertion latency");
+#ifdef CONFIG_NANO_TIMEOUT_WHEEL
+	TC_PRINT("Backend: hierarchical timing wheel (%d slots per level)\n",
+		 1 << CONFIG_NANO_TIMEOUT_WHEEL_SLOT_BITS);
+#else
+	TC_PRINT("Backend: sorted delta list\n");
+#endif
+	TC_PRINT("tcs = timer clock cycles: 1 tcs is %u nsec\n",
+		 SYS_CLOCK_HW_CYCLES_TO_NS(1));
+
+	nano_timer_init(&probe, NULL);
+	for (i = 0; i < MAX_TIMERS; i++) {
+		nano_timer_init(&timers[i], NULL);
+	}
+
+	for (i = 0; i < ARRAY_SIZE(queue_depths); i++) {
+		measure(queue_depths[i]);
+	}
+
+	TC_END_REPORT(TC_PASS);
+}
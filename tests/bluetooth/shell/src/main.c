@@ -1786,6 +1786,7 @@ static int cmd_l2cap_send(int argc, char *argv[])
 {
 	static uint8_t buf_data[DATA_MTU] = { [0 ... (DATA_MTU - 1)] = 0xff };
 	int ret, len, count = 1;
+	uint32_t start, ticks, sent = 0;
 	struct net_buf *buf;
 
 	if (argc > 1) {
@@ -1793,6 +1794,7 @@ static int cmd_l2cap_send(int argc, char *argv[])
 	}
 
 	len = min(l2cap_chan.tx.mtu, DATA_MTU - BT_L2CAP_CHAN_SEND_RESERVE);
+	start = sys_tick_get_32();
 
 	while (count--) {
 		buf = net_buf_get_timeout(&data_fifo,
@@ -1806,8 +1808,18 @@ static int cmd_l2cap_send(int argc, char *argv[])
 			net_buf_unref(buf);
 			break;
 		}
+
+		sent += ret;
 	}
 
+	/* Data is queued when this returns, so this includes all but the
+	 * last few segments.
+	 */
+	ticks = max(sys_tick_get_32() - start, 1);
+	printk("Sent %u bytes in %u ms (%u bytes/s)\n", sent,
+	       ticks * sys_clock_us_per_tick / USEC_PER_MSEC,
+	       (uint32_t)((uint64_t)sent * sys_clock_ticks_per_sec / ticks));
+
 	return 0;
 }
 #endif
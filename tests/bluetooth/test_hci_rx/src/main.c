@@ -0,0 +1,248 @@
+/* main.c - HCI RX queue routing test */
+
+/*
+ * Copyright (c) 2016 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * DESCRIPTION
+ * This test checks which HCI events bt_recv() queues ahead of ACL data and
+ * which ones it keeps in order with it. Only the events which refer to no
+ * link may go ahead: a controller may reuse the handle of a link as soon as
+ * it is disconnected, and the events of a link must neither be handled
+ * before its Connection Complete nor after its Disconnection Complete. A
+ * connection set up and torn down behind a burst of advertising reports is
+ * then queued and dispatched as the RX fiber does, and its events must be
+ * handled in the order they were received.
+ */
+
+#include <zephyr.h>
+#include <tc_util.h>
+#include <atomic.h>
+#include <misc/util.h>
+
+#include <bluetooth/bluetooth.h>
+#include <bluetooth/conn.h>
+#include <bluetooth/hci.h>
+#include <net/buf.h>
+
+#include "hci_core.h"
+
+/* no subevent: the event is not an LE meta event */
+#define NO_SUBEVENT	0xff
+
+/* LE meta event without its subevent code */
+#define TRUNCATED	0xfe
+
+struct route {
+	const char *name;
+	uint8_t evt;
+	uint8_t subevent;
+	bool bulk;
+};
+
+/* an event received for a link, or not */
+struct rx_event {
+	const char *name;
+	uint8_t evt;
+	uint8_t subevent;
+	bool link;
+};
+
+static const struct route routes[] = {
+	{ "Disconnection Complete", BT_HCI_EVT_DISCONN_COMPLETE,
+	  NO_SUBEVENT, true },
+	{ "Encryption Change", BT_HCI_EVT_ENCRYPT_CHANGE, NO_SUBEVENT, true },
+	{ "Encryption Key Refresh Complete",
+	  BT_HCI_EVT_ENCRYPT_KEY_REFRESH_COMPLETE, NO_SUBEVENT, true },
+	{ "Remote Features", BT_HCI_EVT_REMOTE_FEATURES,
+	  NO_SUBEVENT, true },
+#if defined(CONFIG_BLUETOOTH_BREDR)
+	{ "Connection Request", BT_HCI_EVT_CONN_REQUEST, NO_SUBEVENT, true },
+	{ "Connection Complete", BT_HCI_EVT_CONN_COMPLETE, NO_SUBEVENT, true },
+	{ "Link Key Request", BT_HCI_EVT_LINK_KEY_REQ, NO_SUBEVENT, true },
+	{ "Authentication Complete", BT_HCI_EVT_AUTH_COMPLETE,
+	  NO_SUBEVENT, true },
+	{ "Extended Inquiry Result", BT_HCI_EVT_EXTENDED_INQUIRY_RESULT,
+	  NO_SUBEVENT, true },
+	{ "Inquiry Complete", BT_HCI_EVT_INQUIRY_COMPLETE, NO_SUBEVENT, false },
+	{ "Remote Name Request Complete",
+	  BT_HCI_EVT_REMOTE_NAME_REQ_COMPLETE, NO_SUBEVENT, false },
+#endif /* CONFIG_BLUETOOTH_BREDR */
+	{ "LE Connection Complete", BT_HCI_EVT_LE_META_EVENT,
+	  BT_HCI_EVT_LE_CONN_COMPLETE, true },
+	{ "LE Advertising Report", BT_HCI_EVT_LE_META_EVENT,
+	  BT_HCI_EVT_LE_ADVERTISING_REPORT, true },
+	{ "LE Connection Update Complete", BT_HCI_EVT_LE_META_EVENT,
+	  BT_HCI_EVT_LE_CONN_UPDATE_COMPLETE, true },
+	{ "LE Remote Features Complete", BT_HCI_EVT_LE_META_EVENT,
+	  BT_HCI_EV_LE_REMOTE_FEAT_COMPLETE, true },
+	{ "LE Long Term Key Request", BT_HCI_EVT_LE_META_EVENT,
+	  BT_HCI_EVT_LE_LTK_REQUEST, true },
+	{ "LE Connection Parameter Request", BT_HCI_EVT_LE_META_EVENT,
+	  BT_HCI_EVT_LE_CONN_PARAM_REQ, true },
+	{ "LE Generate DHKey Complete", BT_HCI_EVT_LE_META_EVENT,
+	  BT_HCI_EVT_LE_GENERATE_DHKEY_COMPLETE, true },
+	{ "LE P256 Public Key Complete", BT_HCI_EVT_LE_META_EVENT,
+	  BT_HCI_EVT_LE_P256_PUBLIC_KEY_COMPLETE, false },
+	{ "truncated LE meta event", BT_HCI_EVT_LE_META_EVENT,
+	  TRUNCATED, false },
+};
+
+/* A link set up behind advertising reports, then torn down, and a new link
+ * reusing its handle. Advertising reports may be handled in any order with
+ * the events of the links.
+ */
+static const struct rx_event conn_events[] = {
+	{ "LE Advertising Report", BT_HCI_EVT_LE_META_EVENT,
+	  BT_HCI_EVT_LE_ADVERTISING_REPORT, false },
+	{ "LE Advertising Report", BT_HCI_EVT_LE_META_EVENT,
+	  BT_HCI_EVT_LE_ADVERTISING_REPORT, false },
+	{ "LE Advertising Report", BT_HCI_EVT_LE_META_EVENT,
+	  BT_HCI_EVT_LE_ADVERTISING_REPORT, false },
+	{ "LE Connection Complete", BT_HCI_EVT_LE_META_EVENT,
+	  BT_HCI_EVT_LE_CONN_COMPLETE, true },
+	{ "LE Long Term Key Request", BT_HCI_EVT_LE_META_EVENT,
+	  BT_HCI_EVT_LE_LTK_REQUEST, true },
+	{ "LE Advertising Report", BT_HCI_EVT_LE_META_EVENT,
+	  BT_HCI_EVT_LE_ADVERTISING_REPORT, false },
+	{ "Encryption Change", BT_HCI_EVT_ENCRYPT_CHANGE, NO_SUBEVENT, true },
+	{ "LE Connection Update Complete", BT_HCI_EVT_LE_META_EVENT,
+	  BT_HCI_EVT_LE_CONN_UPDATE_COMPLETE, true },
+	{ "Disconnection Complete", BT_HCI_EVT_DISCONN_COMPLETE,
+	  NO_SUBEVENT, true },
+	{ "LE Connection Complete", BT_HCI_EVT_LE_META_EVENT,
+	  BT_HCI_EVT_LE_CONN_COMPLETE, true },
+	{ "LE Remote Features Complete", BT_HCI_EVT_LE_META_EVENT,
+	  BT_HCI_EV_LE_REMOTE_FEAT_COMPLETE, true },
+};
+
+static struct nano_fifo avail_evt;
+static NET_BUF_POOL(evt_pool, ARRAY_SIZE(conn_events), 16, &avail_evt,
+		    NULL, 0);
+
+static struct net_buf *evt_buf(uint8_t evt, uint8_t subevent)
+{
+	struct bt_hci_evt_hdr *hdr;
+	struct net_buf *buf;
+
+	buf = net_buf_get(&avail_evt, 0);
+
+	hdr = net_buf_add(buf, sizeof(*hdr));
+	hdr->evt = evt;
+	hdr->len = 0;
+
+	if (subevent != NO_SUBEVENT && subevent != TRUNCATED) {
+		net_buf_add_u8(buf, subevent);
+		hdr->len = 1;
+	}
+
+	return buf;
+}
+
+static bool route_ok(const struct route *route)
+{
+	struct net_buf *buf;
+	bool bulk;
+
+	buf = evt_buf(route->evt, route->subevent);
+	bulk = bt_hci_evt_is_bulk(buf);
+	net_buf_unref(buf);
+
+	TC_PRINT("%s: %s queue\n", route->name, bulk ? "bulk" : "event");
+
+	return bulk == route->bulk;
+}
+
+static bool conn_events_ok(void)
+{
+	struct net_buf *bufs[ARRAY_SIZE(conn_events)];
+	struct nano_fifo evt_queue, bulk_queue;
+	struct net_buf *buf;
+	int i, next = 0;
+	bool ok = true;
+
+	nano_fifo_init(&evt_queue);
+	nano_fifo_init(&bulk_queue);
+
+	/* all received before the RX fiber gets to run, as bt_recv() does */
+	for (i = 0; i < ARRAY_SIZE(conn_events); i++) {
+		bufs[i] = evt_buf(conn_events[i].evt, conn_events[i].subevent);
+		net_buf_put(bt_hci_evt_is_bulk(bufs[i]) ? &bulk_queue :
+			    &evt_queue, bufs[i]);
+	}
+
+	/* dispatched as hci_rx_fiber() does, events queue first */
+	while (1) {
+		buf = net_buf_get_timeout(&evt_queue, 0, TICKS_NONE);
+		if (!buf) {
+			buf = net_buf_get_timeout(&bulk_queue, 0, TICKS_NONE);
+		}
+
+		if (!buf) {
+			break;
+		}
+
+		for (i = 0; bufs[i] != buf; i++) {
+		}
+
+		net_buf_unref(buf);
+
+		if (!conn_events[i].link) {
+			continue;
+		}
+
+		while (!conn_events[next].link) {
+			next++;
+		}
+
+		TC_PRINT("%s handled\n", conn_events[i].name);
+
+		if (i != next) {
+			TC_ERROR("%s handled before %s\n", conn_events[i].name,
+				 conn_events[next].name);
+			ok = false;
+		}
+
+		next = i + 1;
+	}
+
+	return ok;
+}
+
+void main(void)
+{
+	int i, rv = TC_PASS;
+
+	TC_START("Test HCI RX queue routing");
+
+	net_buf_pool_init(evt_pool);
+
+	for (i = 0; i < ARRAY_SIZE(routes); i++) {
+		if (!route_ok(&routes[i])) {
+			TC_ERROR("%s routed to the wrong queue\n",
+				 routes[i].name);
+			rv = TC_FAIL;
+		}
+	}
+
+	if (!conn_events_ok()) {
+		TC_ERROR("link events handled out of order\n");
+		rv = TC_FAIL;
+	}
+
+	TC_END_RESULT(rv);
+	TC_END_REPORT(rv);
+}
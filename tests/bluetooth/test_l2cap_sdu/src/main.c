@@ -0,0 +1,215 @@
+/* main.c - L2CAP LE SDU reassembly test */
+
+/*
+ * Copyright (c) 2016 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * DESCRIPTION
+ * This test feeds the segments of LE credit based SDUs to a channel without
+ * an alloc_buf callback, which gets them as a chain of the received
+ * buffers. The segments come from a pool of CONFIG_BLUETOOTH_ACL_IN_COUNT
+ * buffers, like the ACL buffers of the HCI driver, and are only sent while
+ * the channel has credits left. The credits given and the buffers held by
+ * the SDU must always leave one buffer free, even for SDUs made of more
+ * segments than there are buffers.
+ */
+
+#include <zephyr.h>
+#include <tc_util.h>
+#include <atomic.h>
+#include <misc/byteorder.h>
+#include <misc/util.h>
+
+#include <bluetooth/bluetooth.h>
+#include <bluetooth/conn.h>
+#include <bluetooth/hci.h>
+#include <bluetooth/l2cap.h>
+#include <bluetooth/buf.h>
+#include <net/buf.h>
+
+#include "hci_core.h"
+#include "conn_internal.h"
+#include "l2cap_internal.h"
+
+#define ACL_COUNT	CONFIG_BLUETOOTH_ACL_IN_COUNT
+#define MAX_CREDITS	(ACL_COUNT - 1)
+
+#define SDU_CID		BT_L2CAP_CID_DYN_START
+#define SDU_LEN		240
+
+static struct nano_fifo avail_acl;
+static int acl_used;
+
+static void acl_destroy(struct net_buf *buf)
+{
+	acl_used--;
+	nano_fifo_put(buf->free, buf);
+}
+
+static NET_BUF_POOL(acl_pool, ACL_COUNT, BT_BUF_ACL_IN_SIZE, &avail_acl,
+		    acl_destroy, BT_BUF_USER_DATA_MIN);
+
+static struct bt_conn conn;
+static struct bt_l2cap_le_chan chan;
+
+static uint8_t sdu[SDU_LEN];
+static uint8_t rx_data[SDU_LEN];
+static int rx_len;
+static int rx_frags;
+static int rx_count;
+
+static void chan_recv(struct bt_l2cap_chan *ch, struct net_buf *buf)
+{
+	struct net_buf *frag;
+
+	rx_len = 0;
+	rx_frags = 0;
+	rx_count++;
+
+	for (frag = buf; frag; frag = frag->frags) {
+		if (rx_len + frag->len <= sizeof(rx_data)) {
+			memcpy(rx_data + rx_len, frag->data, frag->len);
+		}
+
+		rx_len += frag->len;
+		rx_frags++;
+	}
+}
+
+static struct bt_l2cap_chan_ops chan_ops = {
+	.recv = chan_recv,
+};
+
+static struct net_buf *peer_segment(int ofs, int len)
+{
+	struct bt_l2cap_hdr *hdr;
+	struct net_buf *buf;
+
+	buf = net_buf_get_timeout(&avail_acl, 0, TICKS_NONE);
+	if (!buf) {
+		return NULL;
+	}
+
+	acl_used++;
+
+	hdr = net_buf_add(buf, sizeof(*hdr));
+	hdr->cid = sys_cpu_to_le16(SDU_CID);
+	hdr->len = sys_cpu_to_le16(len);
+
+	if (!ofs) {
+		net_buf_add_le16(buf, SDU_LEN);
+		len -= BT_L2CAP_SDU_HDR_LEN;
+	}
+
+	memcpy(net_buf_add(buf, len), sdu + ofs, len);
+
+	return buf;
+}
+
+/* Sends an SDU in segments of seg_len bytes as long as the channel gives
+ * credits, and checks that one ACL buffer always stays free.
+ */
+static int test_sdu(int seg_len)
+{
+	struct net_buf *buf;
+	int ofs, len, segs = 0;
+
+	rx_count = 0;
+
+	for (ofs = 0; ofs < SDU_LEN; ofs += len) {
+		len = seg_len;
+		if (!ofs) {
+			len -= BT_L2CAP_SDU_HDR_LEN;
+		}
+
+		len = min(len, SDU_LEN - ofs);
+
+		if (!chan.rx.credits.nsig) {
+			TC_ERROR("no credit left at offset %d\n", ofs);
+			return TC_FAIL;
+		}
+
+		buf = peer_segment(ofs, ofs ? len : len + BT_L2CAP_SDU_HDR_LEN);
+		if (!buf) {
+			TC_ERROR("no ACL buffer left at offset %d\n", ofs);
+			return TC_FAIL;
+		}
+
+		bt_l2cap_recv(&conn, buf);
+		segs++;
+
+		if (chan.rx.credits.nsig + acl_used > MAX_CREDITS) {
+			TC_ERROR("%d credits given while %d buffers are held\n",
+				 chan.rx.credits.nsig, acl_used);
+			return TC_FAIL;
+		}
+	}
+
+	if (rx_count != 1 || rx_len != SDU_LEN ||
+	    memcmp(rx_data, sdu, SDU_LEN)) {
+		TC_ERROR("SDU not received correctly\n");
+		return TC_FAIL;
+	}
+
+	if (acl_used) {
+		TC_ERROR("%d buffers still held after the SDU\n", acl_used);
+		return TC_FAIL;
+	}
+
+	TC_PRINT("%d segments of %d bytes received in %d buffers\n", segs,
+		 seg_len, rx_frags);
+
+	return TC_PASS;
+}
+
+void main(void)
+{
+	int i, rv;
+
+	TC_START("Test L2CAP LE SDU reassembly");
+
+	for (i = 0; i < SDU_LEN; i++) {
+		sdu[i] = i;
+	}
+
+	net_buf_pool_init(acl_pool);
+	bt_l2cap_init();
+
+	/* a connected channel, as left by the connection procedure */
+	conn.type = BT_CONN_TYPE_LE;
+	conn.channels = &chan.chan;
+
+	chan.chan.conn = &conn;
+	chan.chan.ops = &chan_ops;
+	chan.rx.cid = SDU_CID;
+	chan.rx.mtu = SDU_LEN;
+	chan.rx.mps = CONFIG_BLUETOOTH_L2CAP_IN_MTU;
+	nano_sem_init(&chan.rx.credits);
+	for (i = 0; i < MAX_CREDITS; i++) {
+		nano_sem_give(&chan.rx.credits);
+	}
+
+	/* many more segments than ACL buffers, packed together */
+	rv = test_sdu(12);
+
+	/* full segments, chained without any copy */
+	if (rv == TC_PASS) {
+		rv = test_sdu(CONFIG_BLUETOOTH_L2CAP_IN_MTU);
+	}
+
+	TC_END_RESULT(rv);
+	TC_END_REPORT(rv);
+}
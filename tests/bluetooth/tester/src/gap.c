@@ -54,6 +54,17 @@ static void le_disconnected(struct bt_conn *conn, uint8_t reason)
 {
 	struct gap_device_disconnected_ev ev;
 	const bt_addr_le_t *addr = bt_conn_get_dst(conn);
+#if defined(CONFIG_BLUETOOTH_STACK_HCI)
+	struct bt_conn_tx_stats stats;
+
+	/* Report the link throughput to compare links sharing the TX
+	 * scheduler.
+	 */
+	if (!bt_conn_get_tx_stats(conn, &stats)) {
+		SYS_LOG_DBG("TX %u PDUs %u bytes %u fragments in %u ticks",
+			    stats.pdus, stats.bytes, stats.frags, stats.ticks);
+	}
+#endif /* CONFIG_BLUETOOTH_STACK_HCI */
 
 	memcpy(ev.address, addr->a.val, sizeof(ev.address));
 	ev.address_type = addr->type;
@@ -0,0 +1,429 @@
+/*
+ * Copyright (c) 2016 Intel Corporation.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * @file
+ * @brief Concurrent file system access test
+ *
+ * Writer fibers append records to their own files, reader fibers read
+ * random records of a shared file, a high priority fiber writes through
+ * the asynchronous request queue and the main task keeps writing and
+ * reading its own file meanwhile, all on the same FAT RAM disk. Fibers
+ * sleep between operations so that they preempt the task while it is
+ * inside the file system. Every file is checked at the end and the
+ * throughput and volume lock statistics are reported.
+ */
+
+#include <zephyr.h>
+#include <errno.h>
+#include <string.h>
+#include <tc_util.h>
+#include <misc/util.h>
+#include <fs.h>
+
+#define NUM_WRITERS 2
+#define NUM_READERS 2
+#define NUM_FIBERS (NUM_WRITERS + NUM_READERS + 1)
+#define ASYNC_ID NUM_WRITERS
+#define TASK_ID (NUM_WRITERS + 1)
+
+#define RECORD_SIZE 64
+#define NUM_RECORDS 100
+#define NUM_READS 200
+#define TASK_RECORDS 50
+
+#define STACK_SIZE 2048
+
+#define SHARED_FILE "shared.dat"
+
+static char __stack stacks[NUM_FIBERS][STACK_SIZE];
+
+static struct nano_sem done_sem;
+static int errors;
+static uint32_t bytes_moved;
+
+static const char * const file_names[] = {
+	"w0.dat", "w1.dat", "async.dat", "task.dat"
+};
+
+static void fill_record(uint8_t *rec, int id, int seq)
+{
+	for (int i = 0; i < RECORD_SIZE; i++) {
+		rec[i] = (uint8_t)(id * 31 + seq * 7 + i);
+	}
+}
+
+static bool check_record(const uint8_t *rec, int id, int seq)
+{
+	uint8_t expected[RECORD_SIZE];
+
+	fill_record(expected, id, seq);
+
+	return !memcmp(rec, expected, RECORD_SIZE);
+}
+
+static void report_error(const char *what, int id, int res)
+{
+	TC_ERROR("%s failed for %d [%d]\n", what, id, res);
+	errors++;
+}
+
+static int append_record(ZFILE *fp, int id, int seq)
+{
+	uint8_t rec[RECORD_SIZE];
+	ssize_t brw;
+	int res;
+
+	res = fs_seek(fp, 0, SEEK_END);
+	if (res) {
+		return res;
+	}
+
+	fill_record(rec, id, seq);
+
+	brw = fs_write(fp, rec, RECORD_SIZE);
+	if (brw != RECORD_SIZE) {
+		return brw < 0 ? brw : -EIO;
+	}
+
+	bytes_moved += RECORD_SIZE;
+
+	return 0;
+}
+
+static int check_file(const char *name, int id, int records)
+{
+	uint8_t rec[RECORD_SIZE];
+	ZFILE fp;
+	ssize_t brw;
+	int res;
+
+	res = fs_open(&fp, name);
+	if (res) {
+		return res;
+	}
+
+	for (int seq = 0; seq < records; seq++) {
+		brw = fs_read(&fp, rec, RECORD_SIZE);
+		if (brw != RECORD_SIZE || !check_record(rec, id, seq)) {
+			TC_ERROR("%s: record %d is corrupted\n", name, seq);
+			fs_close(&fp);
+			return -EIO;
+		}
+	}
+
+	/* nothing beyond the expected records */
+	brw = fs_read(&fp, rec, RECORD_SIZE);
+	fs_close(&fp);
+
+	return brw ? -EIO : 0;
+}
+
+static void writer_fiber(int id, int unused)
+{
+	ZFILE fp;
+	int res;
+
+	ARG_UNUSED(unused);
+
+	res = fs_open(&fp, file_names[id]);
+	if (res) {
+		report_error("open", id, res);
+		goto out;
+	}
+
+	for (int seq = 0; seq < NUM_RECORDS; seq++) {
+		res = append_record(&fp, id, seq);
+		if (res) {
+			report_error("write", id, res);
+			break;
+		}
+
+		/* close and reopen now and then to exercise directory updates */
+		if (seq % 10 == 9) {
+			fs_close(&fp);
+			res = fs_open(&fp, file_names[id]);
+			if (res) {
+				report_error("reopen", id, res);
+				goto out;
+			}
+		}
+
+		fiber_sleep(1);
+	}
+
+	fs_close(&fp);
+
+out:
+	nano_fiber_sem_give(&done_sem);
+}
+
+static void reader_fiber(int id, int unused)
+{
+	uint8_t rec[RECORD_SIZE];
+	uint32_t seed = id + 1;
+	ZFILE fp;
+	ssize_t brw;
+	int seq;
+	int res;
+
+	ARG_UNUSED(unused);
+
+	res = fs_open(&fp, SHARED_FILE);
+	if (res) {
+		report_error("open", id, res);
+		goto out;
+	}
+
+	for (int i = 0; i < NUM_READS; i++) {
+		seed = seed * 1103515245 + 12345;
+		seq = (seed >> 16) % NUM_RECORDS;
+
+		res = fs_seek(&fp, seq * RECORD_SIZE, SEEK_SET);
+		if (res) {
+			report_error("seek", id, res);
+			break;
+		}
+
+		brw = fs_read(&fp, rec, RECORD_SIZE);
+		if (brw != RECORD_SIZE || !check_record(rec, 0, seq)) {
+			report_error("read", id, brw);
+			break;
+		}
+
+		bytes_moved += RECORD_SIZE;
+
+		if (i % 4 == 3) {
+			fiber_sleep(1);
+		}
+	}
+
+	fs_close(&fp);
+
+out:
+	nano_fiber_sem_give(&done_sem);
+}
+
+static struct nano_sem async_sem;
+static uint32_t max_submit;
+
+static void async_done(struct fs_async_req *req)
+{
+	nano_fiber_sem_give(&async_sem);
+}
+
+static void async_fiber(int id, int unused)
+{
+	static struct fs_async_req req;
+	uint8_t rec[RECORD_SIZE];
+	uint32_t start, submit;
+	ZFILE fp;
+	int res;
+
+	ARG_UNUSED(unused);
+
+	nano_sem_init(&async_sem);
+
+	res = fs_open(&fp, file_names[id]);
+	if (res) {
+		report_error("open", id, res);
+		goto out;
+	}
+
+	for (int seq = 0; seq < NUM_RECORDS; seq++) {
+		fill_record(rec, id, seq);
+
+		req.op = FS_ASYNC_WRITE;
+		req.zfp = &fp;
+		req.offset = seq * RECORD_SIZE;
+		req.ptr = rec;
+		req.size = RECORD_SIZE;
+		req.cb = async_done;
+
+		/* queuing must not wait for the file system */
+		start = sys_cycle_get_32();
+		res = fs_async_submit(&req);
+		submit = sys_cycle_get_32() - start;
+		max_submit = max(max_submit, submit);
+
+		if (res) {
+			report_error("submit", id, res);
+			break;
+		}
+
+		nano_fiber_sem_take(&async_sem, TICKS_UNLIMITED);
+		if (req.result != RECORD_SIZE) {
+			report_error("async write", id, req.result);
+			break;
+		}
+
+		bytes_moved += RECORD_SIZE;
+
+		fiber_sleep(1);
+	}
+
+	fs_close(&fp);
+
+out:
+	nano_fiber_sem_give(&done_sem);
+}
+
+static int prepare_files(void)
+{
+	ZFILE fp;
+	int res;
+
+	for (int i = 0; i < ARRAY_SIZE(file_names); i++) {
+		fs_unlink(file_names[i]);
+	}
+
+	fs_unlink(SHARED_FILE);
+
+	res = fs_open(&fp, SHARED_FILE);
+	if (res) {
+		return res;
+	}
+
+	for (int seq = 0; seq < NUM_RECORDS && !res; seq++) {
+		res = append_record(&fp, 0, seq);
+	}
+
+	fs_close(&fp);
+
+	return res;
+}
+
+static int task_work(void)
+{
+	uint8_t rec[RECORD_SIZE];
+	int finished = 0;
+	int seq = 0;
+	ZFILE fp;
+	ssize_t brw;
+	int res;
+
+	res = fs_open(&fp, file_names[TASK_ID]);
+	if (res) {
+		return res;
+	}
+
+	/* keep the file system busy until every fiber is done */
+	while (finished < NUM_FIBERS) {
+		if (seq < TASK_RECORDS) {
+			res = append_record(&fp, TASK_ID, seq);
+			if (res) {
+				break;
+			}
+			seq++;
+		}
+
+		res = fs_seek(&fp, (seq - 1) * RECORD_SIZE, SEEK_SET);
+		if (res) {
+			break;
+		}
+
+		brw = fs_read(&fp, rec, RECORD_SIZE);
+		if (brw != RECORD_SIZE || !check_record(rec, TASK_ID, seq - 1)) {
+			res = -EIO;
+			break;
+		}
+
+		bytes_moved += RECORD_SIZE;
+
+		while (nano_task_sem_take(&done_sem, TICKS_NONE)) {
+			finished++;
+		}
+	}
+
+	fs_close(&fp);
+
+	return res;
+}
+
+void main(void)
+{
+	struct fs_lock_stats stats;
+	uint32_t start, ticks;
+	int status = TC_FAIL;
+	int fiber = 0;
+	int res;
+
+	TC_START("Test concurrent file system access");
+
+	nano_sem_init(&done_sem);
+
+	res = prepare_files();
+	if (res) {
+		TC_ERROR("Failed preparing files [%d]\n", res);
+		goto out;
+	}
+
+	fs_lock_stats_reset();
+	start = sys_tick_get_32();
+
+	for (int i = 0; i < NUM_WRITERS; i++) {
+		task_fiber_start(stacks[fiber++], STACK_SIZE, writer_fiber,
+				 i, 0, 5, 0);
+	}
+
+	for (int i = 0; i < NUM_READERS; i++) {
+		task_fiber_start(stacks[fiber++], STACK_SIZE, reader_fiber,
+				 i, 0, 6, 0);
+	}
+
+	task_fiber_start(stacks[fiber++], STACK_SIZE, async_fiber,
+			 ASYNC_ID, 0, 2, 0);
+
+	res = task_work();
+	if (res) {
+		TC_ERROR("Task file access failed [%d]\n", res);
+		goto out;
+	}
+
+	ticks = sys_tick_get_32() - start;
+
+	if (errors) {
+		goto out;
+	}
+
+	for (int i = 0; i < NUM_WRITERS; i++) {
+		if (check_file(file_names[i], i, NUM_RECORDS)) {
+			goto out;
+		}
+	}
+
+	if (check_file(file_names[ASYNC_ID], ASYNC_ID, NUM_RECORDS) ||
+	    check_file(file_names[TASK_ID], TASK_ID, TASK_RECORDS) ||
+	    check_file(SHARED_FILE, 0, NUM_RECORDS)) {
+		goto out;
+	}
+
+	TC_PRINT("%u bytes in %u ticks\n", bytes_moved, ticks);
+
+	fs_lock_stats_get(&stats);
+	TC_PRINT("lock: %u acquisitions, %u contended\n",
+		 stats.acquisitions, stats.contentions);
+	TC_PRINT("lock hold: max %u cycles, avg %u cycles\n", stats.max_hold,
+		 (uint32_t)(stats.total_hold / max(stats.acquisitions, 1)));
+	TC_PRINT("lock wait: max %u cycles\n", stats.max_wait);
+	TC_PRINT("async submit: max %u cycles\n", max_submit);
+
+	status = TC_PASS;
+
+out:
+	TC_END_RESULT(status);
+	TC_END_REPORT(status);
+}
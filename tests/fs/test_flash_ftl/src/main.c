@@ -0,0 +1,253 @@
+/*
+ * Copyright (c) 2016 Intel Corporation.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * @file
+ * @brief Flash translation layer test
+ *
+ * Runs the FAT file system over the flash translation layer on the RAM
+ * backed flash simulator. Rewrites a small file many times so the FAT and
+ * directory sectors get hot, then stresses the FTL directly with random
+ * sector writes. Data is checked before and after remounting the FTL, and
+ * the erase counts must stay within the wear leveling threshold without
+ * any erase done in the write path.
+ */
+
+#include <zephyr.h>
+#include <string.h>
+#include <tc_util.h>
+#include <test_rand.h>
+#include <fs.h>
+#include <fs/flash_ftl.h>
+
+#define TEST_FILE "hot.txt"
+#define FILE_REWRITES 300
+
+#define NUM_SECTORS (CONFIG_FS_VOLUME_SIZE / FLASH_FTL_SECTOR_SIZE)
+#define HOT_SECTORS 8
+#define RAW_WRITES 4000
+
+static uint8_t buf[FLASH_FTL_SECTOR_SIZE];
+static uint16_t versions[NUM_SECTORS];
+
+static void fill_sector(uint8_t *data, uint32_t sector, uint16_t version)
+{
+	for (int i = 0; i < FLASH_FTL_SECTOR_SIZE; i++) {
+		data[i] = (uint8_t)(sector * 7 + version + i);
+	}
+}
+
+static int rewrite_file(uint32_t iteration)
+{
+	ZFILE fp;
+	ssize_t brw;
+	int res;
+
+	res = fs_open(&fp, TEST_FILE);
+	if (res) {
+		TC_ERROR("Failed opening file [%d]\n", res);
+		return TC_FAIL;
+	}
+
+	fill_sector(buf, 0, iteration);
+
+	brw = fs_write(&fp, buf, 64);
+	if (brw != 64) {
+		TC_ERROR("Failed writing file [%d]\n", brw);
+		fs_close(&fp);
+		return TC_FAIL;
+	}
+
+	res = fs_close(&fp);
+	if (res) {
+		TC_ERROR("Failed closing file [%d]\n", res);
+		return TC_FAIL;
+	}
+
+	return TC_PASS;
+}
+
+static int check_file(uint32_t iteration)
+{
+	uint8_t expected[64];
+	ZFILE fp;
+	ssize_t brw;
+	int res;
+
+	res = fs_open(&fp, TEST_FILE);
+	if (res) {
+		TC_ERROR("Failed opening file [%d]\n", res);
+		return TC_FAIL;
+	}
+
+	brw = fs_read(&fp, buf, sizeof(expected));
+	fs_close(&fp);
+
+	fill_sector(expected, 0, iteration);
+
+	if (brw != sizeof(expected) || memcmp(buf, expected, brw)) {
+		TC_ERROR("File content mismatch\n");
+		return TC_FAIL;
+	}
+
+	return TC_PASS;
+}
+
+static int remount(void)
+{
+	struct device *dev = device_get_binding(CONFIG_FS_FLASH_DEV_NAME);
+
+	if (!dev || flash_ftl_init(dev) != 0) {
+		TC_ERROR("Failed remounting the FTL\n");
+		return TC_FAIL;
+	}
+
+	return TC_PASS;
+}
+
+static int check_sectors(void)
+{
+	uint8_t expected[FLASH_FTL_SECTOR_SIZE];
+
+	for (uint32_t sector = 0; sector < NUM_SECTORS; sector++) {
+		if (flash_ftl_read(buf, sector, 1) != 0) {
+			TC_ERROR("Failed reading sector %u\n", sector);
+			return TC_FAIL;
+		}
+
+		fill_sector(expected, sector, versions[sector]);
+		if (memcmp(buf, expected, sizeof(expected))) {
+			TC_ERROR("Sector %u content mismatch\n", sector);
+			return TC_FAIL;
+		}
+	}
+
+	return TC_PASS;
+}
+
+static int test_file_rewrites(void)
+{
+	struct flash_ftl_stats stats;
+
+	TC_PRINT("Rewriting %s %d times\n", TEST_FILE, FILE_REWRITES);
+
+	fs_unlink(TEST_FILE);
+
+	for (uint32_t i = 0; i < FILE_REWRITES; i++) {
+		if (rewrite_file(i) != TC_PASS) {
+			return TC_FAIL;
+		}
+	}
+
+	if (check_file(FILE_REWRITES - 1) != TC_PASS) {
+		return TC_FAIL;
+	}
+
+	flash_ftl_stats_get(&stats);
+	TC_PRINT("host writes %u, gc writes %u, erases %u\n",
+		 stats.host_writes, stats.gc_writes, stats.erases);
+
+	if (!stats.erases) {
+		TC_ERROR("Blocks were never reclaimed\n");
+		return TC_FAIL;
+	}
+
+	TC_PRINT("Remounting\n");
+
+	if (remount() != TC_PASS) {
+		return TC_FAIL;
+	}
+
+	return check_file(FILE_REWRITES - 1);
+}
+
+static int test_raw_writes(void)
+{
+	struct flash_ftl_stats stats;
+	uint32_t sector;
+
+	TC_PRINT("Writing %d random sectors\n", RAW_WRITES);
+
+	/* this overwrites the file system, so it has to run last */
+	for (sector = 0; sector < NUM_SECTORS; sector++) {
+		fill_sector(buf, sector, 0);
+		if (flash_ftl_write(buf, sector, 1) != 0) {
+			TC_ERROR("Failed writing sector %u\n", sector);
+			return TC_FAIL;
+		}
+	}
+
+	for (int i = 0; i < RAW_WRITES; i++) {
+		/* most writes go to a few hot sectors, like FAT tables do */
+		if (test_rand() % 10 < 8) {
+			sector = test_rand() % HOT_SECTORS;
+		} else {
+			sector = test_rand() % NUM_SECTORS;
+		}
+
+		fill_sector(buf, sector, ++versions[sector]);
+		if (flash_ftl_write(buf, sector, 1) != 0) {
+			TC_ERROR("Failed writing sector %u\n", sector);
+			return TC_FAIL;
+		}
+	}
+
+	if (check_sectors() != TC_PASS) {
+		return TC_FAIL;
+	}
+
+	TC_PRINT("Remounting\n");
+
+	if (remount() != TC_PASS || check_sectors() != TC_PASS) {
+		return TC_FAIL;
+	}
+
+	flash_ftl_stats_get(&stats);
+	TC_PRINT("host writes %u, gc writes %u, erases %u\n",
+		 stats.host_writes, stats.gc_writes, stats.erases);
+	TC_PRINT("erase count min %u max %u, free blocks %u\n",
+		 stats.min_erase_count, stats.max_erase_count,
+		 stats.free_blocks);
+
+	if (stats.sync_collections) {
+		TC_ERROR("%u erases were done in the write path\n",
+			 stats.sync_collections);
+		return TC_FAIL;
+	}
+
+	if (stats.max_erase_count - stats.min_erase_count >
+	    CONFIG_FS_FAT_FTL_WEAR_LEVEL_THRESHOLD + 1) {
+		TC_ERROR("Erase counts not leveled\n");
+		return TC_FAIL;
+	}
+
+	return TC_PASS;
+}
+
+void main(void)
+{
+	int status;
+
+	TC_START("Test flash translation layer");
+
+	status = test_file_rewrites();
+	if (status == TC_PASS) {
+		status = test_raw_writes();
+	}
+
+	TC_END_RESULT(status);
+	TC_END_REPORT(status);
+}
@@ -0,0 +1,59 @@
+/* test_rand.h - deterministic pseudo-random numbers for test cases */
+
+/*
+ * Copyright (c) 2016 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __TEST_RAND_H__
+#define __TEST_RAND_H__
+
+#include <stdint.h>
+
+/*
+ * A linear congruential generator, so that every run of a test or of a
+ * benchmark sees the same sequence, unlike with sys_rand32_get(). The low
+ * order bits of the state are the least random ones and are dropped.
+ */
+
+#define TEST_RAND_SEED	12345
+#define TEST_RAND_MAX	0xffffff
+
+/**
+ * @brief Get the next pseudo-random number of a sequence
+ *
+ * @param state Sequence state, any value to start a new sequence
+ *
+ * @return A number between 0 and TEST_RAND_MAX
+ */
+static inline uint32_t test_rand_r(uint32_t *state)
+{
+	*state = *state * 1103515245 + 12345;
+
+	return *state >> 8;
+}
+
+/**
+ * @brief Get the next pseudo-random number of the default sequence
+ *
+ * @return A number between 0 and TEST_RAND_MAX
+ */
+static inline uint32_t test_rand(void)
+{
+	static uint32_t state = TEST_RAND_SEED;
+
+	return test_rand_r(&state);
+}
+
+#endif /* __TEST_RAND_H__ */
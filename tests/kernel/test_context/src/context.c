@@ -24,6 +24,7 @@ This module tests the following CPU and thread related routines:
   irq_lock(), irq_unlock(),
   irq_offload(), nanoCpuExcConnect(),
   irq_enable(), irq_disable(),
+and checks the runnable fiber list against a model of it.
  */
 
 #include <tc_util.h>
@@ -32,6 +33,7 @@ This module tests the following CPU and thread related routines:
 #include <irq_offload.h>
 
 #include <util_test_common.h>
+#include <test_rand.h>
 
 /*
  * Include board.h from platform to get IRQ number.
@@ -599,6 +601,152 @@ static void fiberEntry(int task_thread_id, int arg1)
 	}
 }
 
+/*
+ * Runnable fiber list test
+ *
+ * Fibers are made ready with _nano_fiber_ready(), and the fiber at the head
+ * of the list is taken off it as _Swap() does, in a random sequence. A fiber
+ * yielding is taken off the head and made ready again. After every step, the
+ * list must match a model kept in plain arrays: sorted by priority, and in
+ * the order the fibers were made ready within a priority.
+ */
+
+#define MODEL_FIBERS	16
+#define MODEL_STEPS	3000
+
+/* priorities 31 and above share the last level of the ready bitmap */
+#define MODEL_PRIO_MAX	40
+
+static struct tcs modelTcs[MODEL_FIBERS];
+static int modelList[MODEL_FIBERS];	/* expected list, indexes of modelTcs */
+static int modelLen;
+static bool modelReady[MODEL_FIBERS];
+
+static void modelInsert(int fiber)
+{
+	int pos = modelLen;
+
+	while (pos > 0 &&
+	       modelTcs[modelList[pos - 1]].prio > modelTcs[fiber].prio) {
+		modelList[pos] = modelList[pos - 1];
+		pos--;
+	}
+
+	modelList[pos] = fiber;
+	modelLen++;
+	modelReady[fiber] = true;
+
+	_nano_fiber_ready(&modelTcs[fiber]);
+}
+
+static int modelTakeHead(void)
+{
+	int fiber = modelList[0];
+	int i;
+
+	for (i = 1; i < modelLen; i++) {
+		modelList[i - 1] = modelList[i];
+	}
+
+	modelLen--;
+	modelReady[fiber] = false;
+
+	/* what _Swap() does */
+	_nanokernel.fiber = _nanokernel.fiber->link;
+
+	return fiber;
+}
+
+static bool modelCheck(void)
+{
+	struct tcs *tcs = _nanokernel.fiber;
+	int i;
+
+	for (i = 0; i < modelLen; i++, tcs = tcs->link) {
+		if (tcs != &modelTcs[modelList[i]]) {
+			return false;
+		}
+	}
+
+	return tcs == NULL;
+}
+
+/**
+ *
+ * @brief Check the runnable fiber list against a model
+ *
+ * The list must be empty, which is always the case when a task runs.
+ * Interrupts are locked for the whole test, so that no real fiber gets
+ * scheduled while the list holds the fake ones.
+ *
+ * @return TC_PASS on success, TC_FAIL on failure
+ */
+
+static int readyListTest(void)
+{
+	uint32_t seed = TEST_RAND_SEED;
+	unsigned int key;
+	int rv = TC_PASS;
+	int step, fiber;
+
+	key = irq_lock();
+
+	if (_nanokernel.fiber) {
+		irq_unlock(key);
+		TC_ERROR("runnable fiber list not empty in a task\n");
+		return TC_FAIL;
+	}
+
+	for (step = 0; step < MODEL_STEPS; step++) {
+		fiber = test_rand_r(&seed) % MODEL_FIBERS;
+
+		switch (test_rand_r(&seed) % 3) {
+		case 0:
+			/* make a fiber ready, with a new priority */
+			if (modelReady[fiber]) {
+				continue;
+			}
+
+			modelTcs[fiber].prio = test_rand_r(&seed) %
+					       (MODEL_PRIO_MAX + 1);
+			modelInsert(fiber);
+			break;
+		case 1:
+			/* swap to the head fiber */
+			if (modelLen) {
+				modelTakeHead();
+			}
+			break;
+		default:
+			/* the head fiber yields */
+			if (modelLen) {
+				modelInsert(modelTakeHead());
+			}
+			break;
+		}
+
+		if (!modelCheck()) {
+			rv = TC_FAIL;
+			break;
+		}
+	}
+
+	/* the list was empty, and may be corrupted if the test failed */
+	_nanokernel.fiber = NULL;
+	while (modelLen) {
+		modelReady[modelList[--modelLen]] = false;
+	}
+
+	irq_unlock(key);
+
+	if (rv != TC_PASS) {
+		TC_ERROR("  - runnable fiber list differs from the model at step %d\n",
+			 step);
+	}
+
+	return rv;
+}
+
 /*
  * Timeout tests
  *
@@ -916,6 +1064,12 @@ void main(void)
 
 	nano_task_sem_give(&wakeFiber);
 
+	TC_PRINT("Testing the runnable fiber list\n");
+	rv = readyListTest();
+	if (rv != TC_PASS) {
+		goto doneTests;
+	}
+
 	rv = test_timeout();
 	if (rv != TC_PASS) {
 		goto doneTests;
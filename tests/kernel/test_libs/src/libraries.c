@@ -365,6 +365,197 @@ int memcmp_test(void)
 	return TC_PASS;
 }
 
+/*
+ * variables used during alignment testing: every combination of source and
+ * destination offsets within two words is tried with lengths covering the
+ * byte, word and unrolled block paths
+ */
+
+#define ALIGN_OFFSETS 8
+#define ALIGN_LEN 80
+#define ALIGN_BUFSIZE (ALIGN_OFFSETS + ALIGN_LEN + ALIGN_OFFSETS)
+#define GUARD 0xa5
+
+uint32_t align_src_words[ALIGN_BUFSIZE / 4];
+uint32_t align_dst_words[ALIGN_BUFSIZE / 4];
+unsigned char *align_src = (unsigned char *)align_src_words;
+unsigned char *align_dst = (unsigned char *)align_dst_words;
+
+static void align_fill(void)
+{
+	int i;
+
+	for (i = 0; i < ALIGN_BUFSIZE; i++) {
+		align_src[i] = (unsigned char)(i * 7 + 1);
+		align_dst[i] = GUARD;
+	}
+}
+
+/* check that only <len> bytes at <ofs> were written, with value <expected>
+ * or the source pattern when <expected> is negative
+ */
+static int align_check(int ofs, int src_ofs, int len, int expected)
+{
+	unsigned char c;
+	int i;
+
+	for (i = 0; i < ALIGN_BUFSIZE; i++) {
+		if (i < ofs || i >= ofs + len) {
+			c = GUARD;
+		} else if (expected < 0) {
+			c = align_src[src_ofs + i - ofs];
+		} else {
+			c = (unsigned char)expected;
+		}
+
+		if (align_dst[i] != c) {
+			return TC_FAIL;
+		}
+	}
+
+	return TC_PASS;
+}
+
+/**
+ *
+ * @brief Test memory copy at all alignments
+ *
+ * @return TC_PASS or TC_FAIL
+ */
+
+int memcpy_align_test(void)
+{
+	int s, d, len;
+
+	TC_PRINT("\tmemcpy alignment ...\t");
+
+	for (s = 0; s < ALIGN_OFFSETS; s++) {
+		for (d = 0; d < ALIGN_OFFSETS; d++) {
+			for (len = 0; len <= ALIGN_LEN; len++) {
+				align_fill();
+				memcpy(align_dst + d, align_src + s, len);
+
+				if (align_check(d, s, len, -1) != TC_PASS) {
+					TC_PRINT("failed (src %d dst %d len %d)\n",
+						 s, d, len);
+					return TC_FAIL;
+				}
+			}
+		}
+	}
+
+	TC_PRINT("passed\n");
+	return TC_PASS;
+}
+
+/**
+ *
+ * @brief Test memory initialization at all alignments
+ *
+ * @return TC_PASS or TC_FAIL
+ */
+
+int memset_align_test(void)
+{
+	int d, len;
+
+	TC_PRINT("\tmemset alignment ...\t");
+
+	for (d = 0; d < ALIGN_OFFSETS; d++) {
+		for (len = 0; len <= ALIGN_LEN; len++) {
+			align_fill();
+			memset(align_dst + d, 0x181, len);
+
+			if (align_check(d, 0, len, 0x81) != TC_PASS) {
+				TC_PRINT("failed (dst %d len %d)\n", d, len);
+				return TC_FAIL;
+			}
+		}
+	}
+
+	TC_PRINT("passed\n");
+	return TC_PASS;
+}
+
+/**
+ *
+ * @brief Test memory comparison at all alignments
+ *
+ * Compares equal areas, then areas differing in a single byte at each
+ * position, which must be ordered as unsigned bytes.
+ *
+ * @return TC_PASS or TC_FAIL
+ */
+
+int memcmp_align_test(void)
+{
+	int s, d, len, pos;
+
+	TC_PRINT("\tmemcmp alignment ...\t");
+
+	for (s = 0; s < ALIGN_OFFSETS; s++) {
+		for (d = 0; d < ALIGN_OFFSETS; d++) {
+			for (len = 0; len <= ALIGN_LEN; len += 3) {
+				align_fill();
+				memcpy(align_dst + d, align_src + s, len);
+
+				if (memcmp(align_dst + d, align_src + s, len)) {
+					goto fail;
+				}
+
+				for (pos = 0; pos < len; pos++) {
+					align_dst[d + pos] ^= 0x80;
+
+					if ((memcmp(align_dst + d, align_src + s,
+						    len) < 0) !=
+					    (align_dst[d + pos] <
+					     align_src[s + pos])) {
+						goto fail;
+					}
+
+					align_dst[d + pos] ^= 0x80;
+				}
+			}
+		}
+	}
+
+	TC_PRINT("passed\n");
+	return TC_PASS;
+
+fail:
+	TC_PRINT("failed (src %d dst %d len %d)\n", s, d, len);
+	return TC_FAIL;
+}
+
+/**
+ *
+ * @brief Test string length at all alignments
+ *
+ * @return TC_PASS or TC_FAIL
+ */
+
+int strlen_align_test(void)
+{
+	int s, len;
+
+	TC_PRINT("\tstrlen alignment ...\t");
+
+	for (s = 0; s < ALIGN_OFFSETS; s++) {
+		for (len = 0; len < ALIGN_LEN; len++) {
+			memset(align_dst, 'z', ALIGN_BUFSIZE);
+			align_dst[s + len] = '\0';
+
+			if (strlen((char *)align_dst + s) != len) {
+				TC_PRINT("failed (ofs %d len %d)\n", s, len);
+				return TC_FAIL;
+			}
+		}
+	}
+
+	TC_PRINT("passed\n");
+	return TC_PASS;
+}
+
 /**
  *
  * @brief Test string operations library
@@ -377,7 +568,8 @@ int stringTest(void)
 
 	if (memset_test() || strlen_test() || strcmp_test() || strcpy_test() ||
 		strncpy_test() || strncmp_test() || strchr_test() ||
-		memcmp_test()) {
+		memcmp_test() || memcpy_align_test() || memset_align_test() ||
+		memcmp_align_test() || strlen_align_test()) {
 		return TC_FAIL;
 	}
 
@@ -21,7 +21,8 @@ DESCRIPTION
 This modules tests the following memory pool routines:
 
   task_mem_pool_alloc(),
-  task_mem_pool_free()
+  task_mem_pool_free(),
+  task_mem_pool_stats_get()
  */
 
 #include <zephyr.h>
@@ -415,6 +416,100 @@ int poolDefragTest(void)
 	return TC_PASS;
 }
 
+/**
+ *
+ * @brief Check the statistics reported for SECOND_POOL_ID
+ *
+ * @return TC_PASS on success, TC_FAIL on failure
+ */
+
+int poolStatsCheck(uint32_t used, uint32_t maxUsed, uint32_t largestFree)
+{
+	struct k_mem_pool_stats stats;
+
+	task_mem_pool_stats_get(SECOND_POOL_ID, &stats);
+
+	if (stats.total_size != 5 * 1024 || stats.used_size != used ||
+	    stats.max_used_size != maxUsed ||
+	    stats.largest_free_block != largestFree) {
+		TC_ERROR("task_mem_pool_stats_get() returned total %u, used %u, "
+				 "max used %u, largest free %u\n"
+				 "expected total %u, used %u, max used %u, "
+				 "largest free %u\n", stats.total_size, stats.used_size,
+				 stats.max_used_size, stats.largest_free_block,
+				 5 * 1024, used, maxUsed, largestFree);
+		return TC_FAIL;
+	}
+
+	return TC_PASS;
+}
+
+/**
+ *
+ * @brief Test the task_mem_pool_stats_get() API
+ *
+ * SECOND_POOL_ID has five 1 kB blocks and 16 byte minimum blocks.
+ *
+ * @return TC_PASS on success, TC_FAIL on failure
+ */
+
+int poolStatsTest(void)
+{
+	int  i;
+
+	if (poolStatsCheck(0, 0, 1024) != TC_PASS) {
+		return TC_FAIL;
+	}
+
+	/* split one 1 kB block, then take the four other ones */
+
+	if (task_mem_pool_alloc(&blockList[0], SECOND_POOL_ID, 16,
+				TICKS_NONE) != RC_OK) {
+		TC_ERROR("Failed to allocate a 16 byte block\n");
+		return TC_FAIL;
+	}
+
+	for (i = 1; i < 5; i++) {
+		if (task_mem_pool_alloc(&blockList[i], SECOND_POOL_ID, 1024,
+					TICKS_NONE) != RC_OK) {
+			TC_ERROR("Failed to allocate a 1 kB block\n");
+			return TC_FAIL;
+		}
+	}
+
+	if (poolStatsCheck(16 + 4 * 1024, 16 + 4 * 1024, 256) != TC_PASS) {
+		return TC_FAIL;
+	}
+
+	task_mem_pool_free(&blockList[0]);
+
+#ifdef CONFIG_MEM_POOL_FREE_LISTS
+	/* the split block is merged back as soon as it is freed */
+
+	if (poolStatsCheck(4 * 1024, 16 + 4 * 1024, 1024) != TC_PASS) {
+		return TC_FAIL;
+	}
+#else
+	/* the split block is only merged back by defragmentation */
+
+	if (poolStatsCheck(4 * 1024, 16 + 4 * 1024, 256) != TC_PASS) {
+		return TC_FAIL;
+	}
+#endif
+
+	task_mem_pool_defragment(SECOND_POOL_ID);
+
+	if (poolStatsCheck(4 * 1024, 16 + 4 * 1024, 1024) != TC_PASS) {
+		return TC_FAIL;
+	}
+
+	for (i = 1; i < 5; i++) {
+		task_mem_pool_free(&blockList[i]);
+	}
+
+	return poolStatsCheck(0, 16 + 4 * 1024, 1024);
+}
+
 /**
  *
  * @brief Alternate task in the test suite
@@ -474,6 +569,12 @@ void RegressionTask(void)
 		goto doneTests;
 	}
 
+	TC_PRINT("Testing task_mem_pool_stats_get() ...\n");
+	tcRC = poolStatsTest();
+	if (tcRC != TC_PASS) {
+		goto doneTests;
+	}
+
 doneTests:
 	TC_END_RESULT(tcRC);
 	TC_END_REPORT(tcRC);
@@ -28,17 +28,29 @@ char data[] = "ABCDEFGHIJKLMNOPQRSTUVWX";
 
 #define INITIAL_SIZE	2
 
-void main(void)
+/* odd sizes, so that records and byte runs wrap at every possible offset */
+SYS_RING_BUF_DECLARE_SIZE(spsc_ring, 61);
+SYS_RING_BUF8_DECLARE(byte_ring, 97);
+
+#define SPSC_RECORDS	2000
+#define SPSC_BYTES	20000
+#define SPSC_TIMEOUT	(10 * sys_clock_ticks_per_sec)
+
+#define STACK_SIZE	1024
+static char __stack producer_stack[STACK_SIZE];
+
+#define BENCH_ITERATIONS	1000
+SYS_RING_BUF_DECLARE_SIZE(bench_words, 256);
+SYS_RING_BUF8_DECLARE(bench_bytes, 1024);
+
+static int test_word_ring(void)
 {
-	int ret, put_count, i, rv;
+	int ret, put_count, i;
 	uint32_t getdata[6];
 	uint8_t getsize, getval;
 	uint16_t gettype;
 	int dsize = INITIAL_SIZE;
 
-	TC_START("Test ring buffers");
-
-	rv = TC_FAIL;
 	put_count = 0;
 	while (1) {
 		ret = sys_ring_buf_put(&ring_buf, TYPE, VALUE,
@@ -59,7 +71,7 @@ void main(void)
 		printk("Allowed retreival with insufficient destination buffer space\n");
 		if (getsize != INITIAL_SIZE)
 			printk("Correct size wasn't reported back to the caller\n");
-		goto done;
+		return TC_FAIL;
 	}
 
 	for (i = 0; i < put_count; i++) {
@@ -69,7 +81,7 @@ void main(void)
 		if (ret < 0) {
 			printk("Couldn't retrieve a stored value (%d)\n",
 			       ret);
-			goto done;
+			return TC_FAIL;
 		}
 		printk("got %u chunks of type %u and val %u, %u remaining\n",
 		       getsize, gettype, getval,
@@ -77,15 +89,15 @@ void main(void)
 
 		if (memcmp((char *)getdata, data, getsize * sizeof(uint32_t))) {
 			printk("data corrupted\n");
-			goto done;
+			return TC_FAIL;
 		}
 		if (gettype != TYPE) {
 			printk("type information corrupted\n");
-			goto done;
+			return TC_FAIL;
 		}
 		if (getval != VALUE) {
 			printk("value information corrupted\n");
-			goto done;
+			return TC_FAIL;
 		}
 	}
 
@@ -94,14 +106,326 @@ void main(void)
 			       &getsize);
 	if (ret != -EAGAIN) {
 		printk("Got data out of an empty buffer");
-		goto done;
+		return TC_FAIL;
 	}
 	printk("empty buffer detected\n");
 
-	rv = TC_PASS;
-done:
 	printk("head: %d tail: %d\n", ring_buf.head, ring_buf.tail);
 
+	return TC_PASS;
+}
+
+static int test_byte_ring(void)
+{
+	uint8_t in[40], out[40];
+	uint8_t *area;
+	uint32_t size;
+	int i, round;
+
+	for (i = 0; i < sizeof(in); i++) {
+		in[i] = i;
+	}
+
+	/* move the indexes all around the buffer */
+	for (round = 0; round < 10; round++) {
+		if (sys_ring_buf8_put(&byte_ring, in, sizeof(in)) !=
+		    sizeof(in)) {
+			TC_ERROR("short write in round %d\n", round);
+			return TC_FAIL;
+		}
+
+		memset(out, 0, sizeof(out));
+		if (sys_ring_buf8_get(&byte_ring, out, sizeof(out)) !=
+		    sizeof(out) || memcmp(in, out, sizeof(out))) {
+			TC_ERROR("bad read in round %d\n", round);
+			return TC_FAIL;
+		}
+	}
+
+	if (!sys_ring_buf8_is_empty(&byte_ring) ||
+	    sys_ring_buf8_get(&byte_ring, out, sizeof(out)) != 0) {
+		TC_ERROR("got data out of an empty byte buffer\n");
+		return TC_FAIL;
+	}
+
+	/* fill up: one byte always stays free */
+	size = 0;
+	while (sys_ring_buf8_space_get(&byte_ring)) {
+		size += sys_ring_buf8_put(&byte_ring, in, sizeof(in));
+	}
+
+	if (size != byte_ring.size - 1 ||
+	    sys_ring_buf8_put(&byte_ring, in, sizeof(in)) != 0) {
+		TC_ERROR("byte buffer holds %u bytes\n", size);
+		return TC_FAIL;
+	}
+
+	/* drain it in place */
+	while ((size = sys_ring_buf8_get_claim(&byte_ring, &area, 7))) {
+		if (sys_ring_buf8_get_finish(&byte_ring, size)) {
+			TC_ERROR("failed to release %u claimed bytes\n", size);
+			return TC_FAIL;
+		}
+	}
+
+	if (!sys_ring_buf8_is_empty(&byte_ring)) {
+		TC_ERROR("byte buffer not drained by claims\n");
+		return TC_FAIL;
+	}
+
+	/* a claim never spans the end of the buffer */
+	size = sys_ring_buf8_put_claim(&byte_ring, &area, byte_ring.size);
+	if (area + size > byte_ring.buf + byte_ring.size) {
+		TC_ERROR("claimed area overflows the buffer\n");
+		return TC_FAIL;
+	}
+
+	if (sys_ring_buf8_put_finish(&byte_ring, size + 1) != -EINVAL) {
+		TC_ERROR("committed more than the claimed area\n");
+		return TC_FAIL;
+	}
+
+	memset(area, 0x5a, size);
+	sys_ring_buf8_put_finish(&byte_ring, size);
+
+	while (sys_ring_buf8_get(&byte_ring, out, sizeof(out))) {
+	}
+
+	TC_PRINT("byte ring: head %u tail %u\n", byte_ring.head,
+		 byte_ring.tail);
+
+	return TC_PASS;
+}
+
+/*
+ * The producer fiber runs in bursts, waking up on every tick, while the
+ * main task consumes without ever locking interrupts: the fiber preempts
+ * the task anywhere in the middle of a get.
+ */
+static void word_producer(int unused1, int unused2)
+{
+	uint32_t record[8];
+	int seq, i, size32;
+
+	ARG_UNUSED(unused1);
+	ARG_UNUSED(unused2);
+
+	for (seq = 0; seq < SPSC_RECORDS; seq++) {
+		size32 = seq % ARRAY_SIZE(record);
+		for (i = 0; i < size32; i++) {
+			record[i] = seq + i;
+		}
+
+		while (sys_ring_buf_put(&spsc_ring, seq >> 8, seq & 0xff,
+					record, size32) == -EMSGSIZE) {
+			fiber_sleep(1);
+		}
+	}
+}
+
+static int test_word_spsc(void)
+{
+	uint32_t record[8];
+	uint32_t start = sys_tick_get_32();
+	uint16_t type;
+	uint8_t value, size32;
+	int seq = 0;
+	int i;
+
+	task_fiber_start(producer_stack, STACK_SIZE, word_producer, 0, 0, 5, 0);
+
+	while (seq < SPSC_RECORDS) {
+		if (sys_tick_get_32() - start > SPSC_TIMEOUT) {
+			TC_ERROR("timed out after %d records\n", seq);
+			return TC_FAIL;
+		}
+
+		size32 = ARRAY_SIZE(record);
+		if (sys_ring_buf_get(&spsc_ring, &type, &value, record,
+				     &size32) == -EAGAIN) {
+			continue;
+		}
+
+		if (((type << 8) | value) != seq ||
+		    size32 != seq % ARRAY_SIZE(record)) {
+			TC_ERROR("record %d: bad header\n", seq);
+			return TC_FAIL;
+		}
+
+		for (i = 0; i < size32; i++) {
+			if (record[i] != seq + i) {
+				TC_ERROR("record %d: bad data\n", seq);
+				return TC_FAIL;
+			}
+		}
+
+		seq++;
+	}
+
+	TC_PRINT("%d records passed from a fiber to a task\n", seq);
+
+	return TC_PASS;
+}
+
+static void byte_producer(int unused1, int unused2)
+{
+	uint8_t chunk[13];
+	uint32_t written;
+	int sent = 0;
+	int i;
+
+	ARG_UNUSED(unused1);
+	ARG_UNUSED(unused2);
+
+	while (sent < SPSC_BYTES) {
+		for (i = 0; i < sizeof(chunk); i++) {
+			chunk[i] = (uint8_t)(sent + i);
+		}
+
+		written = sys_ring_buf8_put(&byte_ring, chunk,
+					    min(sizeof(chunk),
+						SPSC_BYTES - sent));
+		sent += written;
+
+		if (written < sizeof(chunk)) {
+			fiber_sleep(1);
+		}
+	}
+}
+
+static int test_byte_spsc(void)
+{
+	uint32_t start = sys_tick_get_32();
+	uint8_t *area;
+	uint32_t size;
+	int received = 0;
+	int i;
+
+	task_fiber_start(producer_stack, STACK_SIZE, byte_producer, 0, 0, 5, 0);
+
+	while (received < SPSC_BYTES) {
+		if (sys_tick_get_32() - start > SPSC_TIMEOUT) {
+			TC_ERROR("timed out after %d bytes\n", received);
+			return TC_FAIL;
+		}
+
+		size = sys_ring_buf8_get_claim(&byte_ring, &area, 16);
+		for (i = 0; i < size; i++) {
+			if (area[i] != (uint8_t)(received + i)) {
+				TC_ERROR("byte %d corrupted\n", received + i);
+				return TC_FAIL;
+			}
+		}
+
+		sys_ring_buf8_get_finish(&byte_ring, size);
+		received += size;
+	}
+
+	TC_PRINT("%d bytes passed from a fiber to a task\n", received);
+
+	return TC_PASS;
+}
+
+static void report(const char *what, uint32_t size, uint32_t cycles,
+		   uint32_t bytes)
+{
+	TC_PRINT("%s, %u bytes: %u cycles per operation, "
+		 "%u bytes per 1000 cycles\n", what, size,
+		 cycles / BENCH_ITERATIONS, bytes * 1000 / max(cycles, 1));
+}
+
+static void bench_word_ring(uint8_t size32)
+{
+	uint32_t record[32];
+	uint32_t start, cycles;
+	uint16_t type;
+	uint8_t value, size;
+	int i;
+
+	memset(record, 0, sizeof(record));
+
+	start = sys_cycle_get_32();
+	for (i = 0; i < BENCH_ITERATIONS; i++) {
+		sys_ring_buf_put(&bench_words, TYPE, VALUE, record, size32);
+		size = ARRAY_SIZE(record);
+		sys_ring_buf_get(&bench_words, &type, &value, record, &size);
+	}
+	cycles = sys_cycle_get_32() - start;
+
+	report("word put+get", size32 * sizeof(uint32_t), cycles,
+	       BENCH_ITERATIONS * size32 * sizeof(uint32_t));
+}
+
+static void bench_byte_ring(uint32_t chunk)
+{
+	static uint8_t buf[256];
+	uint32_t start, cycles;
+	int i;
+
+	start = sys_cycle_get_32();
+	for (i = 0; i < BENCH_ITERATIONS; i++) {
+		sys_ring_buf8_put(&bench_bytes, buf, chunk);
+		sys_ring_buf8_get(&bench_bytes, buf, chunk);
+	}
+	cycles = sys_cycle_get_32() - start;
+
+	report("byte put+get", chunk, cycles, BENCH_ITERATIONS * chunk);
+}
+
+static void bench_byte_claim(uint32_t chunk)
+{
+	uint32_t start, cycles, size;
+	uint32_t moved = 0;
+	uint8_t *area;
+	int i;
+
+	start = sys_cycle_get_32();
+	for (i = 0; i < BENCH_ITERATIONS; i++) {
+		size = sys_ring_buf8_put_claim(&bench_bytes, &area, chunk);
+		sys_ring_buf8_put_finish(&bench_bytes, size);
+		size = sys_ring_buf8_get_claim(&bench_bytes, &area, chunk);
+		sys_ring_buf8_get_finish(&bench_bytes, size);
+		moved += size;
+	}
+	cycles = sys_cycle_get_32() - start;
+
+	report("byte claim+finish", chunk, cycles, moved);
+}
+
+static void bench_ring_buf(void)
+{
+	bench_word_ring(1);
+	bench_word_ring(8);
+	bench_word_ring(32);
+
+	bench_byte_ring(16);
+	bench_byte_ring(64);
+	bench_byte_ring(256);
+
+	bench_byte_claim(64);
+	bench_byte_claim(256);
+}
+
+void main(void)
+{
+	int rv;
+
+	TC_START("Test ring buffers");
+
+	rv = test_word_ring();
+	if (rv == TC_PASS) {
+		rv = test_byte_ring();
+	}
+	if (rv == TC_PASS) {
+		rv = test_word_spsc();
+	}
+	if (rv == TC_PASS) {
+		rv = test_byte_spsc();
+	}
+	if (rv == TC_PASS) {
+		bench_ring_buf();
+	}
+
 	TC_END_RESULT(rv);
 	TC_END_REPORT(rv);
 }
@@ -0,0 +1,304 @@
+/* main.c - nanokernel timeout queue test */
+
+/*
+ * Copyright (c) 2016 Wind River Systems, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * DESCRIPTION
+ * This test arms timeouts on the nanokernel timeout queue, then announces
+ * ticks to it directly with interrupts locked, so that it knows exactly
+ * which tick each timeout must expire on. The timeouts are spread over
+ * every level of the timing wheel, around the slot boundaries and beyond
+ * the span of the wheel, so that the wheel wraps around and cascades. Some
+ * timeouts are aborted before they expire, some after, some by the callback
+ * of another timeout, and some re-arm themselves from their callback, with
+ * a random delay or with a period that hashes them back into the wheel slot
+ * being expired.
+ *
+ * Ticks are announced one at a time, then in batches bounded by the next
+ * deadline, as the tickless idle does. The same source is built once with
+ * the sorted delta list (prj.conf) and once with the timing wheel
+ * (prj_wheel.conf), which must behave the same.
+ */
+
+#include <zephyr.h>
+#include <tc_util.h>
+#include <test_rand.h>
+#include <misc/util.h>
+
+#include <wait_q.h>
+
+#ifdef CONFIG_NANO_TIMEOUT_WHEEL
+#define SLOTS (1 << CONFIG_NANO_TIMEOUT_WHEEL_SLOT_BITS)
+#else
+#define SLOTS 8
+#endif
+
+#define NUM_TIMEOUTS 128
+
+/* beyond the span of the wheel of prj_wheel.conf, 4095 ticks */
+#define MAX_DELAY 10000
+
+/* maximum delay of a timeout re-armed from its callback */
+#define MAX_REARM 300
+
+/* maximum number of ticks announced at once */
+#define MAX_BATCH 40
+
+#define NOT_EXPIRED (-1)
+
+/* delays around the wheel slot boundaries, capped to MAX_DELAY */
+static const int32_t edge_delays[] = {
+	1, 2, SLOTS - 1, SLOTS, SLOTS, SLOTS + 1,
+	SLOTS * SLOTS - 1, SLOTS * SLOTS, SLOTS * SLOTS + 1,
+	SLOTS * SLOTS * SLOTS - 1, SLOTS * SLOTS * SLOTS,
+	SLOTS * SLOTS * SLOTS + 1,
+	SLOTS * SLOTS * SLOTS * SLOTS - 1, SLOTS * SLOTS * SLOTS * SLOTS,
+	SLOTS * SLOTS * SLOTS * SLOTS + 1, 2 * SLOTS * SLOTS * SLOTS * SLOTS + 3,
+};
+
+/* periods of timeouts re-armed on every expiry, into the same wheel slot */
+static const int32_t periods[] = { SLOTS, SLOTS * SLOTS };
+
+static struct _nano_timeout timeouts[NUM_TIMEOUTS];
+static int32_t expiry[NUM_TIMEOUTS];	/* tick it must expire on */
+static int32_t expired[NUM_TIMEOUTS];	/* tick it expired on */
+static bool aborted[NUM_TIMEOUTS];
+static bool rearmed[NUM_TIMEOUTS];
+static int partner[NUM_TIMEOUTS];	/* aborted by the callback */
+
+static struct _nano_timeout periodic[ARRAY_SIZE(periods)];
+static int32_t periodic_expiry[ARRAY_SIZE(periods)];
+static int periodic_count[ARRAY_SIZE(periods)];
+
+/* ticks being announced: after batch_start, up to batch_end included */
+static int32_t batch_start;
+static int32_t batch_end;
+static int32_t last_expiry;
+
+static uint32_t seed;
+static int rv;
+
+static void fail(const char *what, int i)
+{
+	/* only report the first failure, the others usually follow from it */
+	if (rv == TC_PASS) {
+		TC_ERROR("timeout %d (expiry %d): %s\n", i, expiry[i], what);
+	}
+
+	rv = TC_FAIL;
+}
+
+static void arm(int i, int32_t now, int32_t delay)
+{
+	expiry[i] = now + delay;
+	_do_nano_timeout_add(NULL, &timeouts[i], NULL, delay);
+}
+
+static void abort_one(int i)
+{
+	bool pending = !aborted[i] && expired[i] == NOT_EXPIRED;
+
+	if ((_do_nano_timeout_abort(&timeouts[i]) == 0) != pending) {
+		fail(pending ? "could not be aborted" : "aborted twice", i);
+	}
+
+	aborted[i] = true;
+}
+
+static void timeout_expire(struct _nano_timeout *t)
+{
+	int i = t - timeouts;
+
+	if (aborted[i] || expired[i] != NOT_EXPIRED) {
+		fail("expired after being aborted or twice", i);
+		return;
+	}
+
+	if (expiry[i] <= batch_start || expiry[i] > batch_end) {
+		fail("expired on the wrong tick", i);
+	}
+
+	if (expiry[i] < last_expiry) {
+		fail("expired out of order", i);
+	}
+
+	last_expiry = expiry[i];
+
+	switch (i % 8) {
+	case 5:
+		/* a callback re-arming its own timeout */
+		if (!rearmed[i]) {
+			rearmed[i] = true;
+			arm(i, expiry[i], 1 + test_rand_r(&seed) % MAX_REARM);
+			return;
+		}
+		break;
+	case 6:
+		/* a callback aborting another timeout, expired or not */
+		abort_one(partner[i]);
+		break;
+	}
+
+	expired[i] = expiry[i];
+}
+
+static void periodic_expire(struct _nano_timeout *t)
+{
+	int i = t - periodic;
+
+	if (periodic_expiry[i] <= batch_start || periodic_expiry[i] > batch_end) {
+		/* not re-armed, it could keep expiring on the same tick */
+		if (rv == TC_PASS) {
+			TC_ERROR("timeout of period %d expired on the wrong tick\n",
+				 periods[i]);
+		}
+		rv = TC_FAIL;
+		return;
+	}
+
+	periodic_count[i]++;
+	periodic_expiry[i] += periods[i];
+	_do_nano_timeout_add(NULL, t, NULL, periods[i]);
+}
+
+/**
+ *
+ * @brief Expire a set of timeouts and check when each one expires
+ *
+ * @param batched Announce several ticks at once
+ *
+ * @return N/A
+ */
+static void test_timeouts(bool batched)
+{
+	int32_t now = 0;
+	int32_t delay = 0;
+	uint32_t ticks;
+	bool halfway = false;
+	int key;
+	int i;
+
+	TC_PRINT("Testing timeouts with %s ticks announced\n",
+		 batched ? "batches of" : "single");
+
+	seed = TEST_RAND_SEED;
+	last_expiry = 0;
+
+	key = irq_lock();
+
+	/* do not start on a slot boundary */
+	for (i = test_rand_r(&seed) % (SLOTS * SLOTS); i > 0; i--) {
+		_nano_timeout_handle_timeouts(1);
+	}
+
+	for (i = 0; i < NUM_TIMEOUTS; i++) {
+		if (i < ARRAY_SIZE(edge_delays)) {
+			delay = min(edge_delays[i], MAX_DELAY);
+		} else if (i % 16) {
+			delay = 1 + test_rand_r(&seed) % MAX_DELAY;
+		}
+		/* else: same expiry as the previous timeout */
+
+		_nano_timeout_init(&timeouts[i], timeout_expire);
+		expired[i] = NOT_EXPIRED;
+		aborted[i] = false;
+		rearmed[i] = false;
+		partner[i] = (i + 1 + test_rand_r(&seed) % (NUM_TIMEOUTS - 1)) %
+			     NUM_TIMEOUTS;
+		arm(i, now, delay);
+	}
+
+	for (i = 0; i < ARRAY_SIZE(periods); i++) {
+		_nano_timeout_init(&periodic[i], periodic_expire);
+		periodic_count[i] = 0;
+		periodic_expiry[i] = now + periods[i];
+		_do_nano_timeout_add(NULL, &periodic[i], NULL, periods[i]);
+	}
+
+	/* abort some timeouts before any expires */
+	for (i = 3; i < NUM_TIMEOUTS; i += 8) {
+		abort_one(i);
+	}
+
+	while (now < MAX_DELAY + MAX_REARM) {
+		ticks = 1;
+		if (batched) {
+			ticks += test_rand_r(&seed) % MAX_BATCH;
+			ticks = min(ticks, _nano_get_earliest_timeouts_deadline());
+		}
+
+		batch_start = now;
+		batch_end = now + ticks;
+		_nano_timeout_handle_timeouts(ticks);
+		now = batch_end;
+
+		/* abort some timeouts half way, expired or not */
+		if (!halfway && now >= MAX_DELAY / 2) {
+			halfway = true;
+			for (i = 1; i < NUM_TIMEOUTS; i += 8) {
+				abort_one(i);
+			}
+		}
+	}
+
+	for (i = 0; i < ARRAY_SIZE(periods); i++) {
+		if (_do_nano_timeout_abort(&periodic[i]) != 0) {
+			TC_ERROR("timeout of period %d not pending\n",
+				 periods[i]);
+			rv = TC_FAIL;
+		} else if (periodic_count[i] != now / periods[i]) {
+			TC_ERROR("timeout of period %d expired %d times in %d ticks\n",
+				 periods[i], periodic_count[i], now);
+			rv = TC_FAIL;
+		}
+	}
+
+	irq_unlock(key);
+
+	for (i = 0; i < NUM_TIMEOUTS; i++) {
+		if (!aborted[i] && expired[i] == NOT_EXPIRED) {
+			fail("never expired", i);
+		}
+	}
+
+	if (_nano_get_earliest_timeouts_deadline() !=
+	    (uint32_t)_nanokernel.task_timeout) {
+		TC_ERROR("timeouts left in the queue\n");
+		rv = TC_FAIL;
+	}
+}
+
+void main(void)
+{
+	TC_START("Test nanokernel timeout queue");
+#ifdef CONFIG_NANO_TIMEOUT_WHEEL
+	TC_PRINT("Backend: hierarchical timing wheel (%d slots per level)\n",
+		 SLOTS);
+#else
+	TC_PRINT("Backend: sorted delta list\n");
+#endif
+
+	rv = TC_PASS;
+
+	test_timeouts(false);
+	if (rv == TC_PASS) {
+		test_timeouts(true);
+	}
+
+	TC_END_RESULT(rv);
+	TC_END_REPORT(rv);
+}
@@ -0,0 +1,220 @@
+/* main.c - Internet checksum test and throughput measurement */
+
+/*
+ * Copyright (c) 2016 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * DESCRIPTION
+ * This test checks net_chksum() and net_chksum_frags() against the byte-wise
+ * one's complement sum the uIP stack used to compute, for every alignment
+ * and for lengths up to a full Ethernet frame, then measures the throughput
+ * of both implementations.
+ */
+
+#include <zephyr.h>
+#include <tc_util.h>
+#include <misc/util.h>
+
+#include <net/buf.h>
+#include <net/net_chksum.h>
+
+#define MAX_LEN 1500
+
+/* number of checksums computed for each throughput measurement */
+#define NUM_SAMPLES 100
+
+static uint8_t data[MAX_LEN + 8] __aligned(4);
+
+static struct nano_fifo frags_fifo;
+static NET_BUF_POOL(frags_pool, 8, 128, &frags_fifo, NULL, 0);
+
+static const uint16_t initial_sums[] = { 0x0000, 0x1234, 0xfffe, 0xffff };
+
+static const int bench_lengths[] = { 20, 64, 576, MAX_LEN };
+
+/* byte-wise reference implementation */
+static uint16_t ref_chksum(uint16_t sum, const uint8_t *ptr, uint16_t len)
+{
+	uint16_t t;
+
+	while (len > 1) {
+		t = (ptr[0] << 8) + ptr[1];
+		sum += t;
+		if (sum < t) {
+			sum++;
+		}
+		ptr += 2;
+		len -= 2;
+	}
+
+	if (len) {
+		t = ptr[0] << 8;
+		sum += t;
+		if (sum < t) {
+			sum++;
+		}
+	}
+
+	return sum;
+}
+
+static uint32_t seed = 12345;
+
+static uint8_t random_byte(void)
+{
+	seed = seed * 1103515245 + 12345;
+	return seed >> 16;
+}
+
+static bool test_vector(void)
+{
+	/* example from RFC 1071 */
+	static const uint8_t rfc1071[] __aligned(4) = {
+		0x00, 0x01, 0xf2, 0x03, 0xf4, 0xf5, 0xf6, 0xf7
+	};
+	uint16_t sum = net_chksum(0, rfc1071, sizeof(rfc1071));
+
+	if (sum != 0xddf2) {
+		TC_ERROR("RFC 1071 example: got 0x%04x\n", sum);
+		return false;
+	}
+
+	return true;
+}
+
+static bool test_alignments(void)
+{
+	uint16_t expected, sum;
+	int i, off, len;
+
+	for (i = 0; i < ARRAY_SIZE(initial_sums); i++) {
+		for (off = 0; off < 8; off++) {
+			for (len = 0; len <= 200; len++) {
+				expected = ref_chksum(initial_sums[i],
+						      &data[off], len);
+				sum = net_chksum(initial_sums[i],
+						 &data[off], len);
+				if (sum != expected) {
+					TC_ERROR("sum 0x%04x off %d len %d: "
+						 "got 0x%04x, expected 0x%04x\n",
+						 initial_sums[i], off, len,
+						 sum, expected);
+					return false;
+				}
+			}
+		}
+	}
+
+	expected = ref_chksum(0, data, MAX_LEN);
+	sum = net_chksum(0, data, MAX_LEN);
+	if (sum != expected) {
+		TC_ERROR("len %d: got 0x%04x, expected 0x%04x\n",
+			 MAX_LEN, sum, expected);
+		return false;
+	}
+
+	return true;
+}
+
+static bool test_frags(void)
+{
+	/* odd and even fragment lengths, the first one is the parent */
+	static const int lengths[] = { 13, 1, 40, 127, 2, 0, 55 };
+	struct net_buf *buf, *frag;
+	uint16_t expected, sum;
+	int i, total = 0;
+	bool ret = true;
+
+	buf = net_buf_get(&frags_fifo, 0);
+	memcpy(net_buf_add(buf, lengths[0]), data, lengths[0]);
+	total += lengths[0];
+
+	for (i = 1; i < ARRAY_SIZE(lengths); i++) {
+		frag = net_buf_get(&frags_fifo, 0);
+		memcpy(net_buf_add(frag, lengths[i]), &data[total],
+		       lengths[i]);
+		net_buf_frag_add(buf, frag);
+		total += lengths[i];
+	}
+
+	for (i = 0; i < ARRAY_SIZE(initial_sums); i++) {
+		expected = ref_chksum(initial_sums[i], data, total);
+		sum = net_chksum_frags(initial_sums[i], buf);
+		if (sum != expected) {
+			TC_ERROR("fragments: got 0x%04x, expected 0x%04x\n",
+				 sum, expected);
+			ret = false;
+			break;
+		}
+	}
+
+	net_buf_unref(buf);
+
+	return ret;
+}
+
+static void measure(int len)
+{
+	volatile uint16_t sum;
+	uint32_t ref_cycles, cycles;
+	uint32_t start;
+	int i;
+
+	start = sys_cycle_get_32();
+	for (i = 0; i < NUM_SAMPLES; i++) {
+		sum = ref_chksum(0, data, len);
+	}
+	ref_cycles = (sys_cycle_get_32() - start) / NUM_SAMPLES;
+
+	start = sys_cycle_get_32();
+	for (i = 0; i < NUM_SAMPLES; i++) {
+		sum = net_chksum(0, data, len);
+	}
+	cycles = (sys_cycle_get_32() - start) / NUM_SAMPLES;
+
+	ARG_UNUSED(sum);
+
+	TC_PRINT("| %4d bytes | byte-wise: %7u cycles | word-wise: %7u cycles |\n",
+		 len, ref_cycles, cycles);
+}
+
+void main(void)
+{
+	int i, rv = TC_PASS;
+
+	TC_START("Test internet checksum");
+
+	net_buf_pool_init(frags_pool);
+
+	for (i = 0; i < sizeof(data); i++) {
+		data[i] = random_byte();
+	}
+
+	if (!test_vector() || !test_alignments() || !test_frags()) {
+		rv = TC_FAIL;
+		goto done;
+	}
+
+	TC_PRINT("Checksum throughput, averaged over %d runs:\n",
+		 NUM_SAMPLES);
+	for (i = 0; i < ARRAY_SIZE(bench_lengths); i++) {
+		measure(bench_lengths[i]);
+	}
+
+done:
+	TC_END_RESULT(rv);
+	TC_END_REPORT(rv);
+}
@@ -0,0 +1,265 @@
+/* main.c - uIP event timer test */
+
+/*
+ * Copyright (c) 2016 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * DESCRIPTION
+ * This test checks the events posted by etimers, whose expirations are
+ * delivered by the system workqueue, and the callbacks of ctimers. The test
+ * runs in a fiber: the workqueue fiber cannot run while the test fiber does
+ * not wait, which opens the window between the expiry of a timer and the
+ * processing of its work item, where the timer is stopped or set again.
+ */
+
+#include <zephyr.h>
+#include <tc_util.h>
+#include <misc/util.h>
+
+#include "contiki/os/sys/etimer.h"
+#include "contiki/os/sys/ctimer.h"
+#include "contiki/os/sys/process.h"
+
+#define TEST_TICKS	10
+
+#define FIBER_STACKSIZE	1024
+#define FIBER_PRIORITY	5
+
+static char __stack fiber_stack[FIBER_STACKSIZE];
+
+static struct nano_sem test_done;
+static int test_result;
+
+static struct etimer et;
+
+static int timer_events;
+static void *last_timer;
+static uint32_t last_tick;
+
+PROCESS(test_process, "etimer test process");
+
+PROCESS_THREAD(test_process, ev, data, buf, user_data)
+{
+	PROCESS_BEGIN();
+
+	while (1) {
+		PROCESS_YIELD_UNTIL(ev == PROCESS_EVENT_TIMER);
+
+		timer_events++;
+		last_timer = data;
+		last_tick = sys_tick_get_32();
+	}
+
+	PROCESS_END();
+}
+
+/* Waits without letting the workqueue fiber run, until more than ticks
+ * ticks have elapsed since start. The timeout of a timer set at start with
+ * that interval has then expired and queued its work item.
+ */
+static void spin_past(uint32_t start, int ticks)
+{
+	while (sys_tick_get_32() - start <= ticks) {
+	}
+}
+
+static bool timer_event_ok(uint32_t start)
+{
+	if (timer_events != 1) {
+		TC_ERROR("%d timer events posted\n", timer_events);
+		return false;
+	}
+
+	if (last_timer != &et) {
+		TC_ERROR("event posted for timer %p\n", last_timer);
+		return false;
+	}
+
+	if (last_tick - start < TEST_TICKS) {
+		TC_ERROR("event posted after %d ticks\n", last_tick - start);
+		return false;
+	}
+
+	return true;
+}
+
+static bool test_set(void)
+{
+	uint32_t start;
+
+	TC_PRINT("Testing etimer_set()\n");
+
+	timer_events = 0;
+	start = sys_tick_get_32();
+	etimer_set(&et, TEST_TICKS, &test_process);
+	fiber_sleep(2 * TEST_TICKS);
+
+	if (!etimer_expired(&et)) {
+		TC_ERROR("timer not expired\n");
+		return false;
+	}
+
+	return timer_event_ok(start);
+}
+
+static bool test_stop(void)
+{
+	TC_PRINT("Testing etimer_stop()\n");
+
+	timer_events = 0;
+	etimer_set(&et, TEST_TICKS, &test_process);
+	fiber_sleep(TEST_TICKS / 2);
+	etimer_stop(&et);
+	fiber_sleep(2 * TEST_TICKS);
+
+	if (timer_events) {
+		TC_ERROR("event posted by a stopped timer\n");
+		return false;
+	}
+
+	return true;
+}
+
+static bool test_restart(void)
+{
+	uint32_t start;
+
+	TC_PRINT("Testing etimer_restart()\n");
+
+	timer_events = 0;
+	etimer_set(&et, TEST_TICKS, &test_process);
+	fiber_sleep(TEST_TICKS / 2);
+	start = sys_tick_get_32();
+	etimer_restart(&et);
+	fiber_sleep(2 * TEST_TICKS);
+
+	return timer_event_ok(start);
+}
+
+static bool test_stop_expired(void)
+{
+	uint32_t start;
+
+	TC_PRINT("Testing etimer_stop() before the expiry is processed\n");
+
+	timer_events = 0;
+	start = sys_tick_get_32();
+	etimer_set(&et, TEST_TICKS, &test_process);
+	spin_past(start, TEST_TICKS);
+
+	if (!etimer_expired(&et)) {
+		TC_ERROR("timer not expired\n");
+		return false;
+	}
+
+	etimer_stop(&et);
+	fiber_sleep(2 * TEST_TICKS);
+
+	if (timer_events) {
+		TC_ERROR("event posted by a timer stopped after its expiry\n");
+		return false;
+	}
+
+	return true;
+}
+
+static bool test_set_expired(void)
+{
+	uint32_t start;
+
+	TC_PRINT("Testing etimer_set() before the expiry is processed\n");
+
+	timer_events = 0;
+	start = sys_tick_get_32();
+	etimer_set(&et, TEST_TICKS, &test_process);
+	spin_past(start, TEST_TICKS);
+
+	start = sys_tick_get_32();
+	etimer_set(&et, TEST_TICKS, &test_process);
+	fiber_sleep(2 * TEST_TICKS);
+
+	return timer_event_ok(start);
+}
+
+static struct ctimer ct[3];
+static void *callbacks[ARRAY_SIZE(ct)];
+static int num_callbacks;
+
+static void ctimer_callback(struct net_buf *buf, void *ptr)
+{
+	if (num_callbacks < ARRAY_SIZE(callbacks)) {
+		callbacks[num_callbacks] = ptr;
+	}
+
+	num_callbacks++;
+}
+
+static bool test_ctimer(void)
+{
+	TC_PRINT("Testing ctimer callbacks\n");
+
+	/* set the last one first, the third one is stopped */
+	ctimer_set(NULL, &ct[2], TEST_TICKS, ctimer_callback, &ct[2]);
+	ctimer_set(NULL, &ct[1], 2 * TEST_TICKS, ctimer_callback, &ct[1]);
+	ctimer_set(NULL, &ct[0], TEST_TICKS, ctimer_callback, &ct[0]);
+	ctimer_stop(&ct[2]);
+
+	fiber_sleep(3 * TEST_TICKS);
+
+	if (num_callbacks != 2) {
+		TC_ERROR("%d callbacks called\n", num_callbacks);
+		return false;
+	}
+
+	if (callbacks[0] != &ct[0] || callbacks[1] != &ct[1]) {
+		TC_ERROR("callbacks of the wrong timers called\n");
+		return false;
+	}
+
+	return true;
+}
+
+static void test_fiber(int arg1, int arg2)
+{
+	ARG_UNUSED(arg1);
+	ARG_UNUSED(arg2);
+
+	process_start(&test_process, NULL, NULL);
+
+	if (test_set() && test_stop() && test_restart() &&
+	    test_stop_expired() && test_set_expired() && test_ctimer()) {
+		test_result = TC_PASS;
+	} else {
+		test_result = TC_FAIL;
+	}
+
+	nano_fiber_sem_give(&test_done);
+}
+
+void main(void)
+{
+	TC_START("Test uIP event timers");
+
+	nano_sem_init(&test_done);
+	test_result = TC_FAIL;
+
+	task_fiber_start(fiber_stack, FIBER_STACKSIZE, test_fiber, 0, 0,
+			 FIBER_PRIORITY, 0);
+	nano_task_sem_take(&test_done, TICKS_UNLIMITED);
+
+	TC_END_RESULT(test_result);
+	TC_END_REPORT(test_result);
+}
@@ -0,0 +1,314 @@
+/* main.c - IPv6 route trie test */
+
+/*
+ * Copyright (c) 2016 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * DESCRIPTION
+ * This test adds and removes random routes of mixed prefix lengths, and
+ * checks every route lookup, done in the prefix trie, against a linear
+ * longest prefix search over the routes of the table. Prefixes are mostly
+ * derived from the routes already in the table, so that they nest and
+ * diverge at any bit. More routes are added than removed, so that the
+ * table also fills up and drops its oldest routes. The table is emptied
+ * at the end, one route at a time.
+ */
+
+#include <zephyr.h>
+#include <tc_util.h>
+#include <test_rand.h>
+#include <misc/util.h>
+
+#include <net/net_core.h>
+
+#include "contiki/ip/uip.h"
+#include "contiki/ipv6/uip-ds6.h"
+
+#define MAX_ROUTES CONFIG_NETWORKING_MAX_ROUTES
+
+#define NUM_NEIGHBORS 4
+
+/* number of routes added or removed */
+#define NUM_STEPS 2000
+
+/* number of lookups checked after each step */
+#define NUM_LOOKUPS 8
+
+/* lengths around the byte boundaries, other lengths are random */
+static const uint8_t edge_lengths[] = {
+	0, 1, 7, 8, 9, 16, 31, 32, 33, 63, 64, 65, 96, 127, 128,
+};
+
+/* few byte values, so that random addresses share some leading bits */
+static const uint8_t addr_bytes[] = { 0x00, 0x20, 0x21, 0xff };
+
+static uip_ipaddr_t nexthops[NUM_NEIGHBORS];
+
+static uint32_t seed = TEST_RAND_SEED;
+
+static int add_neighbors(void)
+{
+	uip_lladdr_t lladdr;
+	int i;
+
+	for (i = 0; i < NUM_NEIGHBORS; i++) {
+		uip_ip6addr(&nexthops[i], 0xfe80, 0, 0, 0, 0x0200, 0, 0, i + 1);
+
+		memset(&lladdr, 0, sizeof(lladdr));
+		lladdr.addr[sizeof(lladdr) - 1] = i + 1;
+
+		if (!uip_ds6_nbr_add(&nexthops[i], &lladdr, 1,
+				     NBR_REACHABLE)) {
+			TC_ERROR("Cannot add neighbor %d\n", i);
+			return -1;
+		}
+	}
+
+	return 0;
+}
+
+static bool prefix_match(const uip_ipaddr_t *addr, const uip_ipaddr_t *prefix,
+			 uint8_t length)
+{
+	int bytes = length / 8;
+	uint8_t mask = 0xff << (8 - length % 8);
+
+	if (memcmp(addr, prefix, bytes) != 0) {
+		return false;
+	}
+
+	return length % 8 == 0 ||
+	       ((addr->u8[bytes] ^ prefix->u8[bytes]) & mask) == 0;
+}
+
+/* Replaces the bits of addr from the given one on with random ones */
+static void randomize_from(uip_ipaddr_t *addr, int bit)
+{
+	uint8_t mask;
+
+	for (; bit < 128; bit++) {
+		mask = 0x80 >> (bit % 8);
+		if (test_rand_r(&seed) & 1) {
+			addr->u8[bit / 8] |= mask;
+		} else {
+			addr->u8[bit / 8] &= ~mask;
+		}
+	}
+}
+
+static uip_ds6_route_t *random_route(void)
+{
+	uip_ds6_route_t *r = uip_ds6_route_head();
+	int i;
+
+	for (i = test_rand_r(&seed) % uip_ds6_route_num_routes(); i > 0; i--) {
+		r = uip_ds6_route_next(r);
+	}
+
+	return r;
+}
+
+/* An address within a route of the table half of the time */
+static void random_addr(uip_ipaddr_t *addr)
+{
+	uip_ds6_route_t *r;
+	int i;
+
+	if (uip_ds6_route_num_routes() > 0 && (test_rand_r(&seed) & 1)) {
+		r = random_route();
+		uip_ipaddr_copy(addr, &r->ipaddr);
+		randomize_from(addr, test_rand_r(&seed) % 129);
+		return;
+	}
+
+	for (i = 0; i < sizeof(addr->u8); i++) {
+		addr->u8[i] = addr_bytes[test_rand_r(&seed) %
+					 ARRAY_SIZE(addr_bytes)];
+	}
+}
+
+static uint8_t random_length(void)
+{
+	if (test_rand_r(&seed) & 1) {
+		return test_rand_r(&seed) % 129;
+	}
+
+	return edge_lengths[test_rand_r(&seed) % ARRAY_SIZE(edge_lengths)];
+}
+
+static uip_ds6_route_t *linear_lookup(const uip_ipaddr_t *addr)
+{
+	uip_ds6_route_t *r, *found = NULL;
+
+	for (r = uip_ds6_route_head(); r != NULL; r = uip_ds6_route_next(r)) {
+		if (prefix_match(addr, &r->ipaddr, r->length) &&
+		    (found == NULL || r->length > found->length)) {
+			found = r;
+		}
+	}
+
+	return found;
+}
+
+static bool in_table(uip_ds6_route_t *route)
+{
+	uip_ds6_route_t *r;
+
+	for (r = uip_ds6_route_head(); r != NULL; r = uip_ds6_route_next(r)) {
+		if (r == route) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/**
+ *
+ * @brief Check the lookup of an address against a linear search
+ *
+ * Several routes of the table may have the longest matching prefix, so
+ * the prefix of the route found is compared instead of the route itself.
+ *
+ * @param addr Address to look up
+ *
+ * @return true if the route found is the right one
+ */
+static bool lookup_ok(uip_ipaddr_t *addr)
+{
+	uip_ds6_route_t *expected = linear_lookup(addr);
+	uip_ds6_route_t *found = uip_ds6_route_lookup(addr);
+
+	if (expected == NULL) {
+		if (found != NULL) {
+			TC_ERROR("Route /%d found, expected none\n",
+				 found->length);
+			return false;
+		}
+		return true;
+	}
+
+	if (found == NULL) {
+		TC_ERROR("No route found, expected /%d\n", expected->length);
+		return false;
+	}
+
+	if (!in_table(found)) {
+		TC_ERROR("Route found not in the table\n");
+		return false;
+	}
+
+	if (found->length != expected->length ||
+	    !prefix_match(addr, &found->ipaddr, found->length)) {
+		TC_ERROR("Route /%d found, expected /%d\n",
+			 found->length, expected->length);
+		return false;
+	}
+
+	return true;
+}
+
+static bool table_ok(int step)
+{
+	uip_ds6_route_t *r;
+	uip_ipaddr_t addr;
+	int num = 0;
+	int i;
+
+	for (r = uip_ds6_route_head(); r != NULL; r = uip_ds6_route_next(r)) {
+		num++;
+	}
+
+	if (num != uip_ds6_route_num_routes() || num > MAX_ROUTES) {
+		TC_ERROR("Step %d: %d routes in the table, %d counted\n",
+			 step, num, uip_ds6_route_num_routes());
+		return false;
+	}
+
+	for (i = 0; i < NUM_LOOKUPS; i++) {
+		random_addr(&addr);
+		if (!lookup_ok(&addr)) {
+			TC_ERROR("Step %d: lookup %d with %d routes\n",
+				 step, i, num);
+			return false;
+		}
+	}
+
+	return true;
+}
+
+static bool add_route(int step)
+{
+	uip_ipaddr_t addr;
+	uint8_t length = random_length();
+
+	random_addr(&addr);
+
+	if (!uip_ds6_route_add(&addr, length,
+			       &nexthops[test_rand_r(&seed) % NUM_NEIGHBORS])) {
+		TC_ERROR("Step %d: cannot add route /%d\n", step, length);
+		return false;
+	}
+
+	return true;
+}
+
+static bool test_routes(void)
+{
+	int step;
+
+	TC_PRINT("Adding and removing %d routes\n", NUM_STEPS);
+
+	for (step = 0; step < NUM_STEPS; step++) {
+		if (uip_ds6_route_num_routes() > 0 &&
+		    test_rand_r(&seed) % 3 == 0) {
+			uip_ds6_route_rm(random_route());
+		} else if (!add_route(step)) {
+			return false;
+		}
+
+		if (!table_ok(step)) {
+			return false;
+		}
+	}
+
+	TC_PRINT("Removing the %d routes left\n", uip_ds6_route_num_routes());
+
+	while (uip_ds6_route_num_routes() > 0) {
+		uip_ds6_route_rm(random_route());
+		if (!table_ok(step++)) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void main(void)
+{
+	int rv = TC_PASS;
+
+	net_init();
+
+	TC_START("Test IPv6 route trie");
+
+	if (add_neighbors() != 0 || !test_routes()) {
+		rv = TC_FAIL;
+	}
+
+	TC_END_RESULT(rv);
+	TC_END_REPORT(rv);
+}